@@ -19,6 +19,7 @@
 
 const int PARCEL_DEFAULT_INCREASE_STEP = 16;
 const uint32_t PARCEL_UINT_MAX = 0xffffffffU;
+const uint32_t PARCEL_GROWTH_DIVISOR = 2;
 
 HcParcel CreateParcel(uint32_t size, uint32_t allocUnit)
 {
@@ -290,11 +291,85 @@ static uint32_t GetParcelIncreaseSize(HcParcel *parcel, uint32_t newSize)
     if (parcel == NULL || parcel->allocUnit == 0) {
         return 0;
     }
+    uint32_t alignedSize;
     if (newSize % parcel->allocUnit) {
-        return (newSize / parcel->allocUnit + 1) * parcel->allocUnit;
+        alignedSize = (newSize / parcel->allocUnit + 1) * parcel->allocUnit;
     } else {
-        return (newSize / parcel->allocUnit) * parcel->allocUnit;
+        alignedSize = (newSize / parcel->allocUnit) * parcel->allocUnit;
     }
+    /* Grow by half of the current length at least, so that appending n blocks only costs O(n) copies. */
+    uint32_t geometricSize = parcel->length + parcel->length / PARCEL_GROWTH_DIVISOR;
+    if (geometricSize <= alignedSize) {
+        return alignedSize;
+    }
+    if (geometricSize > CLIB_MAX_MALLOC_SIZE) {
+        return (alignedSize > CLIB_MAX_MALLOC_SIZE) ? alignedSize : CLIB_MAX_MALLOC_SIZE;
+    }
+    return geometricSize;
+}
+
+static void ParcelCompact(HcParcel *parcel)
+{
+    uint32_t contentSize = GetParcelDataSize(parcel);
+    if (parcel->beginPos == 0) {
+        return;
+    }
+    if (contentSize > 0) {
+        if (memmove_s(parcel->data, parcel->length, parcel->data + parcel->beginPos, contentSize) != EOK) {
+            return;
+        }
+    }
+    parcel->beginPos = 0;
+    parcel->endPos = contentSize;
+}
+
+HcBool ParcelReserve(HcParcel *parcel, uint32_t size)
+{
+    if (parcel == NULL) {
+        return HC_FALSE;
+    }
+    if (parcel->length - parcel->beginPos >= size) {
+        return HC_TRUE;
+    }
+    if (parcel->data != NULL) {
+        ParcelCompact(parcel);
+        if (parcel->length >= size) {
+            return HC_TRUE;
+        }
+    }
+    return ParcelIncrease(parcel, size);
+}
+
+HcBool ParcelShrinkToFit(HcParcel *parcel)
+{
+    if (parcel == NULL) {
+        return HC_FALSE;
+    }
+    if (parcel->data == NULL) {
+        return HC_TRUE;
+    }
+    uint32_t contentSize = GetParcelDataSize(parcel);
+    if (contentSize == 0) {
+        DeleteParcel(parcel);
+        return HC_TRUE;
+    }
+    if (contentSize == parcel->length) {
+        return HC_TRUE;
+    }
+    char *newData = (char *)ClibMalloc(contentSize, 0);
+    if (newData == NULL) {
+        return HC_FALSE;
+    }
+    if (memcpy_s(newData, contentSize, parcel->data + parcel->beginPos, contentSize) != EOK) {
+        ClibFree(newData);
+        return HC_FALSE;
+    }
+    ClibFree(parcel->data);
+    parcel->data = newData;
+    parcel->length = contentSize;
+    parcel->beginPos = 0;
+    parcel->endPos = contentSize;
+    return HC_TRUE;
 }
 
 HcBool ParcelWrite(HcParcel *parcel, const void *src, uint32_t dataSize)
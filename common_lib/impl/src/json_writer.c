@@ -0,0 +1,258 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "json_writer.h"
+#include <string.h>
+#include "cJSON.h"
+#include "securec.h"
+#include "clib_error.h"
+
+#define JSON_CONTROL_CHAR_BOUND 0x20
+#define JSON_UNICODE_ESCAPE_LEN 6
+#define JSON_INT_MAX_LEN 12
+
+static void WriteRaw(JsonWriter *writer, const char *src, uint32_t srcLen)
+{
+    if (!writer->isValid) {
+        return;
+    }
+    if (writer->length > UINT32_MAX - srcLen) {
+        writer->isValid = false;
+        return;
+    }
+    if (writer->data != NULL) {
+        if ((writer->length + srcLen > writer->capacity) ||
+            (memcpy_s(writer->data + writer->length, writer->capacity - writer->length, src, srcLen) != EOK)) {
+            writer->isValid = false;
+            return;
+        }
+    }
+    writer->length += srcLen;
+}
+
+static void WriteChar(JsonWriter *writer, char c)
+{
+    WriteRaw(writer, &c, sizeof(char));
+}
+
+static void WriteEscapedString(JsonWriter *writer, const char *str)
+{
+    /* Keep the same escaping rules as cJSON_PrintUnformatted, so the result can be parsed by any peer. */
+    WriteChar(writer, '\"');
+    const unsigned char *p = (const unsigned char *)str;
+    const unsigned char *runStart = p;
+    for (; *p != '\0'; p++) {
+        if ((*p >= JSON_CONTROL_CHAR_BOUND) && (*p != '\"') && (*p != '\\')) {
+            continue;
+        }
+        WriteRaw(writer, (const char *)runStart, (uint32_t)(p - runStart));
+        runStart = p + 1;
+        WriteChar(writer, '\\');
+        switch (*p) {
+            case '\\':
+                WriteChar(writer, '\\');
+                break;
+            case '\"':
+                WriteChar(writer, '\"');
+                break;
+            case '\b':
+                WriteChar(writer, 'b');
+                break;
+            case '\f':
+                WriteChar(writer, 'f');
+                break;
+            case '\n':
+                WriteChar(writer, 'n');
+                break;
+            case '\r':
+                WriteChar(writer, 'r');
+                break;
+            case '\t':
+                WriteChar(writer, 't');
+                break;
+            default: {
+                char unicode[JSON_UNICODE_ESCAPE_LEN] = { 0 };
+                if (sprintf_s(unicode, sizeof(unicode), "u%04x", *p) <= 0) {
+                    writer->isValid = false;
+                    return;
+                }
+                WriteRaw(writer, unicode, JSON_UNICODE_ESCAPE_LEN - 1);
+                break;
+            }
+        }
+    }
+    WriteRaw(writer, (const char *)runStart, (uint32_t)(p - runStart));
+    WriteChar(writer, '\"');
+}
+
+static int32_t WriteSeparatorAndKey(JsonWriter *writer, const char *key)
+{
+    if (!writer->isValid) {
+        return CLIB_FAILED;
+    }
+    if (writer->depth > 0) {
+        uint32_t levelMask = 1U << (writer->depth - 1);
+        if ((writer->hasItemMask & levelMask) != 0) {
+            WriteChar(writer, ',');
+        }
+        writer->hasItemMask |= levelMask;
+    }
+    if (key != NULL) {
+        WriteEscapedString(writer, key);
+        WriteChar(writer, ':');
+    }
+    return writer->isValid ? CLIB_SUCCESS : CLIB_ERR_INVALID_LEN;
+}
+
+static int32_t StartContainer(JsonWriter *writer, const char *key, char open)
+{
+    if (writer == NULL) {
+        return CLIB_ERR_NULL_PTR;
+    }
+    if (writer->depth >= JSON_WRITER_MAX_DEPTH) {
+        writer->isValid = false;
+        return CLIB_ERR_INVALID_PARAM;
+    }
+    int32_t res = WriteSeparatorAndKey(writer, key);
+    if (res != CLIB_SUCCESS) {
+        return res;
+    }
+    WriteChar(writer, open);
+    writer->depth++;
+    writer->hasItemMask &= ~(1U << (writer->depth - 1));
+    return writer->isValid ? CLIB_SUCCESS : CLIB_ERR_INVALID_LEN;
+}
+
+static int32_t EndContainer(JsonWriter *writer, char close)
+{
+    if (writer == NULL) {
+        return CLIB_ERR_NULL_PTR;
+    }
+    if (writer->depth == 0) {
+        writer->isValid = false;
+        return CLIB_ERR_INVALID_PARAM;
+    }
+    WriteChar(writer, close);
+    writer->depth--;
+    return writer->isValid ? CLIB_SUCCESS : CLIB_ERR_INVALID_LEN;
+}
+
+void InitJsonWriter(JsonWriter *writer, char *buffer, uint32_t capacity)
+{
+    if (writer == NULL) {
+        return;
+    }
+    writer->data = buffer;
+    writer->capacity = (buffer == NULL) ? 0 : capacity;
+    writer->length = 0;
+    writer->depth = 0;
+    writer->hasItemMask = 0;
+    writer->isValid = true;
+}
+
+int32_t JsonWriterStartObject(JsonWriter *writer, const char *key)
+{
+    return StartContainer(writer, key, '{');
+}
+
+int32_t JsonWriterEndObject(JsonWriter *writer)
+{
+    return EndContainer(writer, '}');
+}
+
+int32_t JsonWriterStartArray(JsonWriter *writer, const char *key)
+{
+    return StartContainer(writer, key, '[');
+}
+
+int32_t JsonWriterEndArray(JsonWriter *writer)
+{
+    return EndContainer(writer, ']');
+}
+
+int32_t JsonWriterAddString(JsonWriter *writer, const char *key, const char *value)
+{
+    if ((writer == NULL) || (value == NULL)) {
+        return CLIB_ERR_NULL_PTR;
+    }
+    int32_t res = WriteSeparatorAndKey(writer, key);
+    if (res != CLIB_SUCCESS) {
+        return res;
+    }
+    WriteEscapedString(writer, value);
+    return writer->isValid ? CLIB_SUCCESS : CLIB_ERR_INVALID_LEN;
+}
+
+int32_t JsonWriterAddInt(JsonWriter *writer, const char *key, int32_t value)
+{
+    if (writer == NULL) {
+        return CLIB_ERR_NULL_PTR;
+    }
+    int32_t res = WriteSeparatorAndKey(writer, key);
+    if (res != CLIB_SUCCESS) {
+        return res;
+    }
+    char number[JSON_INT_MAX_LEN] = { 0 };
+    int32_t numberLen = sprintf_s(number, sizeof(number), "%d", value);
+    if (numberLen <= 0) {
+        writer->isValid = false;
+        return CLIB_FAILED;
+    }
+    WriteRaw(writer, number, (uint32_t)numberLen);
+    return writer->isValid ? CLIB_SUCCESS : CLIB_ERR_INVALID_LEN;
+}
+
+char *WriteJsonToString(JsonWriteFunc writeFunc, const void *ctx)
+{
+    if (writeFunc == NULL) {
+        return NULL;
+    }
+    JsonWriter writer;
+    InitJsonWriter(&writer, NULL, 0);
+    if ((writeFunc(&writer, ctx) != CLIB_SUCCESS) || !writer.isValid || (writer.depth != 0) ||
+        (writer.length == UINT32_MAX)) {
+        return NULL;
+    }
+    uint32_t strLen = writer.length;
+    /* Allocated by cJSON, so that the result can be released by FreeJsonString like a packed json. */
+    char *str = (char *)cJSON_malloc(strLen + 1);
+    if (str == NULL) {
+        return NULL;
+    }
+    InitJsonWriter(&writer, str, strLen + 1);
+    if ((writeFunc(&writer, ctx) != CLIB_SUCCESS) || !writer.isValid || (writer.length != strLen)) {
+        cJSON_free(str);
+        return NULL;
+    }
+    str[strLen] = '\0';
+    return str;
+}
+
+char *CopyJsonString(const char *jsonStr)
+{
+    if (jsonStr == NULL) {
+        return NULL;
+    }
+    uint32_t strLen = (uint32_t)strlen(jsonStr);
+    char *str = (char *)cJSON_malloc(strLen + 1);
+    if (str == NULL) {
+        return NULL;
+    }
+    if (memcpy_s(str, strLen + 1, jsonStr, strLen + 1) != EOK) {
+        cJSON_free(str);
+        return NULL;
+    }
+    return str;
+}
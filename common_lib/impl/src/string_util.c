@@ -21,11 +21,24 @@
 #include "securec.h"
 #include "clib_error.h"
 #include "clib_types.h"
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define HEX_SIMD_ENABLE
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define HEX_SIMD_ENABLE
+#endif
 
 #define OUT_OF_HEX 16
 #define NUMBER_9_IN_DECIMAL 9
 #define ASCII_CASE_DIFFERENCE_VALUE 32
 #define DESENSITIZATION_LEN 4
+#define HEX_SIMD_BLOCK_LEN 16 /* bytes converted by one vector operation */
+#define HALF_BYTE_BITS 4
+#define LOW_NIBBLE_MASK 0x0F
+#define HEX_LETTER_OFFSET 7 /* distance between '9' + 1 and 'A' */
+#define ASCII_LOWER_CASE_BIT 0x20
+#define BYTE_BITS 8
 
 static const char * const g_base64CharacterTable =
     "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
@@ -41,11 +54,141 @@ static const uint8_t g_base64DecodeTable[] = {
     41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51
 };
 
-static char HexToChar(uint8_t hex)
+static const char g_hexCharacterTable[] = "0123456789ABCDEF";
+
+/* Indexed by the character, OUT_OF_HEX for the characters which are not hex digits. */
+static const uint8_t g_hexDecodeTable[] = {
+    OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX,
+    OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX,
+    OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX,
+    OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX,
+    OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX,
+    OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX,
+    0, 1, 2, 3, 4, 5, 6, 7,
+    8, 9, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX,
+    OUT_OF_HEX, 10, 11, 12, 13, 14, 15, OUT_OF_HEX,
+    OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX,
+    OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX,
+    OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX,
+    OUT_OF_HEX, 10, 11, 12, 13, 14, 15, OUT_OF_HEX,
+    OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX,
+    OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX,
+    OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX,
+    OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX,
+    OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX,
+    OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX,
+    OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX,
+    OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX,
+    OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX,
+    OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX,
+    OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX,
+    OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX,
+    OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX,
+    OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX,
+    OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX,
+    OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX,
+    OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX,
+    OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX,
+    OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX
+};
+
+#if defined(__SSE2__)
+/* Convert 16 nibbles to upper case hex characters: n + '0', plus 7 more for 'A' to 'F'. */
+static __m128i NibbleToHexChar(__m128i nibble)
+{
+    __m128i isLetter = _mm_cmpgt_epi8(nibble, _mm_set1_epi8(NUMBER_9_IN_DECIMAL));
+    __m128i offset = _mm_add_epi8(_mm_set1_epi8('0'), _mm_and_si128(isLetter, _mm_set1_epi8(HEX_LETTER_OFFSET)));
+    return _mm_add_epi8(nibble, offset);
+}
+
+static void ByteToHexBlock(const uint8_t *byte, char *hexStr)
+{
+    __m128i in = _mm_loadu_si128((const __m128i *)byte);
+    __m128i lowMask = _mm_set1_epi8(LOW_NIBBLE_MASK);
+    __m128i high = _mm_and_si128(_mm_srli_epi16(in, HALF_BYTE_BITS), lowMask);
+    __m128i low = _mm_and_si128(in, lowMask);
+    _mm_storeu_si128((__m128i *)hexStr, NibbleToHexChar(_mm_unpacklo_epi8(high, low)));
+    _mm_storeu_si128((__m128i *)(hexStr + HEX_SIMD_BLOCK_LEN), NibbleToHexChar(_mm_unpackhi_epi8(high, low)));
+}
+
+/* Return the nibble values of 16 hex characters, and whether all of them are valid. */
+static __m128i HexCharToNibble(__m128i c, bool *isValid)
+{
+    /* Unsigned range check: x <= bound if and only if max(x, bound) == bound. */
+    __m128i digit = _mm_sub_epi8(c, _mm_set1_epi8('0'));
+    __m128i digitBound = _mm_set1_epi8(NUMBER_9_IN_DECIMAL);
+    __m128i isDigit = _mm_cmpeq_epi8(_mm_max_epu8(digit, digitBound), digitBound);
+    __m128i letter = _mm_sub_epi8(_mm_or_si128(c, _mm_set1_epi8(ASCII_LOWER_CASE_BIT)), _mm_set1_epi8('a'));
+    __m128i letterBound = _mm_set1_epi8('f' - 'a');
+    __m128i isLetter = _mm_cmpeq_epi8(_mm_max_epu8(letter, letterBound), letterBound);
+    *isValid = (_mm_movemask_epi8(_mm_or_si128(isDigit, isLetter)) == 0xFFFF);
+    return _mm_or_si128(_mm_and_si128(isDigit, digit),
+        _mm_and_si128(isLetter, _mm_add_epi8(letter, _mm_set1_epi8(DEC))));
+}
+
+/* Combine the nibble pairs in each 16-bit lane into one byte: (even << 4) | odd. */
+static __m128i NibblePairToByte(__m128i nibble)
+{
+    __m128i even = _mm_and_si128(nibble, _mm_set1_epi16(0x00FF));
+    return _mm_or_si128(_mm_slli_epi16(even, HALF_BYTE_BITS), _mm_srli_epi16(nibble, BYTE_BITS));
+}
+
+static bool HexToByteBlock(const char *hexStr, uint8_t *byte)
+{
+    bool isFirstValid = false;
+    bool isSecondValid = false;
+    __m128i first = HexCharToNibble(_mm_loadu_si128((const __m128i *)hexStr), &isFirstValid);
+    __m128i second = HexCharToNibble(_mm_loadu_si128((const __m128i *)(hexStr + HEX_SIMD_BLOCK_LEN)),
+        &isSecondValid);
+    if (!isFirstValid || !isSecondValid) {
+        return false;
+    }
+    _mm_storeu_si128((__m128i *)byte, _mm_packus_epi16(NibblePairToByte(first), NibblePairToByte(second)));
+    return true;
+}
+#elif defined(HEX_SIMD_ENABLE)
+static uint8x16_t NibbleToHexChar(uint8x16_t nibble)
 {
-    return (hex > NUMBER_9_IN_DECIMAL) ? (hex + 0x37) : (hex + 0x30); /* Convert to the corresponding character */
+    uint8x16_t isLetter = vcgtq_u8(nibble, vdupq_n_u8(NUMBER_9_IN_DECIMAL));
+    uint8x16_t offset = vaddq_u8(vdupq_n_u8('0'), vandq_u8(isLetter, vdupq_n_u8(HEX_LETTER_OFFSET)));
+    return vaddq_u8(nibble, offset);
 }
 
+static void ByteToHexBlock(const uint8_t *byte, char *hexStr)
+{
+    uint8x16_t in = vld1q_u8(byte);
+    uint8x16x2_t out;
+    out.val[0] = NibbleToHexChar(vshrq_n_u8(in, HALF_BYTE_BITS));
+    out.val[1] = NibbleToHexChar(vandq_u8(in, vdupq_n_u8(LOW_NIBBLE_MASK)));
+    vst2q_u8((uint8_t *)hexStr, out);
+}
+
+static uint8x16_t HexCharToNibble(uint8x16_t c, uint8x16_t *isValid)
+{
+    uint8x16_t digit = vsubq_u8(c, vdupq_n_u8('0'));
+    uint8x16_t isDigit = vcleq_u8(digit, vdupq_n_u8(NUMBER_9_IN_DECIMAL));
+    uint8x16_t letter = vsubq_u8(vorrq_u8(c, vdupq_n_u8(ASCII_LOWER_CASE_BIT)), vdupq_n_u8('a'));
+    uint8x16_t isLetter = vcleq_u8(letter, vdupq_n_u8('f' - 'a'));
+    *isValid = vandq_u8(*isValid, vorrq_u8(isDigit, isLetter));
+    return vbslq_u8(isDigit, digit, vaddq_u8(letter, vdupq_n_u8(DEC)));
+}
+
+static bool HexToByteBlock(const char *hexStr, uint8_t *byte)
+{
+    /* vld2q splits the even (high nibble) and odd (low nibble) characters into two vectors. */
+    uint8x16x2_t in = vld2q_u8((const uint8_t *)hexStr);
+    uint8x16_t isValid = vdupq_n_u8(UINT8_MAX);
+    uint8x16_t high = HexCharToNibble(in.val[0], &isValid);
+    uint8x16_t low = HexCharToNibble(in.val[1], &isValid);
+    uint8x8_t validMask = vand_u8(vget_low_u8(isValid), vget_high_u8(isValid));
+    if (vget_lane_u64(vreinterpret_u64_u8(validMask), 0) != UINT64_MAX) {
+        return false;
+    }
+    vst1q_u8(byte, vorrq_u8(vshlq_n_u8(high, HALF_BYTE_BITS), low));
+    return true;
+}
+#endif
+
 int32_t ByteToHexString(const uint8_t *byte, uint32_t byteLen, char *hexStr, uint32_t hexLen)
 {
     if (byte == NULL || hexStr == NULL) {
@@ -56,28 +199,21 @@ int32_t ByteToHexString(const uint8_t *byte, uint32_t byteLen, char *hexStr, uin
         return CLIB_ERR_INVALID_LEN;
     }
 
-    for (uint32_t i = 0; i < byteLen; i++) {
-        hexStr[i * BYTE_TO_HEX_OPER_LENGTH] = HexToChar((byte[i] & 0xF0) >> 4); /* 4: shift right for filling */
-        hexStr[i * BYTE_TO_HEX_OPER_LENGTH + 1] = HexToChar(byte[i] & 0x0F); /* get low four bits */
+    uint32_t i = 0;
+#ifdef HEX_SIMD_ENABLE
+    for (; i + HEX_SIMD_BLOCK_LEN <= byteLen; i += HEX_SIMD_BLOCK_LEN) {
+        ByteToHexBlock(byte + i, hexStr + i * BYTE_TO_HEX_OPER_LENGTH);
+    }
+#endif
+    for (; i < byteLen; i++) {
+        hexStr[i * BYTE_TO_HEX_OPER_LENGTH] = g_hexCharacterTable[byte[i] >> HALF_BYTE_BITS];
+        hexStr[i * BYTE_TO_HEX_OPER_LENGTH + 1] = g_hexCharacterTable[byte[i] & LOW_NIBBLE_MASK];
     }
     hexStr[byteLen * BYTE_TO_HEX_OPER_LENGTH] = '\0';
 
     return CLIB_SUCCESS;
 }
 
-static uint8_t CharToHex(char c)
-{
-    if ((c >= 'A') && (c <= 'F')) {
-        return (c - 'A' + DEC);
-    } else if ((c >= 'a') && (c <= 'f')) {
-        return (c - 'a' + DEC);
-    } else if ((c >= '0') && (c <= '9')) {
-        return (c - '0');
-    } else {
-        return OUT_OF_HEX;
-    }
-}
-
 int32_t HexStringToByte(const char *hexStr, uint8_t *byte, uint32_t byteLen)
 {
     if (byte == NULL || hexStr == NULL) {
@@ -89,9 +225,18 @@ int32_t HexStringToByte(const char *hexStr, uint8_t *byte, uint32_t byteLen)
         return CLIB_ERR_INVALID_LEN;
     }
 
-    for (uint32_t i = 0; i < realHexLen / BYTE_TO_HEX_OPER_LENGTH; i++) {
-        uint8_t high = CharToHex(hexStr[i * BYTE_TO_HEX_OPER_LENGTH]);
-        uint8_t low = CharToHex(hexStr[i * BYTE_TO_HEX_OPER_LENGTH + 1]);
+    uint32_t i = 0;
+#ifdef HEX_SIMD_ENABLE
+    /* An invalid block is left to the scalar loop, so that the same bytes are written before the error. */
+    for (; i + HEX_SIMD_BLOCK_LEN <= realHexLen / BYTE_TO_HEX_OPER_LENGTH; i += HEX_SIMD_BLOCK_LEN) {
+        if (!HexToByteBlock(hexStr + i * BYTE_TO_HEX_OPER_LENGTH, byte + i)) {
+            break;
+        }
+    }
+#endif
+    for (; i < realHexLen / BYTE_TO_HEX_OPER_LENGTH; i++) {
+        uint8_t high = g_hexDecodeTable[(uint8_t)hexStr[i * BYTE_TO_HEX_OPER_LENGTH]];
+        uint8_t low = g_hexDecodeTable[(uint8_t)hexStr[i * BYTE_TO_HEX_OPER_LENGTH + 1]];
         if (high == OUT_OF_HEX || low == OUT_OF_HEX) {
             return CLIB_ERR_INVALID_PARAM;
         }
@@ -0,0 +1,178 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HC_DEQUE_H
+#define HC_DEQUE_H
+
+#include "clib_types.h"
+#include "securec.h"
+
+/*
+ * A double-ended queue on a circular buffer. Pushing and popping at both ends cost O(1),
+ * the buffer doubles when it is full. Use it instead of HC_VECTOR for FIFO queues.
+ * Use DECLARE_HC_DEQUE to declare the deque in the head/src file.
+ * @para ClassName: the name of the deque-class/deque-struct
+ * @para Element: the type of the deque element
+ * @for example:
+ * DECLARE_HC_DEQUE(IntDeque, int)
+ */
+#define DECLARE_HC_DEQUE(ClassName, Element) \
+typedef struct D##ClassName { \
+    Element* (*pushBack)(struct D##ClassName*, const Element*); \
+    Element* (*pushFront)(struct D##ClassName*, const Element*); \
+    HcBool (*popFront)(struct D##ClassName*, Element*); \
+    HcBool (*popBack)(struct D##ClassName*, Element*); \
+    uint32_t (*size)(const struct D##ClassName*); \
+    Element* (*getp)(const struct D##ClassName*, uint32_t index); \
+    void (*clear)(struct D##ClassName*); \
+    Element *data; \
+    uint32_t capacity; \
+    uint32_t head; \
+    uint32_t count; \
+} ClassName;
+
+/*
+ * Use IMPLEMENT_HC_DEQUE to implement the deque in the source file.
+ * @para ClassName: the name of the deque-class/deque-struct
+ * @para Element: the type of the deque element
+ * @para allocCount: the capacity of the first allocation
+ * @for example:
+ * IMPLEMENT_HC_DEQUE(IntDeque, int, 8)
+ */
+#define IMPLEMENT_HC_DEQUE(ClassName, Element, allocCount) \
+static HcBool DGrow##ClassName(ClassName* obj) \
+{ \
+    uint32_t newCapacity = (obj->capacity == 0) ? (allocCount) : obj->capacity * 2; \
+    if (newCapacity <= obj->capacity || newCapacity > UINT32_MAX / sizeof(Element)) { \
+        return HC_FALSE; \
+    } \
+    Element *newData = (Element *)ClibMalloc(newCapacity * sizeof(Element), 0); \
+    if (newData == NULL) { \
+        return HC_FALSE; \
+    } \
+    for (uint32_t i = 0; i < obj->count; ++i) { \
+        newData[i] = obj->data[(obj->head + i) % obj->capacity]; \
+    } \
+    ClibFree(obj->data); \
+    obj->data = newData; \
+    obj->capacity = newCapacity; \
+    obj->head = 0; \
+    return HC_TRUE; \
+} \
+Element* DPushBack##ClassName(ClassName* obj, const Element *e) \
+{ \
+    if (obj == NULL || e == NULL) { \
+        return NULL; \
+    } \
+    if (obj->count == obj->capacity && !DGrow##ClassName(obj)) { \
+        return NULL; \
+    } \
+    Element *slot = &obj->data[(obj->head + obj->count) % obj->capacity]; \
+    *slot = *e; \
+    obj->count++; \
+    return slot; \
+} \
+Element* DPushFront##ClassName(ClassName* obj, const Element *e) \
+{ \
+    if (obj == NULL || e == NULL) { \
+        return NULL; \
+    } \
+    if (obj->count == obj->capacity && !DGrow##ClassName(obj)) { \
+        return NULL; \
+    } \
+    obj->head = (obj->head + obj->capacity - 1) % obj->capacity; \
+    obj->data[obj->head] = *e; \
+    obj->count++; \
+    return &obj->data[obj->head]; \
+} \
+HcBool DPopFront##ClassName(ClassName* obj, Element* e) \
+{ \
+    if (obj == NULL || e == NULL || obj->count == 0) { \
+        return HC_FALSE; \
+    } \
+    *e = obj->data[obj->head]; \
+    obj->head = (obj->head + 1) % obj->capacity; \
+    obj->count--; \
+    return HC_TRUE; \
+} \
+HcBool DPopBack##ClassName(ClassName* obj, Element* e) \
+{ \
+    if (obj == NULL || e == NULL || obj->count == 0) { \
+        return HC_FALSE; \
+    } \
+    *e = obj->data[(obj->head + obj->count - 1) % obj->capacity]; \
+    obj->count--; \
+    return HC_TRUE; \
+} \
+uint32_t DSize##ClassName(const ClassName* obj) \
+{ \
+    return (obj == NULL) ? 0 : obj->count; \
+} \
+Element* DGetPointer##ClassName(const ClassName* obj, uint32_t index) \
+{ \
+    if (obj == NULL || index >= obj->count) { \
+        return NULL; \
+    } \
+    return &obj->data[(obj->head + index) % obj->capacity]; \
+} \
+void DClear##ClassName(ClassName* obj) \
+{ \
+    if (obj != NULL) { \
+        obj->head = 0; \
+        obj->count = 0; \
+    } \
+} \
+ClassName Create##ClassName(void) \
+{ \
+    ClassName obj; \
+    obj.pushBack = DPushBack##ClassName; \
+    obj.pushFront = DPushFront##ClassName; \
+    obj.popFront = DPopFront##ClassName; \
+    obj.popBack = DPopBack##ClassName; \
+    obj.size = DSize##ClassName; \
+    obj.getp = DGetPointer##ClassName; \
+    obj.clear = DClear##ClassName; \
+    obj.data = NULL; \
+    obj.capacity = 0; \
+    obj.head = 0; \
+    obj.count = 0; \
+    return obj; \
+} \
+void Destroy##ClassName(ClassName* obj) \
+{ \
+    if (obj != NULL) { \
+        ClibFree(obj->data); \
+        obj->data = NULL; \
+        obj->capacity = 0; \
+        obj->head = 0; \
+        obj->count = 0; \
+    } \
+}
+
+/* Use these two macros to create and destroy deque */
+#define CREATE_HC_DEQUE(classname) Create##classname()
+#define DESTROY_HC_DEQUE(classname, obj) Destroy##classname(obj)
+
+#define FOR_EACH_HC_DEQUE(deque, index, iter) for (index = 0; index < (deque).size(&(deque)) && \
+    (iter = (deque).getp(&(deque), index)); ++index)
+
+#define HC_DEQUE_PUSHBACK(obj, element) (obj)->pushBack((obj), (element))
+#define HC_DEQUE_PUSHFRONT(obj, element) (obj)->pushFront((obj), (element))
+#define HC_DEQUE_POPFRONT(obj, element) (obj)->popFront((obj), (element))
+#define HC_DEQUE_POPBACK(obj, element) (obj)->popBack((obj), (element))
+#define HC_DEQUE_SIZE(obj) (obj)->size(obj)
+#define HC_DEQUE_GETP(obj, index) (obj)->getp((obj), (index))
+
+#endif
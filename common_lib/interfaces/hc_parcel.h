@@ -41,6 +41,10 @@ void ResetParcel(HcParcel *parcel, uint32_t size, uint32_t allocUnit);
 HcBool ParcelReadWithoutPopData(HcParcel *parcel, void *dst, uint32_t dataSize);
 HcBool ParcelRead(HcParcel *parcel, void *dst, uint32_t dataSize);
 HcBool ParcelWrite(HcParcel *parcel, const void *src, uint32_t dataSize);
+/* Make sure that the parcel can hold size bytes of data without being reallocated. */
+HcBool ParcelReserve(HcParcel *parcel, uint32_t size);
+/* Release the capacity which is not used by the data. */
+HcBool ParcelShrinkToFit(HcParcel *parcel);
 HcBool ParcelReadRevert(HcParcel *parcel, void *dst, uint32_t dataSize);
 HcBool ParcelWriteRevert(HcParcel *parcel, const void *src, uint32_t dataSize);
 uint32_t GetParcelDataSize(const HcParcel *parcel);
@@ -224,6 +224,10 @@ int32_t ParseTlv##TlvVecName(TlvBase *tlv, HcParcel *parcel, HcBool strict) \
         return TLV_FAIL; \
     } \
     int32_t totalLen = sizeof(count); \
+    /* Every element takes at least one byte, a larger count is malformed and will fail below. */ \
+    if (count <= GetParcelDataSize(parcel)) { \
+        (void)realTlv->data.reserve(&realTlv->data, realTlv->data.size(&realTlv->data) + count); \
+    } \
     uint32_t index = 0; \
     for (index = 0; index < count; ++index) { \
         TlvElementName tlvElement; \
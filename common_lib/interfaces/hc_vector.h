@@ -32,10 +32,14 @@ typedef struct V##ClassName{ \
     Element* (*pushBackT)(struct V##ClassName*, Element); \
     HcBool (*popFront)(struct V##ClassName*, Element*); \
     HcBool (*eraseElement)(struct V##ClassName*, Element*, uint32_t index); \
+    HcBool (*swapRemove)(struct V##ClassName*, Element*, uint32_t index); \
     uint32_t (*size)(const struct V##ClassName*); \
     Element (*get)(const struct V##ClassName*, uint32_t index); \
     Element* (*getp)(const struct V##ClassName*, uint32_t index); \
     void (*clear)(struct V##ClassName*); \
+    HcBool (*reserve)(struct V##ClassName*, uint32_t count); \
+    HcBool (*shrinkToFit)(struct V##ClassName*); \
+    HcBool (*truncate)(struct V##ClassName*, uint32_t size); \
     HcParcel parcel; \
 } ClassName;
 
@@ -92,6 +96,20 @@ HcBool VErase##ClassName(ClassName* obj, Element* e, uint32_t index) { \
             return HC_FALSE; \
         } \
 } \
+HcBool VSwapRemove##ClassName(ClassName* obj, Element* e, uint32_t index) { \
+    if (NULL == obj || NULL == e || index >= obj->size(obj)) { \
+        return HC_FALSE; \
+    } \
+    Element *target = obj->getp(obj, index); \
+    Element *last = obj->getp(obj, obj->size(obj) - 1); \
+    if (memmove_s(e, sizeof(Element), target, sizeof(Element)) != EOK) { \
+        return HC_FALSE; \
+    } \
+    if (target != last && memmove_s(target, sizeof(Element), last, sizeof(Element)) != EOK) { \
+        return HC_FALSE; \
+    } \
+    return ParcelPopBack(&obj->parcel, sizeof(Element)); \
+} \
 uint32_t VSize##ClassName(const ClassName* obj) \
 { \
     if (NULL == obj) { \
@@ -134,6 +152,30 @@ void VClear##ClassName(ClassName* obj) \
         ClearParcel(&obj->parcel); \
     } \
 } \
+HcBool VReserve##ClassName(ClassName* obj, uint32_t count) \
+{ \
+    if (NULL == obj || count > UINT32_MAX / sizeof(Element)) { \
+        return HC_FALSE; \
+    } \
+    return ParcelReserve(&obj->parcel, count * sizeof(Element)); \
+} \
+HcBool VShrinkToFit##ClassName(ClassName* obj) \
+{ \
+    if (NULL == obj) { \
+        return HC_FALSE; \
+    } \
+    return ParcelShrinkToFit(&obj->parcel); \
+} \
+HcBool VTruncate##ClassName(ClassName* obj, uint32_t size) \
+{ \
+    if (NULL == obj || size > obj->size(obj)) { \
+        return HC_FALSE; \
+    } \
+    if (size == obj->size(obj)) { \
+        return HC_TRUE; \
+    } \
+    return ParcelPopBack(&obj->parcel, (obj->size(obj) - size) * sizeof(Element)); \
+} \
 ClassName Create##ClassName(void) \
 { \
     ClassName obj; \
@@ -142,9 +184,13 @@ ClassName Create##ClassName(void) \
     obj.popFront = VPopFront##ClassName; \
     obj.clear = VClear##ClassName; \
     obj.eraseElement = VErase##ClassName; \
+    obj.swapRemove = VSwapRemove##ClassName; \
     obj.size = VSize##ClassName; \
     obj.get = VGet##ClassName; \
     obj.getp = VGetPointer##ClassName; \
+    obj.reserve = VReserve##ClassName; \
+    obj.shrinkToFit = VShrinkToFit##ClassName; \
+    obj.truncate = VTruncate##ClassName; \
     obj.parcel = CreateParcel(0, sizeof(Element) * allocCount); \
     return obj; \
 } \
@@ -165,8 +211,14 @@ void Destroy##ClassName(ClassName* obj) \
 #define HC_VECTOR_PUSHBACK(obj, element) (obj)->pushBack((obj), (element))
 #define HC_VECTOR_POPFRONT(obj, element) (obj)->popFront((obj), (element))
 #define HC_VECTOR_POPELEMENT(obj, element, index) (obj)->eraseElement((obj), (element), (index))
+/* Remove in O(1) by moving the last element into the hole, the order of the elements is not kept. */
+#define HC_VECTOR_SWAP_REMOVE(obj, element, index) (obj)->swapRemove((obj), (element), (index))
 #define HC_VECTOR_SIZE(obj) (obj)->size(obj)
 #define HC_VECTOR_GET(obj, index) (obj)->get((obj), (index))
 #define HC_VECTOR_GETP(_obj, _index) (_obj)->getp((_obj), (_index))
+#define HC_VECTOR_RESERVE(obj, count) (obj)->reserve((obj), (count))
+#define HC_VECTOR_SHRINK_TO_FIT(obj) (obj)->shrinkToFit(obj)
+/* Drop the elements from index size on, the last step of compacting a vector in place. */
+#define HC_VECTOR_TRUNCATE(obj, size) (obj)->truncate((obj), (size))
 
 #endif
@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef JSON_WRITER_H
+#define JSON_WRITER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define JSON_WRITER_MAX_DEPTH 8
+
+/*
+ * Streaming json writer. It serializes values straight into a caller buffer without building a json tree.
+ * The output is byte-identical to PackJsonToString() for the same objects, including string escaping.
+ * If the buffer is NULL, the writer only counts the bytes needed, so the same write routine can be used
+ * to size the buffer first and fill it afterwards.
+ */
+typedef struct {
+    char *data;
+    uint32_t capacity;
+    uint32_t length;
+    uint32_t depth;
+    uint32_t hasItemMask;
+    bool isValid;
+} JsonWriter;
+
+/* Returns CLIB_SUCCESS or a CLIB_* error, like the JsonWriter calls it is built from. */
+typedef int32_t (*JsonWriteFunc)(JsonWriter *writer, const void *ctx);
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void InitJsonWriter(JsonWriter *writer, char *buffer, uint32_t capacity);
+
+/* The key must be NULL for the root value and for array elements. */
+int32_t JsonWriterStartObject(JsonWriter *writer, const char *key);
+int32_t JsonWriterEndObject(JsonWriter *writer);
+int32_t JsonWriterStartArray(JsonWriter *writer, const char *key);
+int32_t JsonWriterEndArray(JsonWriter *writer);
+int32_t JsonWriterAddString(JsonWriter *writer, const char *key, const char *value);
+int32_t JsonWriterAddInt(JsonWriter *writer, const char *key, int32_t value);
+
+/*
+ * Run writeFunc twice: once to measure and once to fill an exactly sized buffer.
+ * Need to call FreeJsonString to free the returned pointer when it's no longer in use.
+ */
+char *WriteJsonToString(JsonWriteFunc writeFunc, const void *ctx);
+/* Need to call FreeJsonString to free the returned pointer when it's no longer in use. */
+char *CopyJsonString(const char *jsonStr);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
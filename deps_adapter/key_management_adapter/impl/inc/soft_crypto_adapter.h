@@ -0,0 +1,34 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SOFT_CRYPTO_ADAPTER_H
+#define SOFT_CRYPTO_ADAPTER_H
+
+#include "alg_defs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * The returned loader computes sha256, random, hmac, hkdf and aes-gcm with openssl when the key is a plain
+ * buffer (isAlias is false). Operations on keys stored in huks, and all the other operations, use the huks loader.
+ */
+const AlgLoader *GetSoftCryptoLoaderInstance(void);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
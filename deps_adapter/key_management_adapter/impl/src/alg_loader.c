@@ -15,8 +15,15 @@
 
 #include "alg_loader.h"
 #include "huks_adapter.h"
+#ifdef DEV_AUTH_SOFT_CRYPTO
+#include "soft_crypto_adapter.h"
+#endif
 
 const AlgLoader *GetLoaderInstance()
 {
+#ifdef DEV_AUTH_SOFT_CRYPTO
+    return GetSoftCryptoLoaderInstance();
+#else
     return GetRealLoaderInstance();
+#endif
 }
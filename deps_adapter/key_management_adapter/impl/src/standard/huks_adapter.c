@@ -14,6 +14,7 @@
  */
 
 #include "huks_adapter.h"
+#include <pthread.h>
 #include "crypto_hash_to_point.h"
 #include "hc_log.h"
 #include "hks_api.h"
@@ -25,6 +26,9 @@
 #define BASE_IMPORT_PARAMS_LEN 7
 #define EXT_IMPORT_PARAMS_LEN 2
 #define ECDH_COMMON_SIZE_P256 512
+#define HMAC_PARAM_NUM 3
+#define KEY_PRESENCE_CACHE_SIZE 32
+#define KEY_PRESENCE_ALIAS_MAX_LEN 64
 
 static enum HksKeyPurpose g_purposeToHksKeyPurpose[] = {
     HKS_KEY_PURPOSE_MAC,
@@ -77,9 +81,80 @@ static int32_t ConstructParamSet(struct HksParamSet **out, const struct HksParam
     return HAL_SUCCESS;
 }
 
+static const struct HksParam g_sha256Param[] = {
+    {
+        .tag = HKS_TAG_DIGEST,
+        .uint32Param = HKS_DIGEST_SHA256
+    }
+};
+
+static const struct HksParam g_hmacParam[][HMAC_PARAM_NUM] = {
+    {
+        {
+            .tag = HKS_TAG_PURPOSE,
+            .uint32Param = HKS_KEY_PURPOSE_MAC
+        }, {
+            .tag = HKS_TAG_DIGEST,
+            .uint32Param = HKS_DIGEST_SHA256
+        }, {
+            .tag = HKS_TAG_IS_KEY_ALIAS,
+            .boolParam = false
+        }
+    }, {
+        {
+            .tag = HKS_TAG_PURPOSE,
+            .uint32Param = HKS_KEY_PURPOSE_MAC
+        }, {
+            .tag = HKS_TAG_DIGEST,
+            .uint32Param = HKS_DIGEST_SHA256
+        }, {
+            .tag = HKS_TAG_IS_KEY_ALIAS,
+            .boolParam = true
+        }
+    }
+};
+
+/* Param sets which do not depend on the input are built once in InitHks and only read afterwards. */
+static struct HksParamSet *g_sha256ParamSet = NULL;
+static struct HksParamSet *g_hmacParamSet[] = { NULL, NULL }; /* indexed by isAlias */
+
+static int32_t GetConstParamSet(struct HksParamSet *cached, const struct HksParam *inParam,
+    const uint32_t inParamNum, struct HksParamSet **out)
+{
+    if (cached != NULL) {
+        *out = cached;
+        return HAL_SUCCESS;
+    }
+    return ConstructParamSet(out, inParam, inParamNum);
+}
+
+static void ReleaseConstParamSet(struct HksParamSet *cached, struct HksParamSet **paramSet)
+{
+    if (*paramSet != cached) {
+        HksFreeParamSet(paramSet);
+    }
+}
+
+/* A failed build leaves the cache empty, and the param set is then built on each call instead. */
+static void BuildConstParamSets(void)
+{
+    if (g_sha256ParamSet == NULL) {
+        (void)ConstructParamSet(&g_sha256ParamSet, g_sha256Param, CAL_ARRAY_SIZE(g_sha256Param));
+    }
+    for (uint32_t i = 0; i < CAL_ARRAY_SIZE(g_hmacParamSet); i++) {
+        if (g_hmacParamSet[i] == NULL) {
+            (void)ConstructParamSet(&g_hmacParamSet[i], g_hmacParam[i], HMAC_PARAM_NUM);
+        }
+    }
+}
+
 static int32_t InitHks(void)
 {
-    return HksInitialize();
+    int32_t res = HksInitialize();
+    if (res == HKS_SUCCESS) {
+        BuildConstParamSets();
+    }
+    return res;
 }
 
 static int32_t Sha256(const Uint8Buff *message, Uint8Buff *hash)
@@ -95,25 +170,18 @@ static int32_t Sha256(const Uint8Buff *message, Uint8Buff *hash)
     struct HksBlob srcBlob = { message->length, message->val };
     struct HksBlob hashBlob = { hash->length, hash->val };
     struct HksParamSet *paramSet = NULL;
-    struct HksParam digestParam[] = {
-        {
-            .tag = HKS_TAG_DIGEST,
-            .uint32Param = HKS_DIGEST_SHA256
-        }
-    };
-    int32_t ret = ConstructParamSet(&paramSet, digestParam, CAL_ARRAY_SIZE(digestParam));
+    int32_t ret = GetConstParamSet(g_sha256ParamSet, g_sha256Param, CAL_ARRAY_SIZE(g_sha256Param), &paramSet);
     if (ret != HAL_SUCCESS) {
         LOGE("construct param set failed, ret = %d", ret);
         return ret;
     }
 
     ret = HksHash(paramSet, &srcBlob, &hashBlob);
+    ReleaseConstParamSet(g_sha256ParamSet, &paramSet);
     if (ret != HKS_SUCCESS || hashBlob.size != SHA256_LEN) {
-        HksFreeParamSet(&paramSet);
         return HAL_FAILED;
     }
 
-    HksFreeParamSet(&paramSet);
     return HAL_SUCCESS;
 }
 
@@ -133,18 +201,119 @@ static int32_t GenerateRandom(Uint8Buff *rand)
     return HAL_SUCCESS;
 }
 
+typedef struct {
+    uint32_t aliasLen; /* 0 means the slot is free */
+    uint8_t alias[KEY_PRESENCE_ALIAS_MAX_LEN];
+    uint32_t lastUsed;
+} KeyPresenceEntry;
+
+/*
+ * Aliases known to exist in huks. Keys are only created and deleted through this loader, so an alias is added
+ * after a successful generate or import and dropped on delete. Absence is never cached.
+ */
+static pthread_mutex_t g_keyPresenceMutex = PTHREAD_MUTEX_INITIALIZER;
+static KeyPresenceEntry g_keyPresence[KEY_PRESENCE_CACHE_SIZE];
+static uint32_t g_keyPresenceClock = 0;
+
+static KeyPresenceEntry *FindKeyPresence(const uint8_t *alias, uint32_t aliasLen)
+{
+    for (uint32_t i = 0; i < KEY_PRESENCE_CACHE_SIZE; i++) {
+        if ((g_keyPresence[i].aliasLen == aliasLen) && (memcmp(g_keyPresence[i].alias, alias, aliasLen) == 0)) {
+            return &g_keyPresence[i];
+        }
+    }
+    return NULL;
+}
+
+static bool IsKeyKnownPresent(const uint8_t *alias, uint32_t aliasLen)
+{
+    if (aliasLen > KEY_PRESENCE_ALIAS_MAX_LEN) {
+        return false;
+    }
+    (void)pthread_mutex_lock(&g_keyPresenceMutex);
+    KeyPresenceEntry *entry = FindKeyPresence(alias, aliasLen);
+    if (entry != NULL) {
+        entry->lastUsed = ++g_keyPresenceClock;
+    }
+    (void)pthread_mutex_unlock(&g_keyPresenceMutex);
+    return entry != NULL;
+}
+
+static void MarkKeyPresent(const uint8_t *alias, uint32_t aliasLen)
+{
+    if ((aliasLen == 0) || (aliasLen > KEY_PRESENCE_ALIAS_MAX_LEN)) {
+        return;
+    }
+    (void)pthread_mutex_lock(&g_keyPresenceMutex);
+    KeyPresenceEntry *entry = FindKeyPresence(alias, aliasLen);
+    for (uint32_t i = 0; (entry == NULL) && (i < KEY_PRESENCE_CACHE_SIZE); i++) {
+        if (g_keyPresence[i].aliasLen == 0) {
+            entry = &g_keyPresence[i];
+        }
+    }
+    if (entry == NULL) {
+        entry = &g_keyPresence[0];
+        for (uint32_t i = 1; i < KEY_PRESENCE_CACHE_SIZE; i++) {
+            if (g_keyPresence[i].lastUsed < entry->lastUsed) {
+                entry = &g_keyPresence[i];
+            }
+        }
+    }
+    if (memcpy_s(entry->alias, KEY_PRESENCE_ALIAS_MAX_LEN, alias, aliasLen) == EOK) {
+        entry->aliasLen = aliasLen;
+        entry->lastUsed = ++g_keyPresenceClock;
+    } else {
+        entry->aliasLen = 0;
+    }
+    (void)pthread_mutex_unlock(&g_keyPresenceMutex);
+}
+
+static void MarkKeyAbsent(const uint8_t *alias, uint32_t aliasLen)
+{
+    if (aliasLen > KEY_PRESENCE_ALIAS_MAX_LEN) {
+        return;
+    }
+    (void)pthread_mutex_lock(&g_keyPresenceMutex);
+    KeyPresenceEntry *entry = FindKeyPresence(alias, aliasLen);
+    if (entry != NULL) {
+        entry->aliasLen = 0;
+    }
+    (void)pthread_mutex_unlock(&g_keyPresenceMutex);
+}
+
+/* Maps the result of a huks call on stored keys, so that callers need not check the keys exist beforehand. */
+static int32_t CheckHksKeyResult(int32_t hksRet, const KeyBuff *keys[], uint32_t keyNum, int32_t failedRet)
+{
+    if (hksRet == HKS_SUCCESS) {
+        return HAL_SUCCESS;
+    }
+    if (hksRet != HKS_ERROR_NOT_EXIST) {
+        return failedRet;
+    }
+    for (uint32_t i = 0; i < keyNum; i++) {
+        if (keys[i]->isAlias) {
+            MarkKeyAbsent(keys[i]->key, keys[i]->keyLen);
+        }
+    }
+    return HAL_ERR_KEY_NOT_EXIST;
+}
+
 static int32_t CheckKeyExist(const Uint8Buff *keyAlias)
 {
     CHECK_PTR_RETURN_HAL_ERROR_CODE(keyAlias, "keyAlias");
     CHECK_PTR_RETURN_HAL_ERROR_CODE(keyAlias->val, "keyAlias->val");
     CHECK_LEN_ZERO_RETURN_ERROR_CODE(keyAlias->length, "keyAlias->length");
 
+    if (IsKeyKnownPresent(keyAlias->val, keyAlias->length)) {
+        return HAL_SUCCESS;
+    }
     struct HksBlob keyAliasBlob = { keyAlias->length, keyAlias->val };
     int32_t ret = HksKeyExist(&keyAliasBlob, NULL);
     if (ret != HKS_SUCCESS) {
         LOGI("Hks check key exist or not, ret = %d", ret);
-        return HAL_FAILED;
+        return (ret == HKS_ERROR_NOT_EXIST) ? HAL_ERR_KEY_NOT_EXIST : HAL_FAILED;
     }
+    MarkKeyPresent(keyAlias->val, keyAlias->length);
 
     return HAL_SUCCESS;
 }
@@ -155,6 +324,7 @@ static int32_t DeleteKey(const Uint8Buff *keyAlias)
     CHECK_PTR_RETURN_HAL_ERROR_CODE(keyAlias->val, "keyAlias->val");
     CHECK_LEN_ZERO_RETURN_ERROR_CODE(keyAlias->length, "keyAlias->length");
 
+    MarkKeyAbsent(keyAlias->val, keyAlias->length);
     struct HksBlob keyAliasBlob = { keyAlias->length, keyAlias->val };
     int32_t ret = HksDeleteKey(&keyAliasBlob, NULL);
     if (ret == HKS_ERROR_NOT_EXIST) {
@@ -183,32 +353,20 @@ static int32_t ComputeHmac(const Uint8Buff *key, const Uint8Buff *message, Uint8
     struct HksBlob srcBlob = { message->length, message->val };
     struct HksBlob hmacBlob = { outHmac->length, outHmac->val };
     struct HksParamSet *paramSet = NULL;
-    struct HksParam hmacParam[] = {
-        {
-            .tag = HKS_TAG_PURPOSE,
-            .uint32Param = HKS_KEY_PURPOSE_MAC
-        }, {
-            .tag = HKS_TAG_DIGEST,
-            .uint32Param = HKS_DIGEST_SHA256
-        }, {
-            .tag = HKS_TAG_IS_KEY_ALIAS,
-            .boolParam = isAlias
-        }
-    };
-    ret = ConstructParamSet(&paramSet, hmacParam, CAL_ARRAY_SIZE(hmacParam));
+    uint32_t aliasIndex = isAlias ? 1 : 0;
+    ret = GetConstParamSet(g_hmacParamSet[aliasIndex], g_hmacParam[aliasIndex], HMAC_PARAM_NUM, &paramSet);
     if (ret != HAL_SUCCESS) {
         LOGE("construct param set failed, ret = %d", ret);
         return ret;
     }
 
     ret = HksMac(&keyBlob, paramSet, &srcBlob, &hmacBlob);
+    ReleaseConstParamSet(g_hmacParamSet[aliasIndex], &paramSet);
     if (ret != HKS_SUCCESS  || hmacBlob.size != HMAC_LEN) {
         LOGE("Hmac failed, ret: %d", ret);
-        HksFreeParamSet(&paramSet);
         return HAL_FAILED;
     }
 
-    HksFreeParamSet(&paramSet);
     return HAL_SUCCESS;
 }
 
@@ -531,7 +689,8 @@ static int32_t AgreeSharedSecretWithStorageP256(const KeyBuff *priKeyAlias, cons
         ret = HksInit(&priKeyAliasBlob, initParamSet, &handleBlob);
         if (ret != HKS_SUCCESS) {
             LOGE("Huks agree P256 key: HksInit failed, ret = %d", ret);
-            ret = HAL_ERR_HUKS;
+            const KeyBuff *keys[] = { priKeyAlias };
+            ret = CheckHksKeyResult(ret, keys, CAL_ARRAY_SIZE(keys), HAL_ERR_HUKS);
             break;
         }
         ret = HksUpdate(&handleBlob, initParamSet, &pubKeyBlob, &outDataUpdateBlob);
@@ -543,7 +702,8 @@ static int32_t AgreeSharedSecretWithStorageP256(const KeyBuff *priKeyAlias, cons
         ret = HksFinish(&handleBlob, finishParamSet, &pubKeyBlob, &outDataFinishBlob);
         if (ret != HKS_SUCCESS) {
             LOGE("Huks agree P256 key: HksFinish failed, ret = %d", ret);
-            ret = HAL_ERR_HUKS;
+            const KeyBuff *keys[] = { priKeyAlias, pubKey };
+            ret = CheckHksKeyResult(ret, keys, CAL_ARRAY_SIZE(keys), HAL_ERR_HUKS);
             break;
         }
     } while (0);
@@ -610,24 +770,30 @@ static int32_t AgreeSharedSecretWithStorage(const KeyBuff *priKey, const KeyBuff
     CHECK_LEN_ZERO_RETURN_ERROR_CODE(sharedKeyLen, "sharedKeyLen");
 
     struct HksBlob sharedKeyAliasBlob = { sharedKeyAlias->length, sharedKeyAlias->val };
+    int32_t ret;
     if (g_algToHksAlgorithm[algo] == HKS_ALG_ECC) {
         LOGI("Hks agree key with storage for P256.");
-        return AgreeSharedSecretWithStorageP256(priKey, pubKey, &sharedKeyAliasBlob);
+        ret = AgreeSharedSecretWithStorageP256(priKey, pubKey, &sharedKeyAliasBlob);
+        if (ret == HAL_SUCCESS) {
+            MarkKeyPresent(sharedKeyAlias->val, sharedKeyAlias->length);
+        }
+        return ret;
     }
     struct HksParamSet *paramSet = NULL;
-    int32_t ret = ConstructAgreeWithStorageParams(&paramSet, sharedKeyLen, algo, priKey, pubKey);
+    ret = ConstructAgreeWithStorageParams(&paramSet, sharedKeyLen, algo, priKey, pubKey);
     if (ret != HAL_SUCCESS) {
         return ret;
     }
 
     ret = HksGenerateKey(&sharedKeyAliasBlob, paramSet, NULL);
+    HksFreeParamSet(&paramSet);
     if (ret != HKS_SUCCESS) {
         LOGE("Hks agree key with storage failed, ret = %d", ret);
-        HksFreeParamSet(&paramSet);
-        return HAL_FAILED;
+        const KeyBuff *keys[] = { priKey, pubKey };
+        return CheckHksKeyResult(ret, keys, CAL_ARRAY_SIZE(keys), HAL_FAILED);
     }
+    MarkKeyPresent(sharedKeyAlias->val, sharedKeyAlias->length);
 
-    HksFreeParamSet(&paramSet);
     return HAL_SUCCESS;
 }
 
@@ -787,6 +953,7 @@ static int32_t GenerateKeyPairWithStorage(const Uint8Buff *keyAlias, uint32_t ke
         HksFreeParamSet(&paramSet);
         return HAL_FAILED;
     }
+    MarkKeyPresent(keyAlias->val, keyAlias->length);
 
     HksFreeParamSet(&paramSet);
     return HAL_SUCCESS;
@@ -921,7 +1088,9 @@ static int32_t ExportPublicKey(const Uint8Buff *keyAlias, Uint8Buff *outPubKey)
     int32_t ret = HksExportPublicKey(&keyAliasBlob, NULL, &keyBlob);
     if (ret != HKS_SUCCESS) {
         LOGE("Export public key failed, ret=%d", ret);
-        return HAL_FAILED;
+        KeyBuff key = { keyAlias->val, keyAlias->length, true };
+        const KeyBuff *keys[] = { &key };
+        return CheckHksKeyResult(ret, keys, CAL_ARRAY_SIZE(keys), HAL_FAILED);
     }
     outPubKey->length = keyBlob.size;
 
@@ -1149,6 +1318,7 @@ static int32_t ImportPublicKey(const Uint8Buff *keyAlias, const Uint8Buff *pubKe
         HksFreeParamSet(&paramSet);
         return HAL_FAILED;
     }
+    MarkKeyPresent(keyAlias->val, keyAlias->length);
 
     HksFreeParamSet(&paramSet);
     return HAL_SUCCESS;
@@ -1353,6 +1523,7 @@ static int32_t ImportSymmetricKey(const Uint8Buff *keyAlias, const Uint8Buff *au
         HksFreeParamSet(&paramSet);
         return ret;
     }
+    MarkKeyPresent(keyAlias->val, keyAlias->length);
 
     HksFreeParamSet(&paramSet);
     return HAL_SUCCESS;
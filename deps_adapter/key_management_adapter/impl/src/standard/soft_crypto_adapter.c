@@ -0,0 +1,302 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "soft_crypto_adapter.h"
+#include <limits.h>
+#include <pthread.h>
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
+#include <openssl/kdf.h>
+#include <openssl/rand.h>
+#include <openssl/sha.h>
+#include "hal_error.h"
+#include "hc_log.h"
+#include "huks_adapter.h"
+#include "securec.h"
+
+#define GCM_NONCE_MIN_LEN 12
+#define AES_128_KEY_LEN 16
+#define AES_192_KEY_LEN 24
+#define AES_256_KEY_LEN 32
+
+static AlgLoader g_softLoader;
+static pthread_once_t g_softLoaderOnce = PTHREAD_ONCE_INIT;
+
+static int32_t CheckBuffs(const Uint8Buff **inParams, const char **paramTags, uint32_t len)
+{
+    for (uint32_t i = 0; i < len; i++) {
+        CHECK_PTR_RETURN_HAL_ERROR_CODE(inParams[i], paramTags[i]);
+        CHECK_PTR_RETURN_HAL_ERROR_CODE(inParams[i]->val, paramTags[i]);
+        CHECK_LEN_ZERO_RETURN_ERROR_CODE(inParams[i]->length, paramTags[i]);
+        /* openssl takes int lengths in the EVP interfaces */
+        CHECK_LEN_HIGHER_RETURN(inParams[i]->length, INT_MAX, paramTags[i]);
+    }
+    return HAL_SUCCESS;
+}
+
+static int32_t SoftSha256(const Uint8Buff *message, Uint8Buff *hash)
+{
+    const Uint8Buff *inParams[] = { message, hash };
+    const char *paramTags[] = { "message", "hash" };
+    int32_t ret = CheckBuffs(inParams, paramTags, CAL_ARRAY_SIZE(inParams));
+    if (ret != HAL_SUCCESS) {
+        return ret;
+    }
+    CHECK_LEN_EQUAL_RETURN(hash->length, SHA256_LEN, "hash->length");
+
+    if (SHA256(message->val, message->length, hash->val) == NULL) {
+        LOGE("Soft sha256 failed.");
+        return HAL_FAILED;
+    }
+    return HAL_SUCCESS;
+}
+
+static int32_t SoftGenerateRandom(Uint8Buff *rand)
+{
+    const Uint8Buff *inParams[] = { rand };
+    const char *paramTags[] = { "rand" };
+    int32_t ret = CheckBuffs(inParams, paramTags, CAL_ARRAY_SIZE(inParams));
+    if (ret != HAL_SUCCESS) {
+        return ret;
+    }
+
+    if (RAND_bytes(rand->val, (int)rand->length) != 1) {
+        LOGE("Soft generate random failed.");
+        return HAL_FAILED;
+    }
+    return HAL_SUCCESS;
+}
+
+static int32_t SoftComputeHmac(const Uint8Buff *key, const Uint8Buff *message, Uint8Buff *outHmac, bool isAlias)
+{
+    if (isAlias) {
+        return GetRealLoaderInstance()->computeHmac(key, message, outHmac, isAlias);
+    }
+    const Uint8Buff *inParams[] = { key, message, outHmac };
+    const char *paramTags[] = { "key", "message", "outHmac" };
+    int32_t ret = CheckBuffs(inParams, paramTags, CAL_ARRAY_SIZE(inParams));
+    if (ret != HAL_SUCCESS) {
+        return ret;
+    }
+    CHECK_LEN_EQUAL_RETURN(outHmac->length, HMAC_LEN, "outHmac->length");
+
+    unsigned int hmacLen = 0;
+    if ((HMAC(EVP_sha256(), key->val, (int)key->length, message->val, message->length, outHmac->val,
+        &hmacLen) == NULL) || (hmacLen != HMAC_LEN)) {
+        LOGE("Soft hmac failed.");
+        return HAL_FAILED;
+    }
+    return HAL_SUCCESS;
+}
+
+static int32_t DoHkdf(EVP_PKEY_CTX *ctx, const Uint8Buff *baseKey, const Uint8Buff *salt, const Uint8Buff *keyInfo,
+    Uint8Buff *outHkdf)
+{
+    if ((EVP_PKEY_derive_init(ctx) <= 0) || (EVP_PKEY_CTX_set_hkdf_md(ctx, EVP_sha256()) <= 0) ||
+        (EVP_PKEY_CTX_set1_hkdf_salt(ctx, salt->val, (int)salt->length) <= 0) ||
+        (EVP_PKEY_CTX_set1_hkdf_key(ctx, baseKey->val, (int)baseKey->length) <= 0)) {
+        return HAL_FAILED;
+    }
+    if ((keyInfo != NULL) && (keyInfo->val != NULL) && (keyInfo->length > 0)) {
+        if ((keyInfo->length > INT_MAX) ||
+            (EVP_PKEY_CTX_add1_hkdf_info(ctx, keyInfo->val, (int)keyInfo->length) <= 0)) {
+            return HAL_FAILED;
+        }
+    }
+    size_t outLen = outHkdf->length;
+    if ((EVP_PKEY_derive(ctx, outHkdf->val, &outLen) <= 0) || (outLen != outHkdf->length)) {
+        return HAL_FAILED;
+    }
+    return HAL_SUCCESS;
+}
+
+static int32_t SoftComputeHkdf(const Uint8Buff *baseKey, const Uint8Buff *salt, const Uint8Buff *keyInfo,
+    Uint8Buff *outHkdf, bool isAlias)
+{
+    if (isAlias) {
+        return GetRealLoaderInstance()->computeHkdf(baseKey, salt, keyInfo, outHkdf, isAlias);
+    }
+    const Uint8Buff *inParams[] = { baseKey, salt, outHkdf };
+    const char *paramTags[] = { "baseKey", "salt", "outHkdf" };
+    int32_t ret = CheckBuffs(inParams, paramTags, CAL_ARRAY_SIZE(inParams));
+    if (ret != HAL_SUCCESS) {
+        return ret;
+    }
+
+    EVP_PKEY_CTX *ctx = EVP_PKEY_CTX_new_id(EVP_PKEY_HKDF, NULL);
+    if (ctx == NULL) {
+        LOGE("Failed to create hkdf ctx.");
+        return HAL_ERR_BAD_ALLOC;
+    }
+    ret = DoHkdf(ctx, baseKey, salt, keyInfo, outHkdf);
+    EVP_PKEY_CTX_free(ctx);
+    if (ret != HAL_SUCCESS) {
+        LOGE("Soft key derivation failed.");
+    }
+    return ret;
+}
+
+static const EVP_CIPHER *GetGcmCipher(uint32_t keyLen)
+{
+    switch (keyLen) {
+        case AES_128_KEY_LEN:
+            return EVP_aes_128_gcm();
+        case AES_192_KEY_LEN:
+            return EVP_aes_192_gcm();
+        case AES_256_KEY_LEN:
+            return EVP_aes_256_gcm();
+        default:
+            return NULL;
+    }
+}
+
+static int32_t CheckGcmParams(const Uint8Buff *key, const Uint8Buff *in, const GcmParam *gcmInfo, Uint8Buff *out)
+{
+    const Uint8Buff *inParams[] = { key, in, out };
+    const char *paramTags[] = { "key", "in", "out" };
+    int32_t ret = CheckBuffs(inParams, paramTags, CAL_ARRAY_SIZE(inParams));
+    if (ret != HAL_SUCCESS) {
+        return ret;
+    }
+    CHECK_PTR_RETURN_HAL_ERROR_CODE(gcmInfo, "gcmInfo");
+    CHECK_PTR_RETURN_HAL_ERROR_CODE(gcmInfo->aad, "aad");
+    CHECK_LEN_ZERO_RETURN_ERROR_CODE(gcmInfo->aadLen, "aadLen");
+    CHECK_LEN_HIGHER_RETURN(gcmInfo->aadLen, INT_MAX, "aadLen");
+    CHECK_PTR_RETURN_HAL_ERROR_CODE(gcmInfo->nonce, "nonce");
+    CHECK_LEN_LOWER_RETURN(gcmInfo->nonceLen, GCM_NONCE_MIN_LEN, "nonceLen");
+    CHECK_LEN_HIGHER_RETURN(gcmInfo->nonceLen, INT_MAX, "nonceLen");
+    if (GetGcmCipher(key->length) == NULL) {
+        LOGE("Invalid aes key length: %u", key->length);
+        return HAL_ERR_INVALID_LEN;
+    }
+    return HAL_SUCCESS;
+}
+
+static int32_t InitGcmCtx(EVP_CIPHER_CTX *ctx, const Uint8Buff *key, const GcmParam *gcmInfo, int isEncrypt)
+{
+    int outLen = 0;
+    if ((EVP_CipherInit_ex(ctx, GetGcmCipher(key->length), NULL, NULL, NULL, isEncrypt) != 1) ||
+        (EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_SET_IVLEN, (int)gcmInfo->nonceLen, NULL) != 1) ||
+        (EVP_CipherInit_ex(ctx, NULL, NULL, key->val, gcmInfo->nonce, isEncrypt) != 1) ||
+        (EVP_CipherUpdate(ctx, NULL, &outLen, gcmInfo->aad, (int)gcmInfo->aadLen) != 1)) {
+        return HAL_FAILED;
+    }
+    return HAL_SUCCESS;
+}
+
+static int32_t DoGcmEncrypt(EVP_CIPHER_CTX *ctx, const Uint8Buff *key, const Uint8Buff *plain,
+    const GcmParam *encryptInfo, Uint8Buff *outCipher)
+{
+    int updateLen = 0;
+    int finalLen = 0;
+    if ((InitGcmCtx(ctx, key, encryptInfo, 1) != HAL_SUCCESS) ||
+        (EVP_EncryptUpdate(ctx, outCipher->val, &updateLen, plain->val, (int)plain->length) != 1) ||
+        (EVP_EncryptFinal_ex(ctx, outCipher->val + updateLen, &finalLen) != 1) ||
+        ((uint32_t)(updateLen + finalLen) != plain->length)) {
+        return HAL_FAILED;
+    }
+    /* the tag follows the cipher text, as huks outputs it */
+    if (EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_GET_TAG, AE_TAG_LEN, outCipher->val + plain->length) != 1) {
+        return HAL_FAILED;
+    }
+    return HAL_SUCCESS;
+}
+
+static int32_t SoftAesGcmEncrypt(const Uint8Buff *key, const Uint8Buff *plain,
+    const GcmParam *encryptInfo, bool isAlias, Uint8Buff *outCipher)
+{
+    if (isAlias) {
+        return GetRealLoaderInstance()->aesGcmEncrypt(key, plain, encryptInfo, isAlias, outCipher);
+    }
+    int32_t ret = CheckGcmParams(key, plain, encryptInfo, outCipher);
+    if (ret != HAL_SUCCESS) {
+        return ret;
+    }
+    CHECK_LEN_HIGHER_RETURN(plain->length, INT_MAX - AE_TAG_LEN, "plain");
+    CHECK_LEN_LOWER_RETURN(outCipher->length, plain->length + AE_TAG_LEN, "outCipher");
+
+    EVP_CIPHER_CTX *ctx = EVP_CIPHER_CTX_new();
+    if (ctx == NULL) {
+        LOGE("Failed to create cipher ctx.");
+        return HAL_ERR_BAD_ALLOC;
+    }
+    ret = DoGcmEncrypt(ctx, key, plain, encryptInfo, outCipher);
+    EVP_CIPHER_CTX_free(ctx);
+    if (ret != HAL_SUCCESS) {
+        LOGE("Soft aes-gcm encrypt failed.");
+    }
+    return ret;
+}
+
+static int32_t DoGcmDecrypt(EVP_CIPHER_CTX *ctx, const Uint8Buff *key, const Uint8Buff *cipher,
+    const GcmParam *decryptInfo, Uint8Buff *outPlain)
+{
+    uint32_t textLen = cipher->length - AE_TAG_LEN;
+    int updateLen = 0;
+    int finalLen = 0;
+    if ((InitGcmCtx(ctx, key, decryptInfo, 0) != HAL_SUCCESS) ||
+        (EVP_DecryptUpdate(ctx, outPlain->val, &updateLen, cipher->val, (int)textLen) != 1) ||
+        (EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_SET_TAG, AE_TAG_LEN, cipher->val + textLen) != 1) ||
+        (EVP_DecryptFinal_ex(ctx, outPlain->val + updateLen, &finalLen) != 1) ||
+        ((uint32_t)(updateLen + finalLen) != textLen)) {
+        /* The update already wrote the plaintext before the tag was checked, don't leave it to the caller. */
+        (void)memset_s(outPlain->val, textLen, 0, textLen);
+        return HAL_FAILED;
+    }
+    return HAL_SUCCESS;
+}
+
+static int32_t SoftAesGcmDecrypt(const Uint8Buff *key, const Uint8Buff *cipher,
+    const GcmParam *decryptInfo, bool isAlias, Uint8Buff *outPlain)
+{
+    if (isAlias) {
+        return GetRealLoaderInstance()->aesGcmDecrypt(key, cipher, decryptInfo, isAlias, outPlain);
+    }
+    int32_t ret = CheckGcmParams(key, cipher, decryptInfo, outPlain);
+    if (ret != HAL_SUCCESS) {
+        return ret;
+    }
+    CHECK_LEN_LOWER_RETURN(cipher->length, AE_TAG_LEN, "cipher");
+    CHECK_LEN_LOWER_RETURN(outPlain->length, cipher->length - AE_TAG_LEN, "outPlain");
+
+    EVP_CIPHER_CTX *ctx = EVP_CIPHER_CTX_new();
+    if (ctx == NULL) {
+        LOGE("Failed to create cipher ctx.");
+        return HAL_ERR_BAD_ALLOC;
+    }
+    ret = DoGcmDecrypt(ctx, key, cipher, decryptInfo, outPlain);
+    EVP_CIPHER_CTX_free(ctx);
+    if (ret != HAL_SUCCESS) {
+        LOGE("Soft aes-gcm decrypt failed.");
+    }
+    return ret;
+}
+
+static void InitSoftLoader(void)
+{
+    g_softLoader = *GetRealLoaderInstance();
+    g_softLoader.sha256 = SoftSha256;
+    g_softLoader.generateRandom = SoftGenerateRandom;
+    g_softLoader.computeHmac = SoftComputeHmac;
+    g_softLoader.computeHkdf = SoftComputeHkdf;
+    g_softLoader.aesGcmEncrypt = SoftAesGcmEncrypt;
+    g_softLoader.aesGcmDecrypt = SoftAesGcmDecrypt;
+}
+
+const AlgLoader *GetSoftCryptoLoaderInstance()
+{
+    (void)pthread_once(&g_softLoaderOnce, InitSoftLoader);
+    return &g_softLoader;
+}
@@ -16,8 +16,16 @@
 #include "hc_log.h"
 #include "securec.h"
 
+#ifdef DEV_AUTH_LOG_ASYNC
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#endif
+
 #define LOG_PRINT_MAX_LEN 256
 
+static volatile DevAuthLogLevel g_logMinLevel = DEV_AUTH_LOG_LEVEL_DEBUG;
+
 static void DevAuthOutPrint(const char *buf, DevAuthLogLevel level)
 {
 #ifdef DEV_AUTH_DEBUG_PRINTF
@@ -42,21 +50,233 @@ static void DevAuthOutPrint(const char *buf, DevAuthLogLevel level)
     }
 }
 
-void DevAuthLogPrint(DevAuthLogLevel level, const char *funName, const char *fmt, ...)
+#ifdef DEV_AUTH_LOG_ASYNC
+/*
+ * Each logging thread owns one single-producer single-consumer ring, so writing a log only
+ * needs a copy and an atomic store. The writer thread drains all rings and does the real print.
+ * If a thread gets no ring or its ring is full, the log is printed synchronously instead of dropped.
+ */
+#define LOG_RING_NUM 8
+#define LOG_RING_ENTRY_NUM 32
+
+typedef struct {
+    DevAuthLogLevel level;
+    char buf[LOG_PRINT_MAX_LEN];
+} LogEntry;
+
+typedef struct {
+    atomic_bool isOwned;
+    atomic_uint head; /* written by the writer thread only */
+    atomic_uint tail; /* written by the owner thread only */
+    LogEntry entries[LOG_RING_ENTRY_NUM];
+} LogRing;
+
+static LogRing g_logRings[LOG_RING_NUM];
+static pthread_once_t g_logRingKeyOnce = PTHREAD_ONCE_INIT;
+static pthread_key_t g_logRingKey;
+static bool g_isLogRingKeyCreated = false;
+static __thread LogRing *g_threadLogRing = NULL;
+static __thread bool g_isRingRequested = false;
+
+/*
+ * The writer sleeps on the condition while all rings are empty. It publishes isIdle before checking the
+ * rings and a logging thread publishes its entry before checking isIdle, so one of them always sees the other.
+ */
+static pthread_mutex_t g_logWriterMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t g_logWriterCond = PTHREAD_COND_INITIALIZER;
+static pthread_t g_logWriter;
+static bool g_isLogWriterStopping = false;
+static atomic_bool g_isLogWriterRunning = false;
+static atomic_bool g_isLogWriterIdle = false;
+
+static void DrainLogRing(LogRing *ring)
 {
-    int32_t ulPos = 0;
-    char outStr[LOG_PRINT_MAX_LEN] = {0};
-    int32_t ret = sprintf_s(outStr, sizeof(outStr), "%s: ", funName);
-    if (ret < 0) {
+    unsigned int head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    unsigned int tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    if (head == tail) {
+        return;
+    }
+    for (; head != tail; head++) {
+        LogEntry *entry = &ring->entries[head % LOG_RING_ENTRY_NUM];
+        DevAuthOutPrint(entry->buf, entry->level);
+    }
+    atomic_store_explicit(&ring->head, head, memory_order_release);
+}
+
+static bool HasPendingLog(void)
+{
+    for (uint32_t i = 0; i < LOG_RING_NUM; i++) {
+        if (atomic_load(&g_logRings[i].tail) != atomic_load_explicit(&g_logRings[i].head, memory_order_relaxed)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void *LogWriterLoop(void *args)
+{
+    (void)args;
+    bool isStopping = false;
+    while (!isStopping) {
+        for (uint32_t i = 0; i < LOG_RING_NUM; i++) {
+            DrainLogRing(&g_logRings[i]);
+        }
+        (void)pthread_mutex_lock(&g_logWriterMutex);
+        atomic_store(&g_isLogWriterIdle, true);
+        while (!g_isLogWriterStopping && !HasPendingLog()) {
+            (void)pthread_cond_wait(&g_logWriterCond, &g_logWriterMutex);
+        }
+        atomic_store(&g_isLogWriterIdle, false);
+        isStopping = g_isLogWriterStopping;
+        (void)pthread_mutex_unlock(&g_logWriterMutex);
+    }
+    for (uint32_t i = 0; i < LOG_RING_NUM; i++) {
+        DrainLogRing(&g_logRings[i]);
+    }
+    return NULL;
+}
+
+static bool StartLogWriter(void)
+{
+    if (atomic_load_explicit(&g_isLogWriterRunning, memory_order_acquire)) {
+        return true;
+    }
+    (void)pthread_mutex_lock(&g_logWriterMutex);
+    bool isRunning = atomic_load_explicit(&g_isLogWriterRunning, memory_order_relaxed);
+    if (!isRunning && !g_isLogWriterStopping) {
+        isRunning = (pthread_create(&g_logWriter, NULL, LogWriterLoop, NULL) == 0);
+        atomic_store_explicit(&g_isLogWriterRunning, isRunning, memory_order_release);
+    }
+    (void)pthread_mutex_unlock(&g_logWriterMutex);
+    return isRunning;
+}
+
+static void WakeLogWriter(void)
+{
+    if (!atomic_load(&g_isLogWriterIdle)) {
+        return;
+    }
+    (void)pthread_mutex_lock(&g_logWriterMutex);
+    (void)pthread_cond_signal(&g_logWriterCond);
+    (void)pthread_mutex_unlock(&g_logWriterMutex);
+}
+
+static void ReleaseLogRing(void *ring)
+{
+    /* The pending entries stay in the ring and are still printed, the next owner appends after them. */
+    atomic_store_explicit(&((LogRing *)ring)->isOwned, false, memory_order_release);
+}
+
+static void CreateLogRingKey(void)
+{
+    g_isLogRingKeyCreated = (pthread_key_create(&g_logRingKey, ReleaseLogRing) == 0);
+}
+
+static LogRing *GetThreadLogRing(void)
+{
+    if (g_isRingRequested) {
+        return g_threadLogRing;
+    }
+    g_isRingRequested = true;
+    (void)pthread_once(&g_logRingKeyOnce, CreateLogRingKey);
+    if (!g_isLogRingKeyCreated) {
+        return NULL;
+    }
+    for (uint32_t i = 0; i < LOG_RING_NUM; i++) {
+        bool isOwned = false;
+        if (atomic_compare_exchange_strong_explicit(&g_logRings[i].isOwned, &isOwned, true,
+            memory_order_acquire, memory_order_relaxed)) {
+            if (pthread_setspecific(g_logRingKey, &g_logRings[i]) != 0) {
+                atomic_store_explicit(&g_logRings[i].isOwned, false, memory_order_release);
+                return NULL;
+            }
+            g_threadLogRing = &g_logRings[i];
+            break;
+        }
+    }
+    return g_threadLogRing;
+}
+
+/* Return the entry to format the log into, or NULL if the log has to be printed synchronously. */
+static LogEntry *AcquireLogEntry(LogRing *ring)
+{
+    unsigned int tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    unsigned int head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    if (tail - head >= LOG_RING_ENTRY_NUM) {
+        return NULL;
+    }
+    return &ring->entries[tail % LOG_RING_ENTRY_NUM];
+}
+
+static void CommitLogEntry(LogRing *ring)
+{
+    unsigned int tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    atomic_store(&ring->tail, tail + 1);
+    WakeLogWriter();
+}
+#endif
+
+void DevAuthStopLogWriter(void)
+{
+#ifdef DEV_AUTH_LOG_ASYNC
+    (void)pthread_mutex_lock(&g_logWriterMutex);
+    if (!atomic_load_explicit(&g_isLogWriterRunning, memory_order_relaxed) || g_isLogWriterStopping) {
+        (void)pthread_mutex_unlock(&g_logWriterMutex);
         return;
     }
-    ulPos = strlen(outStr);
+    g_isLogWriterStopping = true;
+    (void)pthread_cond_signal(&g_logWriterCond);
+    (void)pthread_mutex_unlock(&g_logWriterMutex);
+    (void)pthread_join(g_logWriter, NULL);
+    (void)pthread_mutex_lock(&g_logWriterMutex);
+    atomic_store_explicit(&g_isLogWriterRunning, false, memory_order_release);
+    g_isLogWriterStopping = false;
+    (void)pthread_mutex_unlock(&g_logWriterMutex);
+#endif
+}
+
+void DevAuthSetLogLevel(DevAuthLogLevel level)
+{
+    g_logMinLevel = level;
+}
+
+DevAuthLogLevel DevAuthGetLogLevel(void)
+{
+    return g_logMinLevel;
+}
+
+static int32_t FormatLog(char *outStr, uint32_t outLen, const char *funName, const char *fmt, va_list arg)
+{
+    int32_t ret = sprintf_s(outStr, outLen, "%s: ", funName);
+    if (ret < 0) {
+        return ret;
+    }
+    uint32_t ulPos = strlen(outStr);
+    return vsprintf_s(&outStr[ulPos], outLen - ulPos, fmt, arg);
+}
+
+void DevAuthLogPrint(DevAuthLogLevel level, const char *funName, const char *fmt, ...)
+{
     va_list arg;
     va_start(arg, fmt);
-    ret = vsprintf_s(&outStr[ulPos], sizeof(outStr) - ulPos, fmt, arg);
+#ifdef DEV_AUTH_LOG_ASYNC
+    LogRing *ring = StartLogWriter() ? GetThreadLogRing() : NULL;
+    LogEntry *entry = (ring == NULL) ? NULL : AcquireLogEntry(ring);
+    if (entry != NULL) {
+        int32_t res = FormatLog(entry->buf, sizeof(entry->buf), funName, fmt, arg);
+        va_end(arg);
+        if (res >= 0) {
+            entry->level = level;
+            CommitLogEntry(ring);
+        }
+        return;
+    }
+#endif
+    char outStr[LOG_PRINT_MAX_LEN] = {0};
+    int32_t ret = FormatLog(outStr, sizeof(outStr), funName, fmt, arg);
     va_end(arg);
     if (ret < 0) {
         return;
     }
     DevAuthOutPrint(outStr, level);
-}
\ No newline at end of file
+}
@@ -17,9 +17,9 @@
 #include "hal_error.h"
 #include "hc_log.h"
 
-#define TASK_ALLOC_UINT 5
+#define TASK_ALLOC_UINT 8
 
-IMPLEMENT_HC_VECTOR(TaskVec, HcTaskWrap, TASK_ALLOC_UINT)
+IMPLEMENT_HC_DEQUE(TaskDeque, HcTaskWrap, TASK_ALLOC_UINT)
 
 static HcTaskBase* PopTask(HcTaskThread* thread)
 {
@@ -56,7 +56,7 @@ static void Clear(struct HcTaskThreadT* thread)
     thread->queueLock.lock(&thread->queueLock);
     HcTaskWrap *taskWarp = NULL;
     uint32_t index;
-    FOR_EACH_HC_VECTOR(thread->tasks, index, taskWarp) {
+    FOR_EACH_HC_DEQUE(thread->tasks, index, taskWarp) {
         if (taskWarp->task->destroy) {
             taskWarp->task->destroy(taskWarp->task);
         }
@@ -137,13 +137,13 @@ int32_t InitHcTaskThread(HcTaskThread* thread, size_t stackSize, const char* thr
         DestroyThread(&thread->thread);
         return res;
     }
-    thread->tasks = CREATE_HC_VECTOR(TaskVec);
+    thread->tasks = CREATE_HC_DEQUE(TaskDeque);
     return 0;
 }
 
 void DestroyHcTaskThread(HcTaskThread* thread)
 {
-    DESTROY_HC_VECTOR(TaskVec, &thread->tasks);
+    DESTROY_HC_DEQUE(TaskDeque, &thread->tasks);
     DestroyHcMutex(&thread->queueLock);
     DestroyThread(&thread->thread);
-}
\ No newline at end of file
+}
@@ -14,6 +14,8 @@
  */
 
 #include "hc_dev_info.h"
+#include <pthread.h>
+#include <stdbool.h>
 #include "hal_error.h"
 #include "hc_log.h"
 #include "parameter.h"
@@ -23,17 +25,48 @@
 extern "C" {
 #endif
 
+/*
+ * The udid never changes while the process runs, so it is read from the system only once. The read is an ipc and
+ * runs outside the lock, concurrent first callers may both read it, they get the same udid.
+ */
+static pthread_mutex_t g_udidMutex = PTHREAD_MUTEX_INITIALIZER;
+static char g_udid[INPUT_UDID_LEN] = { 0 };
+static bool g_isUdidCached = false;
+
+static int32_t CacheUdid(void)
+{
+    char udid[INPUT_UDID_LEN] = { 0 };
+    int32_t res = GetDevUdid(udid, INPUT_UDID_LEN);
+    if (res != 0) {
+        LOGE("[OS]: GetDevUdid fail! res: %d", res);
+        return HAL_FAILED;
+    }
+    (void)pthread_mutex_lock(&g_udidMutex);
+    if (!g_isUdidCached && (memcpy_s(g_udid, INPUT_UDID_LEN, udid, INPUT_UDID_LEN) == EOK)) {
+        g_isUdidCached = true;
+    }
+    (void)pthread_mutex_unlock(&g_udidMutex);
+    return HAL_SUCCESS;
+}
+
 int32_t HcGetUdid(uint8_t *udid, int32_t udidLen)
 {
     if (udid == NULL || udidLen < INPUT_UDID_LEN || udidLen > MAX_INPUT_UDID_LEN) {
         return HAL_ERR_INVALID_PARAM;
     }
-    int32_t res = GetDevUdid((char *)udid, udidLen);
-    if (res != 0) {
-        LOGE("[OS]: GetDevUdid fail! res: %d", res);
+    (void)pthread_mutex_lock(&g_udidMutex);
+    bool isCached = g_isUdidCached;
+    (void)pthread_mutex_unlock(&g_udidMutex);
+    if (!isCached && (CacheUdid() != HAL_SUCCESS)) {
         return HAL_FAILED;
     }
-    return HAL_SUCCESS;
+    int32_t res = HAL_FAILED;
+    (void)pthread_mutex_lock(&g_udidMutex);
+    if (g_isUdidCached && (strcpy_s((char *)udid, udidLen, g_udid) == EOK)) {
+        res = HAL_SUCCESS;
+    }
+    (void)pthread_mutex_unlock(&g_udidMutex);
+    return res;
 }
 
 const char *GetStoragePath(void)
@@ -14,6 +14,7 @@
  */
 
 #include "hc_types.h"
+#include "hal_error.h"
 #include "hc_log.h"
 #include "securec.h"
 
@@ -21,26 +22,216 @@
 extern "C" {
 #endif
 
+static HcAllocator g_allocator = { malloc, free };
+static __thread HcMemModule g_curMemModule = HC_MEM_MODULE_COMMON;
+
+#ifdef HC_MEM_STAT
+#include <pthread.h>
+
+#define HC_MEM_HEADER_SIZE 16
+#define HC_MEM_MIN_CLASS_SHIFT 5
+#define HC_MEM_SIZE_CLASS_NUM 5
+#define HC_MEM_NO_SIZE_CLASS 0xFFFF
+#define HC_MEM_POOL_MAX_FREE_NUM 64
+
+/* Placed in front of every block, padded so that the returned address keeps the malloc alignment. */
+typedef union {
+    struct {
+        uint32_t size;
+        uint16_t module;
+        uint16_t sizeClass;
+    } info;
+    void *next; /* only used while the block is in a free list */
+    uint8_t padding[HC_MEM_HEADER_SIZE];
+} HcMemHeader;
+
+static pthread_mutex_t g_memMutex = PTHREAD_MUTEX_INITIALIZER;
+static HcMemHeader *g_freeList[HC_MEM_SIZE_CLASS_NUM] = { NULL };
+static uint32_t g_freeNum[HC_MEM_SIZE_CLASS_NUM] = { 0 };
+static HcMemStat g_memStat[HC_MEM_MODULE_NUM];
+
+static uint32_t GetClassSize(uint16_t sizeClass)
+{
+    return 1U << (sizeClass + HC_MEM_MIN_CLASS_SHIFT);
+}
+
+static uint16_t GetSizeClass(uint32_t size)
+{
+    for (uint16_t i = 0; i < HC_MEM_SIZE_CLASS_NUM; i++) {
+        if (size <= GetClassSize(i)) {
+            return i;
+        }
+    }
+    return HC_MEM_NO_SIZE_CLASS;
+}
+
+static void RecordAlloc(HcMemModule module, uint32_t size)
+{
+    HcMemStat *stat = &g_memStat[module];
+    stat->allocCount++;
+    stat->liveCount++;
+    stat->curBytes += size;
+    if (stat->curBytes > stat->peakBytes) {
+        stat->peakBytes = stat->curBytes;
+    }
+}
+
+static void RecordFree(HcMemModule module, uint32_t size)
+{
+    HcMemStat *stat = &g_memStat[module];
+    stat->liveCount--;
+    stat->curBytes -= size;
+}
+
+static void *AllocBlock(uint32_t size)
+{
+    if (size > UINT32_MAX - HC_MEM_HEADER_SIZE) {
+        return NULL;
+    }
+    HcMemModule module = g_curMemModule;
+    uint16_t sizeClass = GetSizeClass(size);
+    HcMemHeader *header = NULL;
+    (void)pthread_mutex_lock(&g_memMutex);
+    if ((sizeClass != HC_MEM_NO_SIZE_CLASS) && (g_freeList[sizeClass] != NULL)) {
+        header = g_freeList[sizeClass];
+        g_freeList[sizeClass] = (HcMemHeader *)header->next;
+        g_freeNum[sizeClass]--;
+    }
+    (void)pthread_mutex_unlock(&g_memMutex);
+    if (header == NULL) {
+        uint32_t blockSize = (sizeClass == HC_MEM_NO_SIZE_CLASS) ? size : GetClassSize(sizeClass);
+        header = (HcMemHeader *)g_allocator.alloc(HC_MEM_HEADER_SIZE + blockSize);
+        if (header == NULL) {
+            return NULL;
+        }
+    }
+    header->info.size = size;
+    header->info.module = (uint16_t)module;
+    header->info.sizeClass = sizeClass;
+    (void)pthread_mutex_lock(&g_memMutex);
+    RecordAlloc(module, size);
+    (void)pthread_mutex_unlock(&g_memMutex);
+    return (uint8_t *)header + HC_MEM_HEADER_SIZE;
+}
+
+static void FreeBlock(void *addr)
+{
+    HcMemHeader *header = (HcMemHeader *)((uint8_t *)addr - HC_MEM_HEADER_SIZE);
+    uint16_t sizeClass = header->info.sizeClass;
+    (void)pthread_mutex_lock(&g_memMutex);
+    RecordFree((HcMemModule)header->info.module, header->info.size);
+    if ((sizeClass != HC_MEM_NO_SIZE_CLASS) && (g_freeNum[sizeClass] < HC_MEM_POOL_MAX_FREE_NUM)) {
+        header->next = g_freeList[sizeClass];
+        g_freeList[sizeClass] = header;
+        g_freeNum[sizeClass]++;
+        header = NULL;
+    }
+    (void)pthread_mutex_unlock(&g_memMutex);
+    if (header != NULL) {
+        g_allocator.free(header);
+    }
+}
+
+/* Need to hold g_memMutex, the pooled blocks must go back to the backend they came from. */
+static void DrainPools(void)
+{
+    for (uint32_t i = 0; i < HC_MEM_SIZE_CLASS_NUM; i++) {
+        while (g_freeList[i] != NULL) {
+            HcMemHeader *header = g_freeList[i];
+            g_freeList[i] = (HcMemHeader *)header->next;
+            g_allocator.free(header);
+        }
+        g_freeNum[i] = 0;
+    }
+}
+#else
+static void *AllocBlock(uint32_t size)
+{
+    return g_allocator.alloc(size);
+}
+
+static void FreeBlock(void *addr)
+{
+    g_allocator.free(addr);
+}
+#endif
+
 void* HcMalloc(uint32_t size, char val)
 {
     if (size == 0) {
         LOGE("Malloc size is invalid.");
         return NULL;
     }
-    void* addr = malloc(size);
+    void* addr = AllocBlock(size);
     if (addr != NULL) {
         (void)memset_s(addr, size, val, size);
     }
     return addr;
 }
 
+void* HcMallocNoZero(uint32_t size)
+{
+    if (size == 0) {
+        LOGE("Malloc size is invalid.");
+        return NULL;
+    }
+    return AllocBlock(size);
+}
+
 void HcFree(void* addr)
 {
     if (addr != NULL) {
-        free(addr);
+        FreeBlock(addr);
     }
 }
 
+int32_t HcSetAllocator(const HcAllocator *allocator)
+{
+    if ((allocator != NULL) && ((allocator->alloc == NULL) || (allocator->free == NULL))) {
+        LOGE("Invalid allocator.");
+        return HAL_ERR_INVALID_PARAM;
+    }
+#ifdef HC_MEM_STAT
+    (void)pthread_mutex_lock(&g_memMutex);
+    DrainPools();
+#endif
+    if (allocator == NULL) {
+        g_allocator.alloc = malloc;
+        g_allocator.free = free;
+    } else {
+        g_allocator = *allocator;
+    }
+#ifdef HC_MEM_STAT
+    (void)pthread_mutex_unlock(&g_memMutex);
+#endif
+    return HAL_SUCCESS;
+}
+
+HcMemModule HcSetMemModule(HcMemModule module)
+{
+    HcMemModule prevModule = g_curMemModule;
+    if ((module >= HC_MEM_MODULE_COMMON) && (module < HC_MEM_MODULE_NUM)) {
+        g_curMemModule = module;
+    }
+    return prevModule;
+}
+
+int32_t HcGetMemStat(HcMemModule module, HcMemStat *stat)
+{
+    if ((stat == NULL) || (module < HC_MEM_MODULE_COMMON) || (module >= HC_MEM_MODULE_NUM)) {
+        return HAL_ERR_INVALID_PARAM;
+    }
+#ifdef HC_MEM_STAT
+    (void)pthread_mutex_lock(&g_memMutex);
+    *stat = g_memStat[module];
+    (void)pthread_mutex_unlock(&g_memMutex);
+    return HAL_SUCCESS;
+#else
+    (void)memset_s(stat, sizeof(HcMemStat), 0, sizeof(HcMemStat));
+    return HAL_ERR_NOT_SUPPORTED;
+#endif
+}
+
 uint32_t HcStrlen(const char *str)
 {
     if (str == NULL) {
@@ -16,6 +16,7 @@
 #include "hc_types.h"
 #include <stdlib.h>
 #include <string.h>
+#include "hal_error.h"
 #include "hc_log.h"
 #include "ohos_mem_pool.h"
 
@@ -36,6 +37,19 @@ void *HcMalloc(uint32_t size, char val)
     return addr;
 }
 
+void *HcMallocNoZero(uint32_t size)
+{
+    if (size == 0) {
+        LOGE("Malloc size is invalid.");
+        return NULL;
+    }
+#if defined(OHOS_MEM)
+    return OhosMalloc(MEM_TYPE_HICHAIN, size);
+#else
+    return malloc(size);
+#endif
+}
+
 void HcFree(void *addr)
 {
     if (addr != NULL) {
@@ -57,3 +71,24 @@ uint32_t HcStrlen(const char *str)
     return p - str - 1;
 }
 
+int32_t HcSetAllocator(const HcAllocator *allocator)
+{
+    /* The memory of mini devices is managed by the system memory pool. */
+    (void)allocator;
+    return HAL_ERR_NOT_SUPPORTED;
+}
+
+HcMemModule HcSetMemModule(HcMemModule module)
+{
+    (void)module;
+    return HC_MEM_MODULE_COMMON;
+}
+
+int32_t HcGetMemStat(HcMemModule module, HcMemStat *stat)
+{
+    (void)module;
+    if (stat != NULL) {
+        (void)memset_s(stat, sizeof(HcMemStat), 0, sizeof(HcMemStat));
+    }
+    return HAL_ERR_NOT_SUPPORTED;
+}
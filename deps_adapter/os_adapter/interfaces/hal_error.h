@@ -36,5 +36,6 @@ enum {
     HAL_ERR_SHORT_BUFFER = -21,
     HAL_ERR_NOT_SUPPORTED = -22,
     HAL_ERR_MBEDTLS = -23,
+    HAL_ERR_KEY_NOT_EXIST = -24,
 };
 #endif
\ No newline at end of file
@@ -16,6 +16,7 @@
 #ifndef HC_TASK_THREAD_H
 #define HC_TASK_THREAD_H
 
+#include "hc_deque.h"
 #include "hc_thread.h"
 #include "hc_vector.h"
 
@@ -28,11 +29,11 @@ typedef struct {
     HcTaskBase* task;
 } HcTaskWrap;
 
-DECLARE_HC_VECTOR(TaskVec, HcTaskWrap)
+DECLARE_HC_DEQUE(TaskDeque, HcTaskWrap)
 
 typedef struct HcTaskThreadT {
     HcThread thread;
-    TaskVec tasks;
+    TaskDeque tasks;
     int32_t (*startThread)(struct HcTaskThreadT* thread);
     void (*pushTask) (struct HcTaskThreadT* thread, HcTaskBase* task);
     void (*clear) (struct HcTaskThreadT* thread);
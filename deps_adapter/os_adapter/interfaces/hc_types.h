@@ -26,10 +26,39 @@
 extern "C" {
 #endif
 
+typedef enum {
+    HC_MEM_MODULE_COMMON = 0,
+    HC_MEM_MODULE_GROUP_MANAGER,
+    HC_MEM_MODULE_GROUP_AUTH,
+    HC_MEM_MODULE_NUM
+} HcMemModule;
+
+typedef struct {
+    uint64_t allocCount; /* number of allocations since the service started */
+    uint64_t curBytes; /* bytes currently allocated */
+    uint64_t peakBytes; /* the highest value curBytes has reached */
+    uint32_t liveCount; /* number of blocks currently allocated */
+} HcMemStat;
+
+/* The backend which HcMalloc gets its memory from, malloc and free by default. */
+typedef struct {
+    void *(*alloc)(size_t size);
+    void (*free)(void *addr);
+} HcAllocator;
+
 void* HcMalloc(uint32_t size, char val);
+/* For buffers which are fully written by the caller right after allocation. */
+void* HcMallocNoZero(uint32_t size);
 void HcFree(void* addr);
 uint32_t HcStrlen(const char *str);
 
+/* Must be called before any memory is allocated, pass NULL to restore the default backend. */
+int32_t HcSetAllocator(const HcAllocator *allocator);
+/* Set the module that the allocations of the current thread are accounted to, return the previous one. */
+HcMemModule HcSetMemModule(HcMemModule module);
+/* Only supported when built with HC_MEM_STAT. */
+int32_t HcGetMemStat(HcMemModule module, HcMemStat *stat);
+
 #ifdef __cplusplus
 }
 #endif
@@ -30,19 +30,37 @@ extern "C" {
 #endif
 
 void DevAuthLogPrint(DevAuthLogLevel level, const char *funName, const char *fmt, ...);
+/* Logs below the level are skipped by the LOG macros before their arguments are evaluated or formatted. */
+void DevAuthSetLogLevel(DevAuthLogLevel level);
+DevAuthLogLevel DevAuthGetLogLevel(void);
+/* Print the pending logs and join the async log writer, the next log starts it again. */
+void DevAuthStopLogWriter(void);
 
 #ifdef __cplusplus
 }
 #endif
 
+/*
+ * Logs below DEV_AUTH_LOG_MIN_LEVEL are removed at compile time, arguments included. The ones below the runtime level
+ * only cost a call to DevAuthGetLogLevel and are never formatted.
+ */
+#ifndef DEV_AUTH_LOG_MIN_LEVEL
+#define DEV_AUTH_LOG_MIN_LEVEL DEV_AUTH_LOG_LEVEL_DEBUG
+#endif
+#define DEV_AUTH_LOG_IS_ENABLED(level) (((level) >= DEV_AUTH_LOG_MIN_LEVEL) && ((level) >= DevAuthGetLogLevel()))
+
 #ifdef HILOG_ENABLE
 
 #include "hilog/log.h"
 
-#define LOGD(fmt, ...) (DevAuthLogPrint(DEV_AUTH_LOG_LEVEL_DEBUG, __FUNCTION__, fmt, ##__VA_ARGS__))
-#define LOGI(fmt, ...) (DevAuthLogPrint(DEV_AUTH_LOG_LEVEL_INFO, __FUNCTION__, fmt, ##__VA_ARGS__))
-#define LOGW(fmt, ...) (DevAuthLogPrint(DEV_AUTH_LOG_LEVEL_WARN, __FUNCTION__, fmt, ##__VA_ARGS__))
-#define LOGE(fmt, ...) (DevAuthLogPrint(DEV_AUTH_LOG_LEVEL_ERROR, __FUNCTION__, fmt, ##__VA_ARGS__))
+#define LOGD(fmt, ...) (DEV_AUTH_LOG_IS_ENABLED(DEV_AUTH_LOG_LEVEL_DEBUG) ? \
+    DevAuthLogPrint(DEV_AUTH_LOG_LEVEL_DEBUG, __FUNCTION__, fmt, ##__VA_ARGS__) : (void)0)
+#define LOGI(fmt, ...) (DEV_AUTH_LOG_IS_ENABLED(DEV_AUTH_LOG_LEVEL_INFO) ? \
+    DevAuthLogPrint(DEV_AUTH_LOG_LEVEL_INFO, __FUNCTION__, fmt, ##__VA_ARGS__) : (void)0)
+#define LOGW(fmt, ...) (DEV_AUTH_LOG_IS_ENABLED(DEV_AUTH_LOG_LEVEL_WARN) ? \
+    DevAuthLogPrint(DEV_AUTH_LOG_LEVEL_WARN, __FUNCTION__, fmt, ##__VA_ARGS__) : (void)0)
+#define LOGE(fmt, ...) (DEV_AUTH_LOG_IS_ENABLED(DEV_AUTH_LOG_LEVEL_ERROR) ? \
+    DevAuthLogPrint(DEV_AUTH_LOG_LEVEL_ERROR, __FUNCTION__, fmt, ##__VA_ARGS__) : (void)0)
 
 #define DEV_AUTH_LOG_DEBUG(buf) HiLogPrint(LOG_CORE, LOG_DEBUG, LOG_DOMAIN, "[DEVAUTH]", "%{public}s", buf)
 #define DEV_AUTH_LOG_INFO(buf) HiLogPrint(LOG_CORE, LOG_INFO, LOG_DOMAIN, "[DEVAUTH]", "%{public}s", buf)
@@ -54,9 +72,18 @@ void DevAuthLogPrint(DevAuthLogLevel level, const char *funName, const char *fmt
 #include <stdio.h>
 #include <stdlib.h>
 
-#define LOGD(fmt, ...) printf("[D][DEVAUTH]%s: " fmt "\n", __FUNCTION__, ##__VA_ARGS__)
-#define LOGI(fmt, ...) printf("[I][DEVAUTH]%s: " fmt "\n", __FUNCTION__, ##__VA_ARGS__)
-#define LOGW(fmt, ...) printf("[W][DEVAUTH]%s: " fmt "\n", __FUNCTION__, ##__VA_ARGS__)
-#define LOGE(fmt, ...) printf("[E][DEVAUTH]%s: " fmt "\n", __FUNCTION__, ##__VA_ARGS__)
+#define LOGD(fmt, ...) (DEV_AUTH_LOG_IS_ENABLED(DEV_AUTH_LOG_LEVEL_DEBUG) ? \
+    (void)printf("[D][DEVAUTH]%s: " fmt "\n", __FUNCTION__, ##__VA_ARGS__) : (void)0)
+#define LOGI(fmt, ...) (DEV_AUTH_LOG_IS_ENABLED(DEV_AUTH_LOG_LEVEL_INFO) ? \
+    (void)printf("[I][DEVAUTH]%s: " fmt "\n", __FUNCTION__, ##__VA_ARGS__) : (void)0)
+#define LOGW(fmt, ...) (DEV_AUTH_LOG_IS_ENABLED(DEV_AUTH_LOG_LEVEL_WARN) ? \
+    (void)printf("[W][DEVAUTH]%s: " fmt "\n", __FUNCTION__, ##__VA_ARGS__) : (void)0)
+#define LOGE(fmt, ...) (DEV_AUTH_LOG_IS_ENABLED(DEV_AUTH_LOG_LEVEL_ERROR) ? \
+    (void)printf("[E][DEVAUTH]%s: " fmt "\n", __FUNCTION__, ##__VA_ARGS__) : (void)0)
+
+#define DEV_AUTH_LOG_DEBUG(buf) (void)printf("[D][DEVAUTH]%s\n", buf)
+#define DEV_AUTH_LOG_INFO(buf) (void)printf("[I][DEVAUTH]%s\n", buf)
+#define DEV_AUTH_LOG_WARN(buf) (void)printf("[W][DEVAUTH]%s\n", buf)
+#define DEV_AUTH_LOG_ERROR(buf) (void)printf("[E][DEVAUTH]%s\n", buf)
 #endif
 #endif
@@ -30,6 +30,11 @@ extern "C" {
 #endif
 
 void DevAuthLogPrint(DevAuthLogLevel level, const char *funName, const char *fmt, ...);
+/* Logs below the level are skipped by the LOG macros before their arguments are evaluated or formatted. */
+void DevAuthSetLogLevel(DevAuthLogLevel level);
+DevAuthLogLevel DevAuthGetLogLevel(void);
+/* Print the pending logs and join the async log writer, the next log starts it again. */
+void DevAuthStopLogWriter(void);
 
 #ifdef __cplusplus
 }
@@ -37,10 +42,23 @@ void DevAuthLogPrint(DevAuthLogLevel level, const char *funName, const char *fmt
 
 #include "log.h"
 
-#define LOGD(fmt, ...) (DevAuthLogPrint(DEV_AUTH_LOG_LEVEL_DEBUG, __FUNCTION__, fmt, ##__VA_ARGS__))
-#define LOGI(fmt, ...) (DevAuthLogPrint(DEV_AUTH_LOG_LEVEL_INFO, __FUNCTION__, fmt, ##__VA_ARGS__))
-#define LOGW(fmt, ...) (DevAuthLogPrint(DEV_AUTH_LOG_LEVEL_WARN, __FUNCTION__, fmt, ##__VA_ARGS__))
-#define LOGE(fmt, ...) (DevAuthLogPrint(DEV_AUTH_LOG_LEVEL_ERROR, __FUNCTION__, fmt, ##__VA_ARGS__))
+/*
+ * Logs below DEV_AUTH_LOG_MIN_LEVEL are removed at compile time, arguments included. The ones below the runtime level
+ * only cost a call to DevAuthGetLogLevel and are never formatted.
+ */
+#ifndef DEV_AUTH_LOG_MIN_LEVEL
+#define DEV_AUTH_LOG_MIN_LEVEL DEV_AUTH_LOG_LEVEL_DEBUG
+#endif
+#define DEV_AUTH_LOG_IS_ENABLED(level) (((level) >= DEV_AUTH_LOG_MIN_LEVEL) && ((level) >= DevAuthGetLogLevel()))
+
+#define LOGD(fmt, ...) (DEV_AUTH_LOG_IS_ENABLED(DEV_AUTH_LOG_LEVEL_DEBUG) ? \
+    DevAuthLogPrint(DEV_AUTH_LOG_LEVEL_DEBUG, __FUNCTION__, fmt, ##__VA_ARGS__) : (void)0)
+#define LOGI(fmt, ...) (DEV_AUTH_LOG_IS_ENABLED(DEV_AUTH_LOG_LEVEL_INFO) ? \
+    DevAuthLogPrint(DEV_AUTH_LOG_LEVEL_INFO, __FUNCTION__, fmt, ##__VA_ARGS__) : (void)0)
+#define LOGW(fmt, ...) (DEV_AUTH_LOG_IS_ENABLED(DEV_AUTH_LOG_LEVEL_WARN) ? \
+    DevAuthLogPrint(DEV_AUTH_LOG_LEVEL_WARN, __FUNCTION__, fmt, ##__VA_ARGS__) : (void)0)
+#define LOGE(fmt, ...) (DEV_AUTH_LOG_IS_ENABLED(DEV_AUTH_LOG_LEVEL_ERROR) ? \
+    DevAuthLogPrint(DEV_AUTH_LOG_LEVEL_ERROR, __FUNCTION__, fmt, ##__VA_ARGS__) : (void)0)
 
 #define DEV_AUTH_LOG_DEBUG(buf) HILOG_DEBUG(HILOG_MODULE_SCY, "%{public}s", buf)
 #define DEV_AUTH_LOG_INFO(buf) HILOG_INFO(HILOG_MODULE_SCY, "%{public}s", buf)
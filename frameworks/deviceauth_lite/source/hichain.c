@@ -853,29 +853,33 @@ static int32_t build_struct_by_receive_data(uint32_t msg_code, const char *paylo
     enum json_object_data_type type, struct message *message);
 static int32_t deserialize_message(const struct uint8_buff *data, struct message *receive)
 {
-    /* message head deserialization */
-    struct pass_through_data *pass_through_data = parse_data((const char *)data->val);
-    if (pass_through_data == NULL) {
+    /* message head deserialization, the payload object is handed to the parsers without re-serializing it */
+    json_handle obj = parse_json((const char *)data->val);
+    if (obj == NULL) {
         LOGE("Parse data failed");
         return HC_BUILD_OBJECT_FAILED;
     }
+    int32_t message_code = get_json_int(obj, FIELD_MESSAGE);
+    json_pobject obj_value = get_json_obj(obj, FIELD_PAYLOAD);
+    if ((message_code == -1) || (obj_value == NULL)) {
+        LOGE("Parse data failed, field is null in message or payload");
+        free_json(obj);
+        return HC_BUILD_OBJECT_FAILED;
+    }
 
 #if (defined(_CUT_EXCHANGE_) || defined(_CUT_EXCHANGE_SERVER_))
-    if (pass_through_data->message_code == EXCHANGE_REQUEST) {
-        free_data(pass_through_data);
-        pass_through_data = NULL;
+    if (message_code == EXCHANGE_REQUEST) {
+        free_json(obj);
         return HC_UNSUPPORT;
     }
 #endif
 
     /* message payload deserialization */
-    int32_t ret = build_struct_by_receive_data(pass_through_data->message_code, pass_through_data->payload_data,
-                                               JSON_STRING_DATA, receive);
+    int32_t ret = build_struct_by_receive_data(message_code, obj_value, JSON_OBJECT_DATA, receive);
     if (ret != HC_OK) {
         LOGE("Build struct by receive data failed, error code is %d", ret);
     }
-    free_data(pass_through_data);
-    pass_through_data = NULL;
+    free_json(obj);
     return ret;
 }
 
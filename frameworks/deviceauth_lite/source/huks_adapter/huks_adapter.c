@@ -175,6 +175,58 @@ static int32_t construct_param_set(struct HksParamSet **out, const struct HksPar
     return ERROR_CODE_SUCCESS;
 }
 
+static const struct HksParam g_sha256_param[] = {
+    {
+        .tag = HKS_TAG_DIGEST,
+        .uint32Param = HKS_DIGEST_SHA256
+    }
+};
+
+static const struct HksParam g_hmac_param[] = {
+    {
+        .tag = HKS_TAG_PURPOSE,
+        .uint32Param = HKS_KEY_PURPOSE_MAC
+    }, {
+        .tag = HKS_TAG_DIGEST,
+        .uint32Param = HKS_DIGEST_SHA256
+    }, {
+        .tag = HKS_TAG_IS_KEY_ALIAS, /* temporary key, is_key_alias is set to false determined using REE for MAC */
+        .boolParam = false
+    }
+};
+
+/* built once in key_info_init, and only read by sha256 and compute_hmac afterwards */
+static struct HksParamSet *g_sha256_param_set = NULL;
+static struct HksParamSet *g_hmac_param_set = NULL;
+
+static int32_t get_const_param_set(struct HksParamSet *cached, const struct HksParam *in_param,
+    const uint32_t in_param_num, struct HksParamSet **out)
+{
+    if (cached != NULL) {
+        *out = cached;
+        return ERROR_CODE_SUCCESS;
+    }
+    return construct_param_set(out, in_param, in_param_num);
+}
+
+static void release_const_param_set(struct HksParamSet *cached, struct HksParamSet **param_set)
+{
+    if (*param_set != cached) {
+        HksFreeParamSet(param_set);
+    }
+}
+
+static void build_const_param_sets(void)
+{
+    /* a failed build leaves the cache empty, and the param set is then built on each call */
+    if (g_sha256_param_set == NULL) {
+        (void)construct_param_set(&g_sha256_param_set, g_sha256_param, array_size(g_sha256_param));
+    }
+    if (g_hmac_param_set == NULL) {
+        (void)construct_param_set(&g_hmac_param_set, g_hmac_param, array_size(g_hmac_param));
+    }
+}
+
 static struct sha256_value sha256(const struct uint8_buff *message)
 {
     struct sha256_value sha256_value;
@@ -191,13 +243,7 @@ static struct sha256_value sha256(const struct uint8_buff *message)
     hash.size = HC_SHA256_LEN;
 
     struct HksParamSet *param_set = NULL;
-    struct HksParam digest_param[] = {
-        {
-            .tag = HKS_TAG_DIGEST,
-            .uint32Param = HKS_DIGEST_SHA256
-        }
-    };
-    int32_t status = construct_param_set(&param_set, digest_param, array_size(digest_param));
+    int32_t status = get_const_param_set(g_sha256_param_set, g_sha256_param, array_size(g_sha256_param), &param_set);
     if (status != ERROR_CODE_SUCCESS) {
         safe_free(hash.data);
         LOGE("construct param set in the sha256 failed, status=%d", status);
@@ -212,7 +258,7 @@ static struct sha256_value sha256(const struct uint8_buff *message)
         sha256_value.length = 0;
     }
     safe_free(hash.data);
-    HksFreeParamSet(&param_set);
+    release_const_param_set(g_sha256_param_set, &param_set);
     return sha256_value;
 }
 
@@ -382,20 +428,7 @@ int32_t compute_hmac(struct var_buffer *key, const struct uint8_buff *message, s
     struct HksBlob src_data = { message->length, message->val };
     struct HksBlob output = { HC_HMAC_LEN, out_hmac->hmac };
     struct HksParamSet *param_set = NULL;
-
-    struct HksParam hmac_param[] = {
-        {
-            .tag = HKS_TAG_PURPOSE,
-            .uint32Param = HKS_KEY_PURPOSE_MAC
-        }, {
-            .tag = HKS_TAG_DIGEST,
-            .uint32Param = HKS_DIGEST_SHA256
-        }, {
-            .tag = HKS_TAG_IS_KEY_ALIAS, /* temporary key, is_key_alias is set to false determined using REE for MAC */
-            .boolParam = false
-        }
-    };
-    int32_t status = construct_param_set(&param_set, hmac_param, array_size(hmac_param));
+    int32_t status = get_const_param_set(g_hmac_param_set, g_hmac_param, array_size(g_hmac_param), &param_set);
     if (status != ERROR_CODE_SUCCESS) {
         LOGE("construct HMAC param set failed, status=%d", status);
         return ERROR_CODE_BUILD_PARAM_SET;
@@ -403,13 +436,12 @@ int32_t compute_hmac(struct var_buffer *key, const struct uint8_buff *message, s
 
     /* make hmac */
     status = HksMac(&hks_key, param_set, &src_data, &output);
+    release_const_param_set(g_hmac_param_set, &param_set);
     if (status != ERROR_CODE_SUCCESS) {
         LOGE("Huks hmac failed, status: %d", status);
-        HksFreeParamSet(&param_set);
         return ERROR_CODE_FAILED;
     }
     out_hmac->length = output.size;
-    HksFreeParamSet(&param_set);
 
     return ERROR_CODE_SUCCESS;
 }
@@ -961,6 +993,83 @@ int32_t export_lt_public_key(struct hc_key_alias *key_alias, struct ltpk *out_pu
     return ERROR_CODE_SUCCESS;
 }
 
+/*
+ * In-memory copy of the key role and auth id of every imported long-term public key, built from a full
+ * keystore scan in key_info_init and kept up to date by import_lt_public_key and delete_key. If it is not
+ * valid, the lookups below fall back to huks.
+ */
+struct lt_public_key_index_entry {
+    struct hc_key_alias alias;
+    struct huks_key_type key_type;
+    struct hc_auth_id auth_id;
+};
+
+static struct lt_public_key_index_entry g_lt_public_key_index[HC_PUB_KEY_ALIAS_MAX_NUM];
+static uint32_t g_lt_public_key_count = 0;
+static bool g_lt_public_key_index_valid = false;
+
+static void decode_key_role(uint32_t key_role, struct huks_key_type *out_key_type)
+{
+    union huks_key_type_union key_type_union;
+    key_type_union.key_type = key_role;
+    out_key_type->user_type = key_type_union.type_struct.user_type;
+    out_key_type->pair_type = key_type_union.type_struct.pair_type;
+    out_key_type->reserved1 = key_type_union.type_struct.reserved1;
+    out_key_type->reserved2 = key_type_union.type_struct.reserved2;
+}
+
+static struct lt_public_key_index_entry *find_lt_public_key_index(const struct hc_key_alias *key_alias)
+{
+    if (!g_lt_public_key_index_valid) {
+        return NULL;
+    }
+    for (uint32_t i = 0; i < g_lt_public_key_count; i++) {
+        struct lt_public_key_index_entry *entry = &g_lt_public_key_index[i];
+        if ((entry->alias.length == key_alias->length) &&
+            (memcmp(entry->alias.key_alias, key_alias->key_alias, key_alias->length) == 0)) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+static void add_lt_public_key_index(const uint8_t *alias, uint32_t alias_len, const struct huks_key_type *key_type,
+    const struct hc_auth_id *auth_id)
+{
+    if (!g_lt_public_key_index_valid) {
+        return;
+    }
+    struct hc_key_alias key_alias = { alias_len, { 0 } };
+    if (memcpy_s(key_alias.key_alias, HC_KEY_ALIAS_MAX_LEN, alias, alias_len) != EOK) {
+        g_lt_public_key_index_valid = false;
+        return;
+    }
+    struct lt_public_key_index_entry *entry = find_lt_public_key_index(&key_alias);
+    if (entry == NULL) {
+        if (g_lt_public_key_count >= HC_PUB_KEY_ALIAS_MAX_NUM) {
+            LOGI("Long-term public key index is full, fall back to keystore scans");
+            g_lt_public_key_index_valid = false;
+            return;
+        }
+        entry = &g_lt_public_key_index[g_lt_public_key_count++];
+    }
+    entry->alias = key_alias;
+    entry->key_type = *key_type;
+    entry->auth_id = *auth_id;
+}
+
+static void remove_lt_public_key_index(const struct hc_key_alias *key_alias)
+{
+    struct lt_public_key_index_entry *entry = find_lt_public_key_index(key_alias);
+    if (entry == NULL) {
+        return;
+    }
+    g_lt_public_key_count--;
+    *entry = g_lt_public_key_index[g_lt_public_key_count];
+    (void)memset_s(&g_lt_public_key_index[g_lt_public_key_count], sizeof(struct lt_public_key_index_entry),
+        0, sizeof(struct lt_public_key_index_entry));
+}
+
 int32_t delete_key(struct hc_key_alias *key_alias)
 {
     check_ptr_return_val(key_alias, HC_INPUT_ERROR);
@@ -973,6 +1082,7 @@ int32_t delete_key(struct hc_key_alias *key_alias)
         LOGE("Delete key failed, status=%d", hks_status);
         return ERROR_CODE_FAILED;
     }
+    remove_lt_public_key_index(key_alias);
 
     return ERROR_CODE_SUCCESS;
 }
@@ -993,18 +1103,24 @@ int32_t delete_lt_public_key(struct hc_key_alias *key_alias)
     return hks_status;
 }
 
-static int32_t init_import_lt_public_key_param_set(struct HksParamSet **param_set,
-    const int32_t user_type, const int32_t pair_type, struct hc_auth_id *auth_id)
+static uint32_t get_lt_public_key_role(const int32_t user_type, const int32_t pair_type)
 {
-#if !(defined(_SUPPORT_SEC_CLONE_) || defined(_SUPPORT_SEC_CLONE_SERVER_))
+#if (defined(_SUPPORT_SEC_CLONE_) || defined(_SUPPORT_SEC_CLONE_SERVER_))
+    (void)pair_type;
+    return (uint32_t)user_type;
+#else
     union huks_key_type_union huks_key_type;
     huks_key_type.type_struct.user_type = (uint8_t)user_type;
     huks_key_type.type_struct.pair_type = (uint8_t)pair_type;
     huks_key_type.type_struct.reserved1 = (uint8_t)0;
     huks_key_type.type_struct.reserved2 = (uint8_t)0;
+    return huks_key_type.key_type;
 #endif
+}
 
-    (void)pair_type;
+static int32_t init_import_lt_public_key_param_set(struct HksParamSet **param_set,
+    const int32_t user_type, const int32_t pair_type, struct hc_auth_id *auth_id)
+{
     struct HksParam key_param[] = {
         {
             .tag = HKS_TAG_ALGORITHM,
@@ -1025,23 +1141,13 @@ static int32_t init_import_lt_public_key_param_set(struct HksParamSet **param_se
             .tag = HKS_TAG_IS_ALLOWED_WRAP,
             .boolParam = true
         },
-#if (defined(_SUPPORT_SEC_CLONE_) || defined(_SUPPORT_SEC_CLONE_SERVER_))
-        {
-            .tag = HKS_TAG_PURPOSE,
-            .uint32Param = HKS_KEY_PURPOSE_VERIFY
-        }, {
-            .tag = HKS_TAG_KEY_ROLE,
-            .uint32Param = user_type
-        }
-#else
         {
             .tag = HKS_TAG_PURPOSE,
             .uint32Param = HKS_KEY_PURPOSE_VERIFY
         }, {
             .tag = HKS_TAG_KEY_ROLE,
-            .uint32Param = (uint32_t)huks_key_type.key_type
+            .uint32Param = get_lt_public_key_role(user_type, pair_type)
         }
-#endif
     };
 
     return construct_param_set(param_set, key_param, array_size(key_param));
@@ -1080,6 +1186,11 @@ int32_t import_lt_public_key(struct hc_key_alias *key_alias, struct ltpk *peer_p
     }
 
     status = HksImportKey(&key_alias_blob, param_set, &ltpk_key_blob);
+    if (status == HKS_SUCCESS) {
+        struct huks_key_type key_type;
+        decode_key_role(get_lt_public_key_role(user_type, pair_type), &key_type);
+        add_lt_public_key_index(key_alias_blob.data, key_alias_blob.size, &key_type, auth_id);
+    }
 
     HksFreeParamSet(&param_set);
     return status;
@@ -1089,6 +1200,9 @@ int32_t check_lt_public_key_exist(struct hc_key_alias *key_alias)
 {
     check_ptr_return_val(key_alias, HC_INPUT_ERROR);
     check_num_return_val(key_alias->length, HC_INPUT_ERROR);
+    if (find_lt_public_key_index(key_alias) != NULL) {
+        return ERROR_CODE_SUCCESS;
+    }
     struct HksBlob key_alias_blob = convert_to_blob_from_hc_key_alias(key_alias);
     int32_t hks_status = HksKeyExist(&key_alias_blob, NULL);
     if (hks_status == 0) {
@@ -1145,19 +1259,13 @@ static int32_t init_key_info_list(struct HksKeyInfo *key_info_list, int32_t len)
 static int32_t inner_get_lt_info_by_key_info(struct HksKeyInfo *key_info,
     struct huks_key_type *out_key_type, struct hc_auth_id *out_auth_id)
 {
-    union huks_key_type_union key_type_union;
     struct HksParam *key_role = NULL;
     int32_t status = HksGetParam(key_info->paramSet, HKS_TAG_KEY_ROLE, &key_role);
     if (status != ERROR_CODE_SUCCESS) {
         LOGE("get key role from param set failed, status:%d", status);
         return ERROR_CODE_FAILED;
     }
-
-    key_type_union.key_type = key_role->uint32Param;
-    out_key_type->user_type = key_type_union.type_struct.user_type;
-    out_key_type->pair_type = key_type_union.type_struct.pair_type;
-    out_key_type->reserved1 = key_type_union.type_struct.reserved1;
-    out_key_type->reserved2 = key_type_union.type_struct.reserved2;
+    decode_key_role(key_role->uint32Param, out_key_type);
 
     struct HksParam *auth_id = NULL;
     status = HksGetParam(key_info->paramSet, HKS_TAG_KEY_AUTH_ID, &auth_id);
@@ -1206,12 +1314,7 @@ static int32_t inner_get_lt_info_by_key_alias(struct HksBlob *key_alias,
         goto get_key_info_free;
     }
 
-    union huks_key_type_union key_type_union;
-    key_type_union.key_type = key_role->uint32Param;
-    out_key_type->user_type = key_type_union.type_struct.user_type;
-    out_key_type->pair_type = key_type_union.type_struct.pair_type;
-    out_key_type->reserved1 = key_type_union.type_struct.reserved1;
-    out_key_type->reserved2 = key_type_union.type_struct.reserved2;
+    decode_key_role(key_role->uint32Param, out_key_type);
 
     struct HksParam *auth_id = NULL;
     status = HksGetParam(output_param_set, HKS_TAG_KEY_AUTH_ID, &auth_id);
@@ -1237,6 +1340,12 @@ int32_t get_lt_key_info(struct hc_key_alias *alias, struct huks_key_type *out_ke
     check_ptr_return_val(out_key_type, HC_INPUT_ERROR);
     check_ptr_return_val(out_auth_id, HC_INPUT_ERROR);
 
+    const struct lt_public_key_index_entry *entry = find_lt_public_key_index(alias);
+    if (entry != NULL) {
+        *out_key_type = entry->key_type;
+        *out_auth_id = entry->auth_id;
+        return ERROR_CODE_SUCCESS;
+    }
     struct HksBlob alias_blob = convert_to_blob_from_hc_key_alias(alias);
     return inner_get_lt_info_by_key_alias(&alias_blob, out_key_type, out_auth_id);
 }
@@ -1246,20 +1355,24 @@ int32_t check_key_alias_is_owner(struct hc_key_alias *key_alias)
     check_ptr_return_val(key_alias, HC_INPUT_ERROR);
     check_num_return_val(key_alias->length, HC_INPUT_ERROR);
 
-    int32_t error_code = check_lt_public_key_exist(key_alias);
-    if (error_code != ERROR_CODE_SUCCESS) {
-        LOGE("Key is not exist");
-        return error_code;
-    }
-
     struct huks_key_type key_type;
-    struct hc_auth_id auth_id;
+    const struct lt_public_key_index_entry *entry = find_lt_public_key_index(key_alias);
+    if (entry != NULL) {
+        key_type = entry->key_type;
+    } else {
+        int32_t error_code = check_lt_public_key_exist(key_alias);
+        if (error_code != ERROR_CODE_SUCCESS) {
+            LOGE("Key is not exist");
+            return error_code;
+        }
 
-    struct HksBlob key_alias_blob = convert_to_blob_from_hc_key_alias(key_alias);
-    error_code = inner_get_lt_info_by_key_alias(&key_alias_blob, &key_type, &auth_id);
-    if (error_code != ERROR_CODE_SUCCESS) {
-        LOGE("Get key info failed");
-        return error_code;
+        struct hc_auth_id auth_id;
+        struct HksBlob key_alias_blob = convert_to_blob_from_hc_key_alias(key_alias);
+        error_code = inner_get_lt_info_by_key_alias(&key_alias_blob, &key_type, &auth_id);
+        if (error_code != ERROR_CODE_SUCCESS) {
+            LOGE("Get key info failed");
+            return error_code;
+        }
     }
 
     if (key_type.user_type != (uint8_t)HC_USER_TYPE_CONTROLLER) {
@@ -1272,6 +1385,17 @@ int32_t check_key_alias_is_owner(struct hc_key_alias *key_alias)
     }
 }
 
+static bool is_lt_public_key_matched(const struct huks_key_type *key_type, uint8_t user_type, uint8_t pair_type)
+{
+    if (key_type->user_type != user_type) {
+        return false;
+    }
+    if ((user_type == (uint8_t)HC_USER_TYPE_CONTROLLER) && (key_type->pair_type != pair_type)) {
+        return false;
+    }
+    return true;
+}
+
 static uint32_t load_lt_public_key_list(const struct hc_auth_id *owner_id, int32_t trust_user_type,
     struct HksKeyInfo *key_info_list, uint32_t list_count, struct hc_auth_id *out_auth_list)
 {
@@ -1299,14 +1423,9 @@ static uint32_t load_lt_public_key_list(const struct hc_auth_id *owner_id, int32
         if (err_code != ERROR_CODE_SUCCESS) {
             continue;
         }
-        if (key_type.user_type != user_type) {
+        if (!is_lt_public_key_matched(&key_type, user_type, pair_type)) {
             continue;
         }
-        if (user_type == (uint8_t)HC_USER_TYPE_CONTROLLER) {
-            if (key_type.pair_type != pair_type) {
-                continue;
-            }
-        }
         if (memcpy_s(out_auth_list[effect_count].auth_id, HC_AUTH_ID_BUFF_LEN,
                      auth_id.auth_id, auth_id.length) != EOK) {
             LOGE("Copy from temp hc_auth_id to out_auth_list failed");
@@ -1318,43 +1437,109 @@ static uint32_t load_lt_public_key_list(const struct hc_auth_id *owner_id, int32
     return effect_count;
 }
 
-int32_t get_lt_public_key_list(const struct hc_auth_id *owner_auth_id, int32_t trust_user_type,
-    struct hc_auth_id *out_auth_list, uint32_t *out_count)
+static uint32_t load_lt_public_key_list_from_index(const struct hc_auth_id *owner_id, int32_t trust_user_type,
+    struct hc_auth_id *out_auth_list)
 {
-    check_ptr_return_val(out_auth_list, HC_INPUT_ERROR);
-    check_ptr_return_val(out_count, HC_INPUT_ERROR);
+    uint8_t pair_type = owner_id == NULL ? (uint8_t)HC_PAIR_TYPE_BIND : (uint8_t)HC_PAIR_TYPE_AUTH;
+    uint8_t user_type = (uint8_t)trust_user_type;
+    uint32_t effect_count = 0;
 
-    int32_t error_code = ERROR_CODE_SUCCESS;
-    struct HksKeyInfo key_info_list[HC_PUB_KEY_ALIAS_MAX_NUM];
+    if ((trust_user_type < 0) || (trust_user_type >= HC_MAX_KEY_TYPE_NUM)) {
+        return effect_count;
+    }
+    for (uint32_t i = 0; i < g_lt_public_key_count; i++) {
+        if (is_lt_public_key_matched(&g_lt_public_key_index[i].key_type, user_type, pair_type)) {
+            out_auth_list[effect_count] = g_lt_public_key_index[i].auth_id;
+            effect_count++;
+        }
+    }
+    return effect_count;
+}
+
+/* key_info_list holds HC_PUB_KEY_ALIAS_MAX_NUM entries, which are released by free_key_info_list */
+static int32_t get_key_info_list(struct HksKeyInfo *key_info_list, uint32_t *list_count)
+{
     int32_t status = init_key_info_list(key_info_list, HC_PUB_KEY_ALIAS_MAX_NUM);
     if (status != ERROR_CODE_SUCCESS) {
         LOGE("Init key info list failed, status=%d", status);
-        error_code = ERROR_CODE_FAILED;
-        goto exit;
+        return ERROR_CODE_FAILED;
     }
 
-    uint32_t list_count = HC_PUB_KEY_ALIAS_MAX_NUM;
-    status = HksGetKeyInfoList(NULL, key_info_list, &list_count);
+    *list_count = HC_PUB_KEY_ALIAS_MAX_NUM;
+    status = HksGetKeyInfoList(NULL, key_info_list, list_count);
     if (status != ERROR_CODE_SUCCESS) {
         LOGE("Huks get pub key info list failed, status=%d", status);
-        error_code = ERROR_CODE_FAILED;
-        goto exit;
+        return ERROR_CODE_FAILED;
     }
+    return ERROR_CODE_SUCCESS;
+}
 
-    /* filter with trust_user_type */
-    uint32_t effect_count = load_lt_public_key_list(owner_auth_id, trust_user_type, key_info_list,
-                                                    list_count, out_auth_list);
-    /* output param */
-    *out_count = effect_count;
-
-exit:
+static void free_key_info_list(struct HksKeyInfo *key_info_list)
+{
     for (int32_t i = 0; i < HC_PUB_KEY_ALIAS_MAX_NUM; ++i) {
         safe_free(key_info_list[i].alias.data);
         safe_free(key_info_list[i].paramSet);
     }
+}
+
+int32_t get_lt_public_key_list(const struct hc_auth_id *owner_auth_id, int32_t trust_user_type,
+    struct hc_auth_id *out_auth_list, uint32_t *out_count)
+{
+    check_ptr_return_val(out_auth_list, HC_INPUT_ERROR);
+    check_ptr_return_val(out_count, HC_INPUT_ERROR);
+
+    if (g_lt_public_key_index_valid) {
+        *out_count = load_lt_public_key_list_from_index(owner_auth_id, trust_user_type, out_auth_list);
+        return ERROR_CODE_SUCCESS;
+    }
+
+    struct HksKeyInfo key_info_list[HC_PUB_KEY_ALIAS_MAX_NUM];
+    uint32_t list_count = 0;
+    int32_t error_code = get_key_info_list(key_info_list, &list_count);
+    if (error_code == ERROR_CODE_SUCCESS) {
+        /* filter with trust_user_type */
+        *out_count = load_lt_public_key_list(owner_auth_id, trust_user_type, key_info_list, list_count,
+                                             out_auth_list);
+    }
+    free_key_info_list(key_info_list);
     return error_code;
 }
 
+static void build_lt_public_key_index(void)
+{
+    g_lt_public_key_count = 0;
+    g_lt_public_key_index_valid = false;
+    struct HksKeyInfo key_info_list[HC_PUB_KEY_ALIAS_MAX_NUM];
+    uint32_t list_count = 0;
+    /* a full list may have left keys out, then the index can not stand in for the scan */
+    if ((get_key_info_list(key_info_list, &list_count) != ERROR_CODE_SUCCESS) ||
+        (list_count >= HC_PUB_KEY_ALIAS_MAX_NUM)) {
+        free_key_info_list(key_info_list);
+        return;
+    }
+
+    g_lt_public_key_index_valid = true;
+    for (uint32_t i = 0; (i < list_count) && g_lt_public_key_index_valid; i++) {
+        struct HksParam *key_flag_param = NULL;
+        if (HksGetParam(key_info_list[i].paramSet, HKS_TAG_KEY_FLAG, &key_flag_param) != ERROR_CODE_SUCCESS) {
+            g_lt_public_key_index_valid = false;
+            break;
+        }
+        if (key_flag_param->uint32Param == HKS_KEY_FLAG_GENERATE_KEY) {
+            continue;
+        }
+        struct huks_key_type key_type;
+        struct hc_auth_id auth_id;
+        if (inner_get_lt_info_by_key_info(&key_info_list[i], &key_type, &auth_id) != ERROR_CODE_SUCCESS) {
+            continue;
+        }
+        add_lt_public_key_index(key_info_list[i].alias.data, key_info_list[i].alias.size, &key_type, &auth_id);
+    }
+    free_key_info_list(key_info_list);
+    LOGI("Long-term public key index built, valid: %d, count: %u", g_lt_public_key_index_valid,
+        g_lt_public_key_count);
+}
+
 static int32_t gen_sign_key_param_set(struct HksParamSet **param_set)
 {
     struct HksParam params[] = {
@@ -1635,6 +1820,8 @@ int32_t key_info_init(void)
 {
     int32_t ret = HksInitialize();
     if (ret == HKS_SUCCESS) {
+        build_const_param_sets();
+        build_lt_public_key_index();
         return ERROR_CODE_SUCCESS;
     }
 
@@ -1656,6 +1843,8 @@ int32_t key_info_init(void)
         LOGE("Hks: Init hks failed, ret:%d", ret);
         return ERROR_CODE_FAILED;
     }
+    build_const_param_sets();
+    build_lt_public_key_index();
     return ERROR_CODE_SUCCESS;
 }
 
@@ -42,16 +42,8 @@ extern "C" {
     }
 
 
-struct pass_through_data {
-    uint32_t message_code;
-    void *payload_data;
-};
-
 uint32_t parse_header(const char *data);
 
-struct pass_through_data *parse_data(const char *data);
-void free_data(struct pass_through_data *data);
-
 void *parse_payload(const char *payload, enum json_object_data_type data_type);
 void free_payload(char *data, enum json_object_data_type data_type);
 
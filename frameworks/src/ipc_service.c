@@ -23,6 +23,8 @@
 #include "hc_thread.h"
 #include "ipc_adapt.h"
 #include "ipc_sdk.h"
+#include "permission_adapter.h"
+#include "permission_cache.h"
 #include "securec.h"
 
 #ifdef __cplusplus
@@ -1091,14 +1093,19 @@ int32_t main(int32_t argc, char const *argv[])
     ret = MainRescInit();
     if (ret != HC_SUCCESS) {
         DestroyDeviceAuthService();
+        ClearPermissionCache();
         LOGE("device auth service main, init work failed");
         return 1;
     }
+    /* Registered before serving, so that no decision cached for a caller misses a change. */
+    (void)RegisterPermissionChangeCallback();
 
     ret = AddDevAuthServiceToManager(&serviceCtx);
     if (ret != HC_SUCCESS) {
         DeMainRescInit(&serviceCtx);
         DestroyDeviceAuthService();
+        UnregisterPermissionChangeCallback();
+        ClearPermissionCache();
         serviceCtx = 0x0;
         LOGE("device auth service main, AddDevAuthServiceToManager failed, ret %d", ret);
         return 1;
@@ -1109,6 +1116,7 @@ int32_t main(int32_t argc, char const *argv[])
     InitHcCond(&cond, NULL);
     cond.wait(&cond);
     DestroyHcCond(&cond);
+    UnregisterPermissionChangeCallback();
     return 0;
 }
 
@@ -29,9 +29,22 @@ typedef enum {
     REQUEST_SIGNATURE = 6,
 } CredentialCode;
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 int32_t CheckAccountMsgRepeatability(const CJson *in);
 bool IsAccountSupported(void);
 AuthModuleBase *CreateAccountModule(void);
 int32_t ProcessAccountCredentials(int32_t osAccountId, int32_t opCode, CJson *in, CJson *out);
+/*
+ * Drop the asymmetric and symmetric tokens of a removed os account together with their files. Like DropOsAccountDb,
+ * a request of the account still queued recreates its token cache and may save the files again.
+ */
+void DropOsAccountCredentials(int32_t osAccountId);
+
+#ifdef __cplusplus
+}
+#endif
 
 #endif
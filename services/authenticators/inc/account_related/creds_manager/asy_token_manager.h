@@ -55,6 +55,8 @@ AccountAuthTokenManager *GetAccountAuthTokenManager(void);
 
 void InitTokenManager(void);
 void DestroyTokenManager(void);
+/* Forget the tokens of a removed os account, the key pairs are kept since they are bound to userId and deviceId. */
+void DropOsAccountTokens(int32_t osAccountId);
 
 AccountToken *CreateAccountToken(void);
 void DestroyAccountToken(AccountToken *token);
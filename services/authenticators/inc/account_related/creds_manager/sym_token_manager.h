@@ -41,6 +41,8 @@ SymTokenManager *GetSymTokenManager(void);
 
 void InitSymTokenManager(void);
 void DestroySymTokenManager(void);
+/* Forget the tokens of a removed os account, the auth code keys are kept since they are bound to userId. */
+void DropOsAccountSymTokens(int32_t osAccountId);
 
 SymTokenVec CreateSymTokenVec(void);
 void ClearSymTokenVec(SymTokenVec *vec);
@@ -23,6 +23,8 @@
 #define STEP_ONE 1
 #define STEP_TWO 2
 #define STEP_THREE 3
+/* The pake v1 server answers a valid resumption offer with this step instead of STEP_ONE. */
+#define STEP_RESUME 4
 #define MIN_PIN_LEN 4
 #define MAX_PIN_LEN 1024
 #define MIN_OUTPUT_KEY_LEN 16
@@ -17,9 +17,12 @@
 #define PAKE_V1_CLIENT_PROTOCOL_TASK_H
 
 #include "pake_base_cur_task.h"
+#include "pake_v1_resume.h"
 
 typedef struct {
     AsyBaseCurTask taskBase;
+    bool isResumeOffered;
+    ResumeTicket resumeTicket;
 } PakeV1ProtocolClientTask;
 
 AsyBaseCurTask *CreatePakeV1ProtocolClientTask(void);
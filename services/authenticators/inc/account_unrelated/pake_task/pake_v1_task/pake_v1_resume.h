@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PAKE_V1_RESUME_H
+#define PAKE_V1_RESUME_H
+
+#include "pake_base_cur_task.h"
+
+#define RESUME_SECRET_LEN 32
+#define RESUME_TICKET_ID_LEN 16
+
+typedef struct {
+    uint8_t secret[RESUME_SECRET_LEN];
+    uint8_t ticketId[RESUME_TICKET_ID_LEN];
+    int64_t expireTime;
+} ResumeTicket;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * After a successful pake v1 authentication both sides keep a resumption secret for the peer, keyed by
+ * pkgName, serviceType and peer authId. The next authentication of the pair can then finish in one round trip:
+ * the client offers the ticket id with a fresh nonce and an hmac, the server answers with its own nonce and hmac
+ * and both derive the session key from the secret and the nonces. The secret rotates on every use and expires
+ * RESUME_TICKET_LIFETIME seconds after the full handshake that created it. A peer that can't resume simply
+ * ignores the offer and the full handshake runs.
+ */
+int32_t InitPakeV1ResumeCache(void);
+void DestroyPakeV1ResumeCache(void);
+
+/* Called after a full authentication, failures are logged only. */
+void SavePakeV1ResumeTicket(const PakeParams *params);
+
+/* A NULL authIdPeer revokes the tickets of all peers of the service. */
+void RevokePakeV1ResumeTickets(const char *pkgName, const char *serviceType, const Uint8Buff *authIdPeer);
+
+/* Client: adds the offer to the request payload, returns HC_SUCCESS only if a ticket is offered. */
+int32_t AddPakeV1ResumeOffer(PakeParams *params, ResumeTicket *ticket, CJson *payload);
+/* Client: verifies the server's answer to the offer and fills the session key. */
+int32_t ClientFinishPakeV1Resume(PakeParams *params, const ResumeTicket *ticket, const CJson *in);
+
+/* Server: accepts the offer in the request, fills the session key and packages the answer into payload. */
+int32_t ServerFinishPakeV1Resume(PakeParams *params, const CJson *in, CJson *payload);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -207,6 +207,12 @@ bool IsAccountSupported(void)
     return true;
 }
 
+void DropOsAccountCredentials(int32_t osAccountId)
+{
+    DropOsAccountTokens(osAccountId);
+    DropOsAccountSymTokens(osAccountId);
+}
+
 int32_t ProcessAccountCredentials(int32_t osAccountId, int32_t opCode, CJson *in, CJson *out)
 {
     if (in == NULL) {
@@ -209,10 +209,10 @@ static int32_t SendFinalToOut(PakeV2AuthClientTask *task, CJson *out)
     GOTO_IF_ERR(AddStringToJson(sendToSelf, FIELD_DEV_ID, (const char *)task->params.devIdPeer.val));
     GOTO_IF_ERR(AddObjToJson(out, FIELD_SEND_TO_SELF, sendToSelf));
     FreeJson(sendToSelf);
-    FreeAndCleanKey(&task->params.pakeParams.sessionKey);
+    CleanArenaParam(&task->params.pakeParams.sessionKey);
     return HC_SUCCESS;
 ERR:
-    FreeAndCleanKey(&task->params.pakeParams.sessionKey);
+    CleanArenaParam(&task->params.pakeParams.sessionKey);
     FreeJson(sendToSelf);
     LOGE("SendFinalToOut failed");
     return HC_ERR_AUTH_INTERNAL;
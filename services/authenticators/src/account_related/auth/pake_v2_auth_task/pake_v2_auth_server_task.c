@@ -221,14 +221,14 @@ static int32_t SendFinalToOut(PakeV2AuthServerTask *task, CJson *out)
     FreeJson(sendToPeer);
     FreeJson(sendToSelf);
     FreeJson(sendToPeerData);
-    FreeAndCleanKey(&task->params.pakeParams.sessionKey);
+    CleanArenaParam(&task->params.pakeParams.sessionKey);
     return HC_SUCCESS;
 ERR:
     LOGE("Server send final failed");
     FreeJson(sendToPeer);
     FreeJson(sendToSelf);
     FreeJson(sendToPeerData);
-    FreeAndCleanKey(&task->params.pakeParams.sessionKey);
+    CleanArenaParam(&task->params.pakeParams.sessionKey);
     return HC_ERR_AUTH_INTERNAL;
 }
 
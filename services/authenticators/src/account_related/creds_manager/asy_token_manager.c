@@ -154,6 +154,7 @@ static int32_t CreateTokensFromJson(CJson *tokensJson, AccountTokenVec *vec)
         LOGE("No token found.");
         return HC_ERR_JSON_GET;
     }
+    (void)vec->reserve(vec, (uint32_t)tokenNum);
     int32_t ret;
     for (int32_t i = 0; i < tokenNum; i++) {
         CJson *tokenJson = GetItemFromArray(tokensJson, i);
@@ -1295,6 +1296,35 @@ void DestroyAccountToken(AccountToken *token)
     HcFree(token);
 }
 
+void DropOsAccountTokens(int32_t osAccountId)
+{
+    if (g_accountDbMutex == NULL) {
+        return;
+    }
+    char tokenPath[MAX_DB_PATH_LEN] = { 0 };
+    if (!GetTokenPath(osAccountId, tokenPath, MAX_DB_PATH_LEN)) {
+        LOGE("Failed to get token path!");
+        return;
+    }
+    OsAccountTokenInfo dropInfo;
+    bool isDropped = false;
+    g_accountDbMutex->lock(g_accountDbMutex);
+    uint32_t index;
+    OsAccountTokenInfo *info = NULL;
+    FOR_EACH_HC_VECTOR(g_accountTokenDb, index, info) {
+        if (info->osAccountId == osAccountId) {
+            isDropped = HC_VECTOR_SWAP_REMOVE(&g_accountTokenDb, &dropInfo, index);
+            break;
+        }
+    }
+    HcFileRemove(tokenPath);
+    g_accountDbMutex->unlock(g_accountDbMutex);
+    if (isDropped) {
+        ClearAccountTokenVec(&dropInfo.tokens);
+    }
+    LOGI("Drop an os account token database successfully! [Id]: %d", osAccountId);
+}
+
 AccountAuthTokenManager *GetAccountAuthTokenManager(void)
 {
     return &g_asyTokenManager;
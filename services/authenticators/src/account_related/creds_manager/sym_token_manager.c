@@ -115,6 +115,7 @@ static int32_t CreateTokensFromJson(CJson *tokensJson, SymTokenVec *vec)
         LOGE("No token found.");
         return HC_ERR_JSON_GET;
     }
+    (void)vec->reserve(vec, (uint32_t)tokenNum);
     for (int32_t i = 0; i < tokenNum; i++) {
         CJson *tokenJson = GetItemFromArray(symTokensJson, i);
         if (tokenJson == NULL) {
@@ -607,6 +608,35 @@ void ClearSymTokenVec(SymTokenVec *vec)
     DESTROY_HC_VECTOR(SymTokenVec, vec);
 }
 
+void DropOsAccountSymTokens(int32_t osAccountId)
+{
+    if (g_dataMutex == NULL) {
+        return;
+    }
+    char tokenPath[MAX_DB_PATH_LEN] = { 0 };
+    if (!GetTokensFilePath(osAccountId, tokenPath, MAX_DB_PATH_LEN)) {
+        LOGE("Failed to get token path!");
+        return;
+    }
+    OsSymTokensInfo dropInfo;
+    bool isDropped = false;
+    g_dataMutex->lock(g_dataMutex);
+    uint32_t index;
+    OsSymTokensInfo *info = NULL;
+    FOR_EACH_HC_VECTOR(g_SymTokensDb, index, info) {
+        if (info->osAccountId == osAccountId) {
+            isDropped = HC_VECTOR_SWAP_REMOVE(&g_SymTokensDb, &dropInfo, index);
+            break;
+        }
+    }
+    HcFileRemove(tokenPath);
+    g_dataMutex->unlock(g_dataMutex);
+    if (isDropped) {
+        ClearSymTokenVec(&dropInfo.tokens);
+    }
+    LOGI("Drop an os account sym token database successfully! [Id]: %d", osAccountId);
+}
+
 SymTokenManager *GetSymTokenManager(void)
 {
     return &g_symTokenManager;
@@ -43,4 +43,9 @@ int32_t ProcessAccountCredentials(int32_t osAccountId, int32_t credentialOpCode,
     (void)out;
     LOGE("Account credentials manager is not supported.");
     return HC_ERR_NOT_SUPPORT;
+}
+
+void DropOsAccountCredentials(int32_t osAccountId)
+{
+    (void)osAccountId;
 }
\ No newline at end of file
@@ -14,6 +14,7 @@
  */
 
 #include "das_task_common.h"
+#include <pthread.h>
 #include "alg_defs.h"
 #include "alg_loader.h"
 #include "device_auth_defines.h"
@@ -26,6 +27,7 @@
 #define PACKAGE_NAME_MAX_LEN 256
 #define SERVICE_TYPE_MAX_LEN 256
 #define AUTH_ID_MAX_LEN 64
+#define KEY_ALIAS_CACHE_SIZE 16
 
 #define MESSAGE_RETURN 0x8000
 #define MESSAGE_PREFIX 0x0010
@@ -244,56 +246,122 @@ ERR:
     return res;
 }
 
-static int32_t CombineKeyAliasForIso(const Uint8Buff *serviceId, const Uint8Buff *keyType,
-    const Uint8Buff *authId, Uint8Buff *outKeyAlias)
+typedef struct {
+    bool inUse;
+    KeyAliasType keyType;
+    Uint8Buff pkgName;
+    Uint8Buff serviceType;
+    Uint8Buff authId;
+    uint8_t keyAliasHash[SHA256_LEN];
+    uint32_t lastUsed;
+} KeyAliasCacheEntry;
+
+/* Aliases only depend on their inputs, so the recently used ones are kept and never need invalidation. */
+static pthread_mutex_t g_keyAliasCacheMutex = PTHREAD_MUTEX_INITIALIZER;
+static KeyAliasCacheEntry g_keyAliasCache[KEY_ALIAS_CACHE_SIZE];
+static uint32_t g_keyAliasCacheClock = 0;
+
+static bool IsSameBuff(const Uint8Buff *cached, const Uint8Buff *input)
 {
-    if (outKeyAlias->length != SHA256_LEN) {
-        return HC_ERR_INVALID_LEN;
+    return (cached->length == input->length) && (memcmp(cached->val, input->val, input->length) == 0);
+}
+
+static void ClearKeyAliasCacheEntry(KeyAliasCacheEntry *entry)
+{
+    HcFree(entry->pkgName.val);
+    HcFree(entry->serviceType.val);
+    HcFree(entry->authId.val);
+    (void)memset_s(entry, sizeof(KeyAliasCacheEntry), 0, sizeof(KeyAliasCacheEntry));
+}
+
+static bool CopyToCachedBuff(Uint8Buff *cached, const Uint8Buff *input)
+{
+    cached->val = (uint8_t *)HcMalloc(input->length, 0);
+    if (cached->val == NULL) {
+        return false;
     }
-    int32_t res = CombineKeyAlias(serviceId, keyType, authId, outKeyAlias);
-    if (res != HC_SUCCESS) {
-        LOGE("CombineKeyAlias failed.");
-        return res;
+    cached->length = input->length;
+    return memcpy_s(cached->val, cached->length, input->val, input->length) == EOK;
+}
+
+static bool GetCachedKeyAliasHash(const Uint8Buff *pkgName, const Uint8Buff *serviceType, KeyAliasType keyType,
+    const Uint8Buff *authId, uint8_t *keyAliasHash)
+{
+    bool isHit = false;
+    (void)pthread_mutex_lock(&g_keyAliasCacheMutex);
+    for (uint32_t i = 0; i < KEY_ALIAS_CACHE_SIZE; i++) {
+        KeyAliasCacheEntry *entry = &g_keyAliasCache[i];
+        if (!entry->inUse || (entry->keyType != keyType) || !IsSameBuff(&entry->authId, authId) ||
+            !IsSameBuff(&entry->serviceType, serviceType) || !IsSameBuff(&entry->pkgName, pkgName)) {
+            continue;
+        }
+        isHit = (memcpy_s(keyAliasHash, SHA256_LEN, entry->keyAliasHash, SHA256_LEN) == EOK);
+        entry->lastUsed = ++g_keyAliasCacheClock;
+        break;
+    }
+    (void)pthread_mutex_unlock(&g_keyAliasCacheMutex);
+    return isHit;
+}
+
+static void CacheKeyAliasHash(const Uint8Buff *pkgName, const Uint8Buff *serviceType, KeyAliasType keyType,
+    const Uint8Buff *authId, const uint8_t *keyAliasHash)
+{
+    (void)pthread_mutex_lock(&g_keyAliasCacheMutex);
+    KeyAliasCacheEntry *entry = &g_keyAliasCache[0];
+    for (uint32_t i = 0; i < KEY_ALIAS_CACHE_SIZE; i++) {
+        if (!g_keyAliasCache[i].inUse) {
+            entry = &g_keyAliasCache[i];
+            break;
+        }
+        if (g_keyAliasCache[i].lastUsed < entry->lastUsed) {
+            entry = &g_keyAliasCache[i];
+        }
+    }
+    ClearKeyAliasCacheEntry(entry);
+    if (CopyToCachedBuff(&entry->pkgName, pkgName) && CopyToCachedBuff(&entry->serviceType, serviceType) &&
+        CopyToCachedBuff(&entry->authId, authId) &&
+        (memcpy_s(entry->keyAliasHash, SHA256_LEN, keyAliasHash, SHA256_LEN) == EOK)) {
+        entry->inUse = true;
+        entry->keyType = keyType;
+        entry->lastUsed = ++g_keyAliasCacheClock;
+    } else {
+        ClearKeyAliasCacheEntry(entry);
     }
-    return res;
+    (void)pthread_mutex_unlock(&g_keyAliasCacheMutex);
 }
 
-static int32_t CombineKeyAliasForPake(const Uint8Buff *serviceId, const Uint8Buff *keyType,
-    const Uint8Buff *authId, Uint8Buff *outKeyAlias)
+void ClearKeyAliasCache(void)
 {
-    int32_t res;
-    Uint8Buff keyAliasHash = { NULL, SHA256_LEN };
-    char *outKeyAliasHex = NULL;
-    if (outKeyAlias->length != SHA256_LEN * BYTE_TO_HEX_OPER_LENGTH) {
-        res = HC_ERR_INVALID_LEN;
-        goto ERR;
+    (void)pthread_mutex_lock(&g_keyAliasCacheMutex);
+    for (uint32_t i = 0; i < KEY_ALIAS_CACHE_SIZE; i++) {
+        ClearKeyAliasCacheEntry(&g_keyAliasCache[i]);
     }
-    keyAliasHash.val = (uint8_t *)HcMalloc(keyAliasHash.length, 0);
-    if (keyAliasHash.val == NULL) {
-        LOGE("Malloc keyAliasHash failed");
-        res = HC_ERR_ALLOC_MEMORY;
-        goto ERR;
+    g_keyAliasCacheClock = 0;
+    (void)pthread_mutex_unlock(&g_keyAliasCacheMutex);
+}
+
+static int32_t ComputeKeyAliasHash(const Uint8Buff *pkgName, const Uint8Buff *serviceType,
+    const KeyAliasType keyType, const Uint8Buff *authId, Uint8Buff *keyAliasHash)
+{
+    int32_t res;
+    Uint8Buff serviceId = { NULL, SHA256_LEN };
+    serviceId.val = (uint8_t *)HcMalloc(serviceId.length, 0);
+    if (serviceId.val == NULL) {
+        LOGE("Malloc for serviceId failed.");
+        return HC_ERR_ALLOC_MEMORY;
     }
-    res = CombineKeyAlias(serviceId, keyType, authId, &keyAliasHash);
+    res = CombineServiceId(pkgName, serviceType, &serviceId);
     if (res != HC_SUCCESS) {
-        LOGE("CombineKeyAlias failed.");
-        goto ERR;
+        LOGE("CombineServiceId failed, res: %x.", res);
+        HcFree(serviceId.val);
+        return res;
     }
-    uint32_t outKeyAliasHexLen = keyAliasHash.length * BYTE_TO_HEX_OPER_LENGTH + 1;
-    outKeyAliasHex = (char *)HcMalloc(outKeyAliasHexLen, 0);
-    res = ByteToHexString(keyAliasHash.val, keyAliasHash.length, outKeyAliasHex, outKeyAliasHexLen);
+    Uint8Buff keyTypeBuff = { (uint8_t *)KEY_TYPE_PAIRS[keyType], KEY_TYPE_PAIR_LEN };
+    res = CombineKeyAlias(&serviceId, &keyTypeBuff, authId, keyAliasHash);
     if (res != HC_SUCCESS) {
-        LOGE("ByteToHexString failed");
-        goto ERR;
-    }
-    if (memcpy_s(outKeyAlias->val, outKeyAlias->length, outKeyAliasHex, strlen(outKeyAliasHex)) != EOK) {
-        LOGE("memcpy outkeyalias failed.");
-        res = HC_ERR_MEMORY_COPY;
-        goto ERR;
+        LOGE("CombineKeyAlias failed, keyType: %d, res: %d", keyType, res);
     }
-ERR:
-    HcFree(keyAliasHash.val);
-    HcFree(outKeyAliasHex);
+    HcFree(serviceId.val);
     return res;
 }
 
@@ -317,32 +385,35 @@ int32_t GenerateKeyAlias(const Uint8Buff *pkgName, const Uint8Buff *serviceType,
         LOGE("Out of length params exist.");
         return HC_ERR_INVALID_LEN;
     }
-
-    int32_t res;
-    Uint8Buff serviceId = { NULL, SHA256_LEN };
-    serviceId.val = (uint8_t *)HcMalloc(serviceId.length, 0);
-    if (serviceId.val == NULL) {
-        LOGE("Malloc for serviceId failed.");
-        res = HC_ERR_ALLOC_MEMORY;
-        goto ERR;
-    }
-    res = CombineServiceId(pkgName, serviceType, &serviceId);
-    if (res != HC_SUCCESS) {
-        LOGE("CombineServiceId failed, res: %x.", res);
-        goto ERR;
+    /* The iso auth token alias is the raw hash, all the others are its hex string. */
+    bool isRawAlias = (keyType == KEY_ALIAS_AUTH_TOKEN);
+    if (outKeyAlias->length != (isRawAlias ? SHA256_LEN : SHA256_LEN * BYTE_TO_HEX_OPER_LENGTH)) {
+        return HC_ERR_INVALID_LEN;
     }
-    Uint8Buff keyTypeBuff = { (uint8_t *)KEY_TYPE_PAIRS[keyType], KEY_TYPE_PAIR_LEN };
-    if (keyType == KEY_ALIAS_AUTH_TOKEN) {
-        res = CombineKeyAliasForIso(&serviceId, &keyTypeBuff, authId, outKeyAlias);
-    } else {
-        res = CombineKeyAliasForPake(&serviceId, &keyTypeBuff, authId, outKeyAlias);
+
+    uint8_t hashVal[SHA256_LEN] = { 0 };
+    Uint8Buff keyAliasHash = { hashVal, SHA256_LEN };
+    if (!GetCachedKeyAliasHash(pkgName, serviceType, keyType, authId, hashVal)) {
+        int32_t res = ComputeKeyAliasHash(pkgName, serviceType, keyType, authId, &keyAliasHash);
+        if (res != HC_SUCCESS) {
+            return res;
+        }
+        CacheKeyAliasHash(pkgName, serviceType, keyType, authId, hashVal);
+    }
+    if (isRawAlias) {
+        return (memcpy_s(outKeyAlias->val, outKeyAlias->length, hashVal, SHA256_LEN) == EOK) ?
+            HC_SUCCESS : HC_ERR_MEMORY_COPY;
+    }
+    char hashHex[SHA256_LEN * BYTE_TO_HEX_OPER_LENGTH + 1] = { 0 };
+    if (ByteToHexString(hashVal, SHA256_LEN, hashHex, sizeof(hashHex)) != HC_SUCCESS) {
+        LOGE("ByteToHexString failed");
+        return HC_ERR_CONVERT_FAILED;
     }
-    if (res != HC_SUCCESS) {
-        LOGE("CombineKeyAlias failed, keyType: %d, res: %d", keyType, res);
+    if (memcpy_s(outKeyAlias->val, outKeyAlias->length, hashHex, SHA256_LEN * BYTE_TO_HEX_OPER_LENGTH) != EOK) {
+        LOGE("memcpy outkeyalias failed.");
+        return HC_ERR_MEMORY_COPY;
     }
-ERR:
-    HcFree(serviceId.val);
-    return res;
+    return HC_SUCCESS;
 }
 
 int32_t GetIdPeer(const CJson *in, const char *peerIdKey, const Uint8Buff *authIdSelf, Uint8Buff *authIdPeer)
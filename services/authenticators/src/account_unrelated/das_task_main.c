@@ -24,6 +24,7 @@
 #include "pake_v2_task_main.h"
 #include "pake_protocol_dl_common.h"
 #include "pake_protocol_ec_common.h"
+#include "pake_v1_resume.h"
 #include "pake_v1_task_main.h"
 #include "protocol_common.h"
 
@@ -529,6 +530,10 @@ int32_t InitDasProtocolEntities(void)
         protocol->createSubTask = CreatePakeV1SubTask;
         protocol->tokenManagerInstance = GetStandardTokenManagerInstance();
         g_protocolEntityVec.pushBackT(&g_protocolEntityVec, (void *)protocol);
+        if (InitPakeV1ResumeCache() != HC_SUCCESS) {
+            /* Authentication still works, every time with the full handshake. */
+            LOGW("Init pake v1 resumption cache failed.");
+        }
     }
 
     if (IsSupportPakeV2()) {
@@ -558,4 +563,6 @@ void DestroyDasProtocolEntities(void)
         }
     }
     DESTROY_HC_VECTOR(DasProtocolEntityVec, &g_protocolEntityVec);
+    DestroyPakeV1ResumeCache();
+    ClearKeyAliasCache();
 }
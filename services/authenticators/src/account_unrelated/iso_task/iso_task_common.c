@@ -67,7 +67,7 @@ static int GenerateReturnKey(IsoParams *params, uint8_t *returnKey, uint32_t ret
         goto ERR;
     }
 ERR:
-    FreeAndCleanKey(&(params->baseParams.sessionKey));
+    CleanArenaParam(&(params->baseParams.sessionKey));
     HcFree(hkdfSalt);
     return res;
 }
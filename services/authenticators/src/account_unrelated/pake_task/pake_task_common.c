@@ -71,7 +71,7 @@ static int32_t GenerateOutputKey(PakeParams *params)
         LOGE("Generate returnKey failed.");
         FreeAndCleanKey(&(params->returnKey));
     }
-    FreeAndCleanKey(&(params->baseParams.sessionKey));
+    CleanArenaParam(&(params->baseParams.sessionKey));
     return res;
 }
 
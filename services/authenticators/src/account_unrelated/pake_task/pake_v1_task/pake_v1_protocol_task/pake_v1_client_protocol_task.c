@@ -20,6 +20,7 @@
 #include "pake_message_util.h"
 #include "pake_v1_protocol_common.h"
 #include "pake_v1_protocol_task_common.h"
+#include "pake_v1_resume.h"
 #include "pake_task_common.h"
 
 enum {
@@ -36,6 +37,11 @@ static CurTaskType GetTaskType(void)
 
 static void DestroyPakeV1ProtocolClientTask(struct AsyBaseCurTaskT *task)
 {
+    if (task == NULL) {
+        return;
+    }
+    PakeV1ProtocolClientTask *realTask = (PakeV1ProtocolClientTask *)task;
+    (void)memset_s(&(realTask->resumeTicket), sizeof(ResumeTicket), 0, sizeof(ResumeTicket));
     HcFree(task);
 }
 
@@ -78,6 +84,9 @@ static int PakeRequest(AsyBaseCurTask *task, PakeParams *params, CJson *out, int
             return res;
         }
     }
+    // the full request stays in the payload, so that a server which can't resume just ignores the offer
+    ((PakeV1ProtocolClientTask *)task)->isResumeOffered = (AddPakeV1ResumeOffer(params,
+        &(((PakeV1ProtocolClientTask *)task)->resumeTicket), payload) == HC_SUCCESS);
 
     task->taskStatus = TASK_STATUS_CLIENT_PAKE_REQUEST;
     *status = CONTINUE;
@@ -204,6 +213,38 @@ static int PakeClientVerifyConfirm(AsyBaseCurTask *task, PakeParams *params, con
         LOGE("ClientVerifyConfirmPakeV1Protocol failed, res: %d.", res);
         return res;
     }
+    SavePakeV1ResumeTicket(params);
+
+    task->taskStatus = TASK_STATUS_CLIENT_PAKE_VERIFY_CONFIRM;
+    *status = FINISH;
+    return res;
+}
+
+static int PakeClientVerifyResume(AsyBaseCurTask *task, PakeParams *params, const CJson *in, int *status)
+{
+    PakeV1ProtocolClientTask *realTask = (PakeV1ProtocolClientTask *)task;
+    if (task->taskStatus > TASK_STATUS_CLIENT_PAKE_REQUEST) {
+        LOGI("The message is repeated, ignore it, status: %d", task->taskStatus);
+        *status = IGNORE_MSG;
+        return HC_SUCCESS;
+    }
+    if (task->taskStatus < TASK_STATUS_CLIENT_PAKE_REQUEST || !realTask->isResumeOffered) {
+        LOGE("Invalid taskStatus: %d, or resumption is not offered.", task->taskStatus);
+        return HC_ERR_BAD_MESSAGE;
+    }
+
+    int res = GetAndCheckAuthIdPeer(in, &(params->baseParams.idSelf), &(params->baseParams.idPeer));
+    if (res != HC_SUCCESS) {
+        LOGE("GetAndCheckAuthIdPeer failed, res: %d.", res);
+        return res;
+    }
+    res = ClientFinishPakeV1Resume(params, &(realTask->resumeTicket), in);
+    (void)memset_s(&(realTask->resumeTicket), sizeof(ResumeTicket), 0, sizeof(ResumeTicket));
+    if (res != HC_SUCCESS) {
+        LOGE("ClientFinishPakeV1Resume failed, res: %d.", res);
+        RevokePakeV1ResumeTickets(params->packageName, params->serviceType, &(params->baseParams.idPeer));
+        return res;
+    }
 
     task->taskStatus = TASK_STATUS_CLIENT_PAKE_VERIFY_CONFIRM;
     *status = FINISH;
@@ -228,6 +269,9 @@ static int Process(struct AsyBaseCurTaskT *task, PakeParams *params, const CJson
         case STEP_THREE:
             res = PakeClientVerifyConfirm(task, params, in, status);
             break;
+        case STEP_RESUME + 1:
+            res = PakeClientVerifyResume(task, params, in, status);
+            break;
         default:
             res = HC_ERR_BAD_MESSAGE;
             break;
@@ -237,7 +281,7 @@ OUT:
         LOGE("Process step:%d failed, res: %x.", step, res);
         return res;
     }
-    if (step != STEP_THREE) {
+    if (*status != FINISH) {
         res = ClientProtocolMessageOut(out, params->opCode, step);
         if (res != HC_SUCCESS) {
             LOGE("ClientProtocolMessageOut failed, res: %x.", res);
@@ -257,5 +301,6 @@ AsyBaseCurTask *CreatePakeV1ProtocolClientTask()
     task->taskBase.process = Process;
     task->taskBase.taskStatus = TASK_STATUS_CLIENT_PAKE_BEGIN;
     task->taskBase.getCurTaskType = GetTaskType;
+    task->isResumeOffered = false;
     return (AsyBaseCurTask *)task;
 }
\ No newline at end of file
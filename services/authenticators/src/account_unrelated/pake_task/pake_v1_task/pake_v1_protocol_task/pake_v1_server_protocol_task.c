@@ -20,12 +20,14 @@
 #include "pake_message_util.h"
 #include "pake_v1_protocol_common.h"
 #include "pake_v1_protocol_task_common.h"
+#include "pake_v1_resume.h"
 #include "pake_task_common.h"
 
 enum {
     TASK_STATUS_SERVER_PAKE_BEGIN = 0,
     TASK_STATUS_SERVER_PAKE_RESPONSE,
-    TASK_STATUS_SERVER_PAKE_CONFIRM
+    TASK_STATUS_SERVER_PAKE_CONFIRM,
+    TASK_STATUS_SERVER_PAKE_RESUME
 };
 
 static CurTaskType GetTaskType(void)
@@ -73,6 +75,34 @@ static int PackageMsgForResponse(const PakeParams *params, CJson *out)
     return res;
 }
 
+static bool ResumeResponse(PakeParams *params, const CJson *in, CJson *out)
+{
+    CJson *resumeOut = CreateJson();
+    if (resumeOut == NULL) {
+        LOGE("Create resumeOut json failed.");
+        return false;
+    }
+    // package into a separate json, so that out stays clean for the full handshake if the offer is refused
+    bool isResumed = false;
+    CJson *payload = NULL;
+    if (ConstructOutJson(params, resumeOut) != HC_SUCCESS) {
+        goto OUT;
+    }
+    payload = GetObjFromJson(resumeOut, FIELD_PAYLOAD);
+    if ((payload == NULL) || (ServerFinishPakeV1Resume(params, in, payload) != HC_SUCCESS)) {
+        goto OUT;
+    }
+    if (AddByteToJson(payload, FIELD_PEER_AUTH_ID, params->baseParams.idSelf.val,
+        params->baseParams.idSelf.length) != HC_SUCCESS) {
+        LOGE("Add idSelf failed.");
+        goto OUT;
+    }
+    isResumed = (AddObjToJson(out, FIELD_SEND_TO_PEER, GetObjFromJson(resumeOut, FIELD_SEND_TO_PEER)) == HC_SUCCESS);
+OUT:
+    FreeJson(resumeOut);
+    return isResumed;
+}
+
 static int PakeResponse(AsyBaseCurTask *task, PakeParams *params, const CJson *in, CJson *out, int *status)
 {
     int res;
@@ -95,6 +125,12 @@ static int PakeResponse(AsyBaseCurTask *task, PakeParams *params, const CJson *i
             return res;
         }
     }
+    if (params->opCode == AUTHENTICATE && ResumeResponse(params, in, out)) {
+        LOGI("Resume the session of the peer, skip the full handshake.");
+        task->taskStatus = TASK_STATUS_SERVER_PAKE_RESUME;
+        *status = FINISH;
+        return HC_SUCCESS;
+    }
 
     if (params->isPskSupported && (params->opCode == AUTHENTICATE || params->opCode == OP_UNBIND)) {
         res = FillPskWithDerivedKeyHex(params);
@@ -172,6 +208,7 @@ static int PakeServerConfirm(AsyBaseCurTask *task, PakeParams *params, const CJs
         LOGE("PackagePakeServerConfirmData failed, res: %d.", res);
         return res;
     }
+    SavePakeV1ResumeTicket(params);
 
     task->taskStatus = TASK_STATUS_SERVER_PAKE_CONFIRM;
     *status = FINISH;
@@ -190,6 +227,9 @@ static int Process(struct AsyBaseCurTaskT *task, PakeParams *params, const CJson
     switch (step) {
         case STEP_ONE:
             res = PakeResponse(task, params, in, out, status);
+            if (task->taskStatus == TASK_STATUS_SERVER_PAKE_RESUME) {
+                step = STEP_RESUME;
+            }
             break;
         case STEP_TWO:
             res = PakeServerConfirm(task, params, in, out, status);
@@ -0,0 +1,499 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "pake_v1_resume.h"
+#include "device_auth_defines.h"
+#include "hc_log.h"
+#include "hc_mutex.h"
+#include "hc_time.h"
+#include "hc_types.h"
+#include "string_util.h"
+
+/* Calculate in seconds, 0 disables the resumption. */
+#ifndef RESUME_TICKET_LIFETIME
+#define RESUME_TICKET_LIFETIME 300
+#endif
+
+#define RESUME_CACHE_SIZE 16
+#define RESUME_NONCE_LEN PAKE_CHALLENGE_LEN
+#define RESUME_MAC_MSG_MAX_LEN (RESUME_NONCE_LEN + RESUME_NONCE_LEN + RESUME_TICKET_ID_LEN)
+
+#define HICHAIN_RESUME_SECRET_INFO "hichain_resume_secret_info"
+#define HICHAIN_RESUME_TICKET_ID_INFO "hichain_resume_ticket_id_info"
+#define HICHAIN_RESUME_SESSIONKEY_INFO "hichain_resume_sessionkey_info"
+
+typedef struct {
+    char *pkgName;
+    char *serviceType;
+    Uint8Buff authIdPeer;
+    ResumeTicket ticket;
+    uint64_t lastUsed;
+} ResumeEntry;
+
+/* An entry is in use when its pkgName is not NULL. */
+static ResumeEntry g_resumeEntries[RESUME_CACHE_SIZE];
+static uint64_t g_useCounter = 0;
+static HcMutex *g_resumeMutex = NULL;
+
+static void ClearEntry(ResumeEntry *entry)
+{
+    HcFree(entry->pkgName);
+    HcFree(entry->serviceType);
+    HcFree(entry->authIdPeer.val);
+    (void)memset_s(entry, sizeof(ResumeEntry), 0, sizeof(ResumeEntry));
+}
+
+static bool IsEntryOf(const ResumeEntry *entry, const char *pkgName, const char *serviceType,
+    const Uint8Buff *authIdPeer)
+{
+    if ((entry->pkgName == NULL) || (strcmp(entry->pkgName, pkgName) != 0) ||
+        (strcmp(entry->serviceType, serviceType) != 0)) {
+        return false;
+    }
+    if (authIdPeer == NULL) {
+        return true;
+    }
+    return (entry->authIdPeer.length == authIdPeer->length) &&
+        (memcmp(entry->authIdPeer.val, authIdPeer->val, authIdPeer->length) == 0);
+}
+
+/* Must be called with the cache locked. */
+static ResumeEntry *FindEntry(const PakeParams *params)
+{
+    for (uint32_t i = 0; i < RESUME_CACHE_SIZE; i++) {
+        if (IsEntryOf(&g_resumeEntries[i], params->packageName, params->serviceType, &(params->baseParams.idPeer))) {
+            return &g_resumeEntries[i];
+        }
+    }
+    return NULL;
+}
+
+/* Must be called with the cache locked. Prefers the peer's own entry, then a free or expired one, then the LRU one. */
+static ResumeEntry *SelectEntryToStore(const PakeParams *params, int64_t curTime)
+{
+    ResumeEntry *entry = FindEntry(params);
+    if (entry != NULL) {
+        return entry;
+    }
+    ResumeEntry *victim = &g_resumeEntries[0];
+    for (uint32_t i = 0; i < RESUME_CACHE_SIZE; i++) {
+        entry = &g_resumeEntries[i];
+        if ((entry->pkgName == NULL) || (entry->ticket.expireTime <= curTime)) {
+            victim = entry;
+            break;
+        }
+        if (entry->lastUsed < victim->lastUsed) {
+            victim = entry;
+        }
+    }
+    ClearEntry(victim);
+    return victim;
+}
+
+static char *CopyString(const char *str)
+{
+    uint32_t len = HcStrlen(str);
+    char *copy = (char *)HcMalloc(len + 1, 0);
+    if ((copy != NULL) && (memcpy_s(copy, len + 1, str, len) != EOK)) {
+        HcFree(copy);
+        return NULL;
+    }
+    return copy;
+}
+
+/* Must be called with the cache locked. */
+static int32_t FillEntryKey(ResumeEntry *entry, const PakeParams *params)
+{
+    entry->pkgName = CopyString(params->packageName);
+    entry->serviceType = CopyString(params->serviceType);
+    entry->authIdPeer.val = (uint8_t *)HcMalloc(params->baseParams.idPeer.length, 0);
+    if ((entry->pkgName == NULL) || (entry->serviceType == NULL) || (entry->authIdPeer.val == NULL)) {
+        ClearEntry(entry);
+        return HC_ERR_ALLOC_MEMORY;
+    }
+    entry->authIdPeer.length = params->baseParams.idPeer.length;
+    if (memcpy_s(entry->authIdPeer.val, entry->authIdPeer.length, params->baseParams.idPeer.val,
+        params->baseParams.idPeer.length) != EOK) {
+        ClearEntry(entry);
+        return HC_ERR_MEMORY_COPY;
+    }
+    return HC_SUCCESS;
+}
+
+static int32_t StoreTicket(const PakeParams *params, const ResumeTicket *ticket)
+{
+    if (g_resumeMutex == NULL) {
+        return HC_ERR_INIT_FAILED;
+    }
+    g_resumeMutex->lock(g_resumeMutex);
+    ResumeEntry *entry = SelectEntryToStore(params, HcGetCurTime());
+    if (entry->pkgName == NULL) {
+        int32_t res = FillEntryKey(entry, params);
+        if (res != HC_SUCCESS) {
+            g_resumeMutex->unlock(g_resumeMutex);
+            return res;
+        }
+    }
+    entry->ticket = *ticket;
+    entry->lastUsed = ++g_useCounter;
+    g_resumeMutex->unlock(g_resumeMutex);
+    return HC_SUCCESS;
+}
+
+/* The client keeps its ticket until the answer of the server arrives. */
+static int32_t PeekTicket(const PakeParams *params, ResumeTicket *ticket)
+{
+    int32_t res = HC_ERR_LOST_DATA;
+    g_resumeMutex->lock(g_resumeMutex);
+    ResumeEntry *entry = FindEntry(params);
+    if ((entry != NULL) && (entry->ticket.expireTime <= HcGetCurTime())) {
+        ClearEntry(entry);
+    } else if (entry != NULL) {
+        *ticket = entry->ticket;
+        entry->lastUsed = ++g_useCounter;
+        res = HC_SUCCESS;
+    }
+    g_resumeMutex->unlock(g_resumeMutex);
+    return res;
+}
+
+/*
+ * The server copies the offered ticket and verifies the offer before consuming it. An offer with another ticket id
+ * or a forged mac leaves the entry alone, a stale or forged offer must not revoke the valid ticket.
+ */
+static int32_t CopyOfferedTicket(const PakeParams *params, const uint8_t *ticketId, ResumeTicket *ticket)
+{
+    int32_t res = HC_ERR_LOST_DATA;
+    g_resumeMutex->lock(g_resumeMutex);
+    ResumeEntry *entry = FindEntry(params);
+    if ((entry != NULL) && (entry->ticket.expireTime <= HcGetCurTime())) {
+        ClearEntry(entry);
+    } else if ((entry != NULL) && (memcmp(entry->ticket.ticketId, ticketId, RESUME_TICKET_ID_LEN) == 0)) {
+        *ticket = entry->ticket;
+        res = HC_SUCCESS;
+    }
+    g_resumeMutex->unlock(g_resumeMutex);
+    return res;
+}
+
+/* Consumes the verified ticket, so that an offer can never be accepted twice, even by two concurrent sessions. */
+static int32_t ConsumeTicket(const PakeParams *params, const uint8_t *ticketId)
+{
+    int32_t res = HC_ERR_LOST_DATA;
+    g_resumeMutex->lock(g_resumeMutex);
+    ResumeEntry *entry = FindEntry(params);
+    if ((entry != NULL) && (memcmp(entry->ticket.ticketId, ticketId, RESUME_TICKET_ID_LEN) == 0)) {
+        ClearEntry(entry);
+        res = HC_SUCCESS;
+    }
+    g_resumeMutex->unlock(g_resumeMutex);
+    return res;
+}
+
+static int32_t DeriveTicket(const AlgLoader *loader, const Uint8Buff *key, const Uint8Buff *salt,
+    ResumeTicket *ticket)
+{
+    Uint8Buff secret = { ticket->secret, RESUME_SECRET_LEN };
+    Uint8Buff keyInfo = { (uint8_t *)HICHAIN_RESUME_SECRET_INFO, HcStrlen(HICHAIN_RESUME_SECRET_INFO) };
+    int32_t res = loader->computeHkdf(key, salt, &keyInfo, &secret, false);
+    if (res != HC_SUCCESS) {
+        LOGE("Derive resumption secret failed, res: %d.", res);
+        return res;
+    }
+    uint8_t ticketIdVal[HMAC_LEN] = { 0 };
+    Uint8Buff ticketId = { ticketIdVal, HMAC_LEN };
+    Uint8Buff idInfo = { (uint8_t *)HICHAIN_RESUME_TICKET_ID_INFO, HcStrlen(HICHAIN_RESUME_TICKET_ID_INFO) };
+    res = loader->computeHmac(&secret, &idInfo, &ticketId, false);
+    if (res != HC_SUCCESS) {
+        LOGE("Compute resumption ticket id failed, res: %d.", res);
+        return res;
+    }
+    if (memcpy_s(ticket->ticketId, RESUME_TICKET_ID_LEN, ticketIdVal, RESUME_TICKET_ID_LEN) != EOK) {
+        return HC_ERR_MEMORY_COPY;
+    }
+    return HC_SUCCESS;
+}
+
+/* The client's mac covers nonceC || ticketId, the server's mac covers nonceS || nonceC || ticketId. */
+static int32_t ComputeResumeMac(const PakeParams *params, const ResumeTicket *ticket, const Uint8Buff *nonceC,
+    const Uint8Buff *nonceS, Uint8Buff *mac)
+{
+    uint8_t msgVal[RESUME_MAC_MSG_MAX_LEN] = { 0 };
+    Uint8Buff msg = { msgVal, 0 };
+    if (nonceS != NULL) {
+        if (memcpy_s(msg.val, RESUME_MAC_MSG_MAX_LEN, nonceS->val, nonceS->length) != EOK) {
+            return HC_ERR_MEMORY_COPY;
+        }
+        msg.length += nonceS->length;
+    }
+    if (memcpy_s(msg.val + msg.length, RESUME_MAC_MSG_MAX_LEN - msg.length, nonceC->val, nonceC->length) != EOK) {
+        return HC_ERR_MEMORY_COPY;
+    }
+    msg.length += nonceC->length;
+    if (memcpy_s(msg.val + msg.length, RESUME_MAC_MSG_MAX_LEN - msg.length, ticket->ticketId,
+        RESUME_TICKET_ID_LEN) != EOK) {
+        return HC_ERR_MEMORY_COPY;
+    }
+    msg.length += RESUME_TICKET_ID_LEN;
+    Uint8Buff secret = { (uint8_t *)ticket->secret, RESUME_SECRET_LEN };
+    int32_t res = params->baseParams.loader->computeHmac(&secret, &msg, mac, false);
+    if (res != HC_SUCCESS) {
+        LOGE("Compute resumption mac failed, res: %d.", res);
+    }
+    return res;
+}
+
+/* Derives the session key from the old secret, then rotates the ticket with the same nonces. */
+static int32_t DeriveSessionKeyAndRotate(PakeParams *params, const ResumeTicket *ticket, const Uint8Buff *nonceC,
+    const Uint8Buff *nonceS)
+{
+    uint8_t noncesVal[RESUME_NONCE_LEN + RESUME_NONCE_LEN] = { 0 };
+    Uint8Buff nonces = { noncesVal, RESUME_NONCE_LEN + RESUME_NONCE_LEN };
+    if ((memcpy_s(noncesVal, nonces.length, nonceC->val, nonceC->length) != EOK) ||
+        (memcpy_s(noncesVal + nonceC->length, nonces.length - nonceC->length, nonceS->val, nonceS->length) != EOK)) {
+        return HC_ERR_MEMORY_COPY;
+    }
+    Uint8Buff secret = { (uint8_t *)ticket->secret, RESUME_SECRET_LEN };
+    Uint8Buff keyInfo = { (uint8_t *)HICHAIN_RESUME_SESSIONKEY_INFO, HcStrlen(HICHAIN_RESUME_SESSIONKEY_INFO) };
+    int32_t res = params->baseParams.loader->computeHkdf(&secret, &nonces, &keyInfo,
+        &(params->baseParams.sessionKey), false);
+    if (res != HC_SUCCESS) {
+        LOGE("Derive resumed session key failed, res: %d.", res);
+        return res;
+    }
+
+    ResumeTicket nextTicket;
+    res = DeriveTicket(params->baseParams.loader, &secret, &nonces, &nextTicket);
+    if (res == HC_SUCCESS) {
+        /* Rotation never extends the lifetime, a full handshake is needed once the ticket expires. */
+        nextTicket.expireTime = ticket->expireTime;
+        res = StoreTicket(params, &nextTicket);
+    }
+    if (res != HC_SUCCESS) {
+        LOGW("Rotate resumption ticket failed, res: %d.", res);
+    }
+    (void)memset_s(&nextTicket, sizeof(ResumeTicket), 0, sizeof(ResumeTicket));
+    /* The session key is already derived, a failed rotation only costs a full handshake next time. */
+    return HC_SUCCESS;
+}
+
+static int32_t GetFixedLenByteFromJson(const CJson *in, const char *key, uint8_t *val, uint32_t len)
+{
+    const char *valStr = GetStringFromJson(in, key);
+    if ((valStr == NULL) || (HcStrlen(valStr) != len * BYTE_TO_HEX_OPER_LENGTH)) {
+        return HC_ERR_JSON_GET;
+    }
+    return (HexStringToByte(valStr, val, len) == HC_SUCCESS) ? HC_SUCCESS : HC_ERR_CONVERT_FAILED;
+}
+
+void SavePakeV1ResumeTicket(const PakeParams *params)
+{
+    if ((RESUME_TICKET_LIFETIME <= 0) || (g_resumeMutex == NULL) || (params->opCode != AUTHENTICATE)) {
+        return;
+    }
+    ResumeTicket ticket;
+    int32_t res = DeriveTicket(params->baseParams.loader, &(params->baseParams.sessionKey),
+        &(params->baseParams.salt), &ticket);
+    if (res == HC_SUCCESS) {
+        ticket.expireTime = HcGetCurTime() + RESUME_TICKET_LIFETIME;
+        res = StoreTicket(params, &ticket);
+    }
+    if (res != HC_SUCCESS) {
+        LOGW("Save resumption ticket failed, res: %d.", res);
+    }
+    (void)memset_s(&ticket, sizeof(ResumeTicket), 0, sizeof(ResumeTicket));
+}
+
+void RevokePakeV1ResumeTickets(const char *pkgName, const char *serviceType, const Uint8Buff *authIdPeer)
+{
+    if ((g_resumeMutex == NULL) || (pkgName == NULL) || (serviceType == NULL)) {
+        return;
+    }
+    g_resumeMutex->lock(g_resumeMutex);
+    for (uint32_t i = 0; i < RESUME_CACHE_SIZE; i++) {
+        if (IsEntryOf(&g_resumeEntries[i], pkgName, serviceType, authIdPeer)) {
+            ClearEntry(&g_resumeEntries[i]);
+        }
+    }
+    g_resumeMutex->unlock(g_resumeMutex);
+}
+
+int32_t AddPakeV1ResumeOffer(PakeParams *params, ResumeTicket *ticket, CJson *payload)
+{
+    if ((RESUME_TICKET_LIFETIME <= 0) || (g_resumeMutex == NULL) || (params->opCode != AUTHENTICATE)) {
+        return HC_ERR_NOT_SUPPORT;
+    }
+    int32_t res = PeekTicket(params, ticket);
+    if (res != HC_SUCCESS) {
+        return res;
+    }
+    uint8_t macVal[HMAC_LEN] = { 0 };
+    Uint8Buff mac = { macVal, HMAC_LEN };
+    /* challengeSelf is drawn again by the full handshake if the server does not resume. */
+    res = params->baseParams.loader->generateRandom(&(params->baseParams.challengeSelf));
+    if (res != HC_SUCCESS) {
+        LOGE("Generate resumption nonce failed, res: %d.", res);
+        goto ERR;
+    }
+    res = ComputeResumeMac(params, ticket, &(params->baseParams.challengeSelf), NULL, &mac);
+    if (res != HC_SUCCESS) {
+        goto ERR;
+    }
+    if ((AddByteToJson(payload, FIELD_RESUME_TICKET, ticket->ticketId, RESUME_TICKET_ID_LEN) != HC_SUCCESS) ||
+        (AddByteToJson(payload, FIELD_RESUME_NONCE, params->baseParams.challengeSelf.val,
+        params->baseParams.challengeSelf.length) != HC_SUCCESS) ||
+        (AddByteToJson(payload, FIELD_RESUME_MAC, mac.val, mac.length) != HC_SUCCESS)) {
+        LOGE("Add resumption offer failed.");
+        res = HC_ERR_JSON_ADD;
+        goto ERR;
+    }
+    LOGI("Offer resumption ticket: %x%x****.", ticket->ticketId[0], ticket->ticketId[1]);
+    return HC_SUCCESS;
+ERR:
+    (void)memset_s(ticket, sizeof(ResumeTicket), 0, sizeof(ResumeTicket));
+    return res;
+}
+
+int32_t ClientFinishPakeV1Resume(PakeParams *params, const ResumeTicket *ticket, const CJson *in)
+{
+    int32_t res = GetFixedLenByteFromJson(in, FIELD_SALT, params->baseParams.salt.val, params->baseParams.salt.length);
+    if (res != HC_SUCCESS) {
+        LOGE("Get resumption nonce of server failed, res: %d.", res);
+        return res;
+    }
+    uint8_t macPeerVal[HMAC_LEN] = { 0 };
+    res = GetFixedLenByteFromJson(in, FIELD_RESUME_MAC, macPeerVal, HMAC_LEN);
+    if (res != HC_SUCCESS) {
+        LOGE("Get resumption mac of server failed, res: %d.", res);
+        return res;
+    }
+    uint8_t macVal[HMAC_LEN] = { 0 };
+    Uint8Buff mac = { macVal, HMAC_LEN };
+    res = ComputeResumeMac(params, ticket, &(params->baseParams.challengeSelf), &(params->baseParams.salt), &mac);
+    if (res != HC_SUCCESS) {
+        return res;
+    }
+    if (memcmp(macVal, macPeerVal, HMAC_LEN) != 0) {
+        LOGE("Resumption mac of server does not match.");
+        return HC_ERR_PROOF_NOT_MATCH;
+    }
+    return DeriveSessionKeyAndRotate(params, ticket, &(params->baseParams.challengeSelf), &(params->baseParams.salt));
+}
+
+static int32_t VerifyOffer(const PakeParams *params, const ResumeTicket *ticket, const uint8_t *macPeer)
+{
+    uint8_t macVal[HMAC_LEN] = { 0 };
+    Uint8Buff mac = { macVal, HMAC_LEN };
+    int32_t res = ComputeResumeMac(params, ticket, &(params->baseParams.challengePeer), NULL, &mac);
+    if (res != HC_SUCCESS) {
+        return res;
+    }
+    if (memcmp(macVal, macPeer, HMAC_LEN) != 0) {
+        LOGE("Resumption mac of client does not match.");
+        return HC_ERR_PROOF_NOT_MATCH;
+    }
+    return HC_SUCCESS;
+}
+
+static int32_t PackageAnswer(PakeParams *params, const ResumeTicket *ticket, CJson *payload)
+{
+    uint8_t macVal[HMAC_LEN] = { 0 };
+    Uint8Buff mac = { macVal, HMAC_LEN };
+    int32_t res = params->baseParams.loader->generateRandom(&(params->baseParams.salt));
+    if (res != HC_SUCCESS) {
+        LOGE("Generate resumption nonce failed, res: %d.", res);
+        return res;
+    }
+    res = ComputeResumeMac(params, ticket, &(params->baseParams.challengePeer), &(params->baseParams.salt), &mac);
+    if (res != HC_SUCCESS) {
+        return res;
+    }
+    if ((AddByteToJson(payload, FIELD_SALT, params->baseParams.salt.val, params->baseParams.salt.length) !=
+        HC_SUCCESS) || (AddByteToJson(payload, FIELD_RESUME_MAC, mac.val, mac.length) != HC_SUCCESS)) {
+        LOGE("Add resumption answer failed.");
+        return HC_ERR_JSON_ADD;
+    }
+    return HC_SUCCESS;
+}
+
+int32_t ServerFinishPakeV1Resume(PakeParams *params, const CJson *in, CJson *payload)
+{
+    uint8_t ticketId[RESUME_TICKET_ID_LEN] = { 0 };
+    uint8_t macPeer[HMAC_LEN] = { 0 };
+    if ((RESUME_TICKET_LIFETIME <= 0) || (g_resumeMutex == NULL) || (params->opCode != AUTHENTICATE) ||
+        (GetFixedLenByteFromJson(in, FIELD_RESUME_TICKET, ticketId, RESUME_TICKET_ID_LEN) != HC_SUCCESS)) {
+        return HC_ERR_NOT_SUPPORT;
+    }
+    if ((GetFixedLenByteFromJson(in, FIELD_RESUME_NONCE, params->baseParams.challengePeer.val,
+        params->baseParams.challengePeer.length) != HC_SUCCESS) ||
+        (GetFixedLenByteFromJson(in, FIELD_RESUME_MAC, macPeer, HMAC_LEN) != HC_SUCCESS)) {
+        LOGE("Get resumption offer failed.");
+        return HC_ERR_JSON_GET;
+    }
+    ResumeTicket ticket;
+    int32_t res = CopyOfferedTicket(params, ticketId, &ticket);
+    if (res != HC_SUCCESS) {
+        LOGI("No valid resumption ticket for the offer.");
+        return res;
+    }
+    res = VerifyOffer(params, &ticket, macPeer);
+    if (res == HC_SUCCESS) {
+        res = ConsumeTicket(params, ticketId);
+    }
+    if (res == HC_SUCCESS) {
+        res = PackageAnswer(params, &ticket, payload);
+    }
+    if (res == HC_SUCCESS) {
+        res = DeriveSessionKeyAndRotate(params, &ticket, &(params->baseParams.challengePeer),
+            &(params->baseParams.salt));
+    }
+    (void)memset_s(&ticket, sizeof(ResumeTicket), 0, sizeof(ResumeTicket));
+    return res;
+}
+
+int32_t InitPakeV1ResumeCache(void)
+{
+    if (g_resumeMutex != NULL) {
+        return HC_SUCCESS;
+    }
+    g_resumeMutex = (HcMutex *)HcMalloc(sizeof(HcMutex), 0);
+    if (g_resumeMutex == NULL) {
+        LOGE("Failed to allocate resumption cache mutex memory!");
+        return HC_ERR_ALLOC_MEMORY;
+    }
+    if (InitHcMutex(g_resumeMutex) != HC_SUCCESS) {
+        LOGE("Failed to init resumption cache mutex!");
+        HcFree(g_resumeMutex);
+        g_resumeMutex = NULL;
+        return HC_ERROR;
+    }
+    return HC_SUCCESS;
+}
+
+void DestroyPakeV1ResumeCache(void)
+{
+    if (g_resumeMutex == NULL) {
+        return;
+    }
+    g_resumeMutex->lock(g_resumeMutex);
+    for (uint32_t i = 0; i < RESUME_CACHE_SIZE; i++) {
+        ClearEntry(&g_resumeEntries[i]);
+    }
+    g_useCounter = 0;
+    g_resumeMutex->unlock(g_resumeMutex);
+    DestroyHcMutex(g_resumeMutex);
+    HcFree(g_resumeMutex);
+    g_resumeMutex = NULL;
+}
@@ -0,0 +1,34 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "pake_v1_resume.h"
+#include "device_auth_defines.h"
+
+int32_t InitPakeV1ResumeCache(void)
+{
+    return HC_SUCCESS;
+}
+
+void DestroyPakeV1ResumeCache(void)
+{
+    return;
+}
+
+void RevokePakeV1ResumeTickets(const char *pkgName, const char *serviceType, const Uint8Buff *authIdPeer)
+{
+    (void)pkgName;
+    (void)serviceType;
+    (void)authIdPeer;
+}
@@ -17,6 +17,7 @@
 #include "alg_loader.h"
 #include "das_task_common.h"
 #include "hc_log.h"
+#include "pake_v1_resume.h"
 
 static int32_t RegisterLocalIdentity(const char *pkgName, const char *serviceType, Uint8Buff *authId, int userType)
 {
@@ -51,6 +52,7 @@ static int32_t RegisterLocalIdentity(const char *pkgName, const char *serviceTyp
 
 static int32_t UnregisterLocalIdentity(const char *pkgName, const char *serviceType, Uint8Buff *authId, int userType)
 {
+    RevokePakeV1ResumeTickets(pkgName, serviceType, NULL);
     const AlgLoader *loader = GetLoaderInstance();
     Uint8Buff pkgNameBuff = { (uint8_t *)pkgName, strlen(pkgName)};
     Uint8Buff serviceTypeBuff = { (uint8_t *)serviceType, strlen(serviceType) };
@@ -76,6 +78,7 @@ static int32_t UnregisterLocalIdentity(const char *pkgName, const char *serviceT
 
 static int32_t DeletePeerAuthInfo(const char *pkgName, const char *serviceType, Uint8Buff *authIdPeer, int userTypePeer)
 {
+    RevokePakeV1ResumeTickets(pkgName, serviceType, authIdPeer);
     const AlgLoader *loader = GetLoaderInstance();
     Uint8Buff pkgNameBuff = { (uint8_t *)pkgName, strlen(pkgName)};
     Uint8Buff serviceTypeBuff = { (uint8_t *)serviceType, strlen(serviceType) };
@@ -132,17 +135,6 @@ static int32_t ComputeAndSavePsk(const PakeParams *params)
         return res;
     }
 
-    res = params->baseParams.loader->checkKeyExist(&selfKeyAlias);
-    if (res != HC_SUCCESS) {
-        LOGE("self auth keyPair not exist");
-        return res;
-    }
-    res = params->baseParams.loader->checkKeyExist(&peerKeyAlias);
-    if (res != HC_SUCCESS) {
-        LOGE("peer auth pubKey not exist");
-        return res;
-    }
-
     uint8_t sharedKeyAliasVal[PAKE_KEY_ALIAS_LEN] = { 0 };
     Uint8Buff sharedKeyAlias = { sharedKeyAliasVal, PAKE_KEY_ALIAS_LEN };
     res = GenerateKeyAlias(&packageName, &serviceType, KEY_ALIAS_PSK, &(params->baseParams.idPeer), &sharedKeyAlias);
@@ -155,13 +147,14 @@ static int32_t ComputeAndSavePsk(const PakeParams *params)
         peerKeyAliasVal[0], peerKeyAliasVal[1], peerKeyAliasVal[2], peerKeyAliasVal[3],
         selfKeyAliasVal[0], selfKeyAliasVal[1], selfKeyAliasVal[2], selfKeyAliasVal[3],
         sharedKeyAliasVal[0], sharedKeyAliasVal[1], sharedKeyAliasVal[2], sharedKeyAliasVal[3]);
+    /* The agreement fails by itself if the self key pair or the peer public key does not exist. */
     KeyBuff selfKeyAliasBuff = { selfKeyAlias.val, selfKeyAlias.length, true };
     KeyBuff peerKeyAliasBuff = { peerKeyAlias.val, peerKeyAlias.length, true };
     Algorithm alg = (params->baseParams.curveType == CURVE_256) ? P256 : ED25519;
     res = params->baseParams.loader->agreeSharedSecretWithStorage(&selfKeyAliasBuff, &peerKeyAliasBuff, alg,
         PAKE_PSK_LEN, &sharedKeyAlias);
     if (res != HC_SUCCESS) {
-        LOGE("Agree psk failed.");
+        LOGE("Agree psk failed, res: %d.", res);
     }
 
     return res;
@@ -182,15 +175,9 @@ static int32_t GetPublicKey(const char *pkgName, const char *serviceType, Uint8B
         return res;
     }
 
-    res = loader->checkKeyExist(&keyAliasBuff);
-    if (res != HC_SUCCESS) {
-        LOGE("Key pair is not exist!");
-        return res;
-    }
-
     res = loader->exportPublicKey(&keyAliasBuff, returnPk);
     if (res != HC_SUCCESS) {
-        LOGE("Failed to export public key!");
+        LOGE("Failed to export public key, res: %d!", res);
         return res;
     }
     LOGI("Get public key successfully!");
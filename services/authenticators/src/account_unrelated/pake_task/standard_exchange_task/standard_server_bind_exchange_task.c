@@ -150,7 +150,7 @@ static int Process(struct AsyBaseCurTaskT *task, PakeParams *params, const CJson
     }
     return res;
 ERR:
-    FreeAndCleanKey(&(params->baseParams.sessionKey));
+    CleanArenaParam(&(params->baseParams.sessionKey));
     return res;
 }
 
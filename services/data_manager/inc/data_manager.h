@@ -61,6 +61,7 @@ typedef struct {
     const char *userId;
     int32_t groupType;
     int32_t groupVisibility;
+    const char *appId; /* only match the groups which can be accessed by the app */
 } QueryGroupParams;
 
 typedef struct {
@@ -69,6 +70,13 @@ typedef struct {
     const char *authId;
 } QueryDeviceParams;
 
+/*
+ * Borrowed views of database entries. The visitor runs with the database locked and must neither keep the entry
+ * nor call back into the data manager, its result is returned by VisitGroup or VisitDevice.
+ */
+typedef int32_t (*GroupEntryVisitor)(const TrustedGroupEntry *entry, void *ctx);
+typedef int32_t (*DeviceEntryVisitor)(const TrustedDeviceEntry *entry, void *ctx);
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -80,9 +88,43 @@ int32_t AddGroup(int32_t osAccountId, const TrustedGroupEntry *groupEntry);
 int32_t DelGroup(int32_t osAccountId, const QueryGroupParams *params);
 int32_t AddTrustedDevice(int32_t osAccountId, const TrustedDeviceEntry *deviceEntry);
 int32_t DelTrustedDevice(int32_t osAccountId, const QueryDeviceParams *params);
+/*
+ * The devices must belong to the same group, they are added under one lock and broadcast as one batch. A udid listed
+ * twice keeps its last entry. isNewEntries is optional, it gets a flag per entry which is set for the kept entries of
+ * devices the group did not trust yet. It is filled even if the batch fails, unless the batch can't be indexed.
+ */
+int32_t AddTrustedDevices(int32_t osAccountId, const DeviceEntryVec *deviceEntries, bool *isNewEntries);
+/* The removed entries of the group are moved to delEntries, the caller destroys them. */
+int32_t DelTrustedDevices(int32_t osAccountId, const char *groupId, const StringVector *authIds,
+    DeviceEntryVec *delEntries);
+/*
+ * Delete the group and all of its devices in one pass. The broadcasts are posted after the database is unlocked,
+ * the removed devices are moved to the empty delEntries for the caller to destroy, or destroyed if it is NULL.
+ */
+int32_t DelGroupCascade(int32_t osAccountId, const char *groupId, DeviceEntryVec *delEntries);
 int32_t QueryGroups(int32_t osAccountId, const QueryGroupParams *params, GroupEntryVec *vec);
 int32_t QueryDevices(int32_t osAccountId, const QueryDeviceParams *params, DeviceEntryVec *vec);
+/* Evaluated under the database lock without copying any entry. */
+bool ExistsGroup(int32_t osAccountId, const QueryGroupParams *params);
+bool ExistsDevice(int32_t osAccountId, const QueryDeviceParams *params);
+uint32_t CountDevices(int32_t osAccountId, const QueryDeviceParams *params);
+/* Visit the first matching entry, HC_ERR_GROUP_NOT_EXIST or HC_ERR_DEVICE_NOT_EXIST if there is none. */
+int32_t VisitGroup(int32_t osAccountId, const QueryGroupParams *params, GroupEntryVisitor visitor, void *ctx);
+int32_t VisitDevice(int32_t osAccountId, const QueryDeviceParams *params, DeviceEntryVisitor visitor, void *ctx);
+/* HC_SUCCESS if the group is public or the app manages or befriends it, otherwise the reason it can't be used. */
+int32_t CheckGroupAccess(int32_t osAccountId, const char *groupId, const char *appId);
+/* Remove the groups which are neither public nor managed or befriended by the app, in a single pass. */
+int32_t RemoveInaccessibleGroups(int32_t osAccountId, const char *appId, GroupEntryVec *vec);
 int32_t SaveOsAccountDb(int32_t osAccountId);
+/*
+ * Detach the cache of a removed os account under the lock and unlink its file, the entries are released by the
+ * calling thread after unlocking. Nothing is broadcast, the account is gone. The id is not remembered because the os
+ * account service reuses it, so a request of the account still queued on the HichainThread recreates the cache and
+ * may save the file again.
+ */
+void DropOsAccountDb(int32_t osAccountId);
+/* The generation changes whenever any group or device is added, replaced or deleted. */
+uint64_t GetDbGeneration(void);
 bool GenerateGroupEntryFromEntry(const TrustedGroupEntry *entry, TrustedGroupEntry *returnEntry);
 bool GenerateDeviceEntryFromEntry(const TrustedDeviceEntry *entry, TrustedDeviceEntry *returnEntry);
 
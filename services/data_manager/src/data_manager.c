@@ -15,7 +15,9 @@
 
 #include "data_manager.h"
 
+#include <stdlib.h>
 #include "broadcast_manager.h"
+#include "clib_types.h"
 #include "common_defs.h"
 #include "device_auth.h"
 #include "device_auth_defines.h"
@@ -107,10 +109,20 @@ END_TLV_STRUCT_DEFINE()
 IMPLEMENT_HC_VECTOR(GroupEntryVec, TrustedGroupEntry*, 1)
 IMPLEMENT_HC_VECTOR(DeviceEntryVec, TrustedDeviceEntry*, 1)
 
+/* One app which manages or befriends one group, the index keeps the keys sorted by appId and then groupId. */
+typedef struct {
+    HcString appId;
+    HcString groupId;
+} AppAccessKey;
+DECLARE_HC_VECTOR(AppAccessIndex, AppAccessKey)
+IMPLEMENT_HC_VECTOR(AppAccessIndex, AppAccessKey, 1)
+
 typedef struct {
     int32_t osAccountId;
     GroupEntryVec groups;
     DeviceEntryVec devices;
+    AppAccessIndex accessIndex;
+    bool isAccessIndexValid; /* false if the index failed to update, then the roles of each group are checked */
 } OsAccountTrustedInfo;
 
 DECLARE_HC_VECTOR(DeviceAuthDb, OsAccountTrustedInfo)
@@ -120,6 +132,8 @@ IMPLEMENT_HC_VECTOR(DeviceAuthDb, OsAccountTrustedInfo, 1)
 
 static HcMutex *g_databaseMutex = NULL;
 static DeviceAuthDb g_deviceauthDb;
+/* Bumped under g_databaseMutex on every mutation, so that readers can validate derived caches. */
+static uint64_t g_dbGeneration = 0;
 
 static bool EndWithZero(HcParcel *parcel)
 {
@@ -171,7 +185,184 @@ static bool SaveStringVectorToParcel(const StringVector *vec, HcParcel *parcel)
     return true;
 }
 
-static OsAccountTrustedInfo *GetTrustedInfoByOsAccountId(int32_t osAccountId)
+static bool IsStringInVector(const StringVector *vec, const char *str, uint32_t *foundIndex)
+{
+    uint32_t index;
+    HcString *item = NULL;
+    FOR_EACH_HC_VECTOR(*vec, index, item) {
+        const char *itemStr = StringGet(item);
+        if ((itemStr != NULL) && (strcmp(itemStr, str) == 0)) {
+            if (foundIndex != NULL) {
+                *foundIndex = index;
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+static int32_t CompareAccessKey(const AppAccessKey *key, const char *appId, const char *groupId)
+{
+    int32_t res = strcmp(StringGet(&key->appId), appId);
+    return (res != 0) ? res : strcmp(StringGet(&key->groupId), groupId);
+}
+
+/* Binary search, returns the position of the key or the position at which it has to be inserted. */
+static bool SearchAccessKey(const AppAccessIndex *accessIndex, const char *appId, const char *groupId,
+    uint32_t *position)
+{
+    uint32_t low = 0;
+    uint32_t high = HC_VECTOR_SIZE(accessIndex);
+    while (low < high) {
+        uint32_t mid = low + (high - low) / 2;
+        int32_t res = CompareAccessKey(HC_VECTOR_GETP(accessIndex, mid), appId, groupId);
+        if (res == 0) {
+            *position = mid;
+            return true;
+        }
+        if (res < 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    *position = low;
+    return false;
+}
+
+static void DestroyAccessKey(AppAccessKey *key)
+{
+    DeleteString(&key->appId);
+    DeleteString(&key->groupId);
+}
+
+static void ClearAccessIndex(AppAccessIndex *accessIndex)
+{
+    uint32_t index;
+    AppAccessKey *key = NULL;
+    FOR_EACH_HC_VECTOR(*accessIndex, index, key) {
+        DestroyAccessKey(key);
+    }
+    DESTROY_HC_VECTOR(AppAccessIndex, accessIndex);
+}
+
+static bool AddGroupIdToAccessIndex(AppAccessIndex *accessIndex, const char *appId, const char *groupId)
+{
+    uint32_t position = 0;
+    if (SearchAccessKey(accessIndex, appId, groupId, &position)) {
+        return true;
+    }
+    AppAccessKey newKey;
+    newKey.appId = CreateString();
+    newKey.groupId = CreateString();
+    if (!StringSetPointer(&newKey.appId, appId) || !StringSetPointer(&newKey.groupId, groupId) ||
+        (accessIndex->pushBackT(accessIndex, newKey) == NULL)) {
+        DestroyAccessKey(&newKey);
+        return false;
+    }
+    /* The key was appended, shift the greater keys up by one to insert it in order. */
+    uint32_t moveNum = HC_VECTOR_SIZE(accessIndex) - 1 - position;
+    AppAccessKey *target = HC_VECTOR_GETP(accessIndex, position);
+    if ((moveNum > 0) && (memmove_s(target + 1, moveNum * sizeof(AppAccessKey), target,
+        moveNum * sizeof(AppAccessKey)) != EOK)) {
+        AppAccessKey popKey;
+        (void)HC_VECTOR_POPELEMENT(accessIndex, &popKey, HC_VECTOR_SIZE(accessIndex) - 1);
+        DestroyAccessKey(&newKey);
+        return false;
+    }
+    *target = newKey;
+    return true;
+}
+
+static void RemoveGroupIdFromAccessIndex(AppAccessIndex *accessIndex, const char *appId, const char *groupId)
+{
+    uint32_t position = 0;
+    if (!SearchAccessKey(accessIndex, appId, groupId, &position)) {
+        return;
+    }
+    AppAccessKey popKey;
+    if (HC_VECTOR_POPELEMENT(accessIndex, &popKey, position)) {
+        DestroyAccessKey(&popKey);
+    }
+}
+
+static bool AddRolesToAccessIndex(AppAccessIndex *accessIndex, const StringVector *roles, const char *groupId)
+{
+    uint32_t index;
+    HcString *role = NULL;
+    FOR_EACH_HC_VECTOR(*roles, index, role) {
+        const char *roleAppId = StringGet(role);
+        if ((roleAppId != NULL) && !AddGroupIdToAccessIndex(accessIndex, roleAppId, groupId)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void RemoveRolesFromAccessIndex(AppAccessIndex *accessIndex, const StringVector *roles, const char *groupId)
+{
+    uint32_t index;
+    HcString *role = NULL;
+    FOR_EACH_HC_VECTOR(*roles, index, role) {
+        const char *roleAppId = StringGet(role);
+        if (roleAppId != NULL) {
+            RemoveGroupIdFromAccessIndex(accessIndex, roleAppId, groupId);
+        }
+    }
+}
+
+static void IndexGroupAccess(OsAccountTrustedInfo *info, const TrustedGroupEntry *entry)
+{
+    const char *groupId = StringGet(&entry->id);
+    if (!info->isAccessIndexValid || (groupId == NULL)) {
+        return;
+    }
+    if (!AddRolesToAccessIndex(&info->accessIndex, &entry->managers, groupId) ||
+        !AddRolesToAccessIndex(&info->accessIndex, &entry->friends, groupId)) {
+        LOGE("[DB]: Failed to update access index, fall back to check group roles!");
+        info->isAccessIndexValid = false;
+    }
+}
+
+static void UnindexGroupAccess(OsAccountTrustedInfo *info, const TrustedGroupEntry *entry)
+{
+    const char *groupId = StringGet(&entry->id);
+    if (!info->isAccessIndexValid || (groupId == NULL)) {
+        return;
+    }
+    RemoveRolesFromAccessIndex(&info->accessIndex, &entry->managers, groupId);
+    RemoveRolesFromAccessIndex(&info->accessIndex, &entry->friends, groupId);
+}
+
+static void BuildAccessIndex(OsAccountTrustedInfo *info)
+{
+    info->accessIndex = CREATE_HC_VECTOR(AppAccessIndex);
+    info->isAccessIndexValid = true;
+    uint32_t index;
+    TrustedGroupEntry **entry = NULL;
+    FOR_EACH_HC_VECTOR(info->groups, index, entry) {
+        if ((entry != NULL) && (*entry != NULL)) {
+            IndexGroupAccess(info, *entry);
+        }
+    }
+}
+
+static bool IsGroupAccessibleByApp(const OsAccountTrustedInfo *info, const char *appId,
+    const TrustedGroupEntry *entry)
+{
+    if (entry->visibility == GROUP_VISIBILITY_PUBLIC) {
+        return true;
+    }
+    if (!info->isAccessIndexValid) {
+        return IsStringInVector(&entry->managers, appId, NULL) || IsStringInVector(&entry->friends, appId, NULL);
+    }
+    const char *groupId = StringGet(&entry->id);
+    uint32_t position = 0;
+    return (groupId != NULL) && SearchAccessKey(&info->accessIndex, appId, groupId, &position);
+}
+
+/* Unlike GetTrustedInfoByOsAccountId, never creates the cache of an unknown os account. */
+static OsAccountTrustedInfo *FindTrustedInfoByOsAccountId(int32_t osAccountId)
 {
     uint32_t index = 0;
     OsAccountTrustedInfo *info = NULL;
@@ -180,16 +371,27 @@ static OsAccountTrustedInfo *GetTrustedInfoByOsAccountId(int32_t osAccountId)
             return info;
         }
     }
+    return NULL;
+}
+
+static OsAccountTrustedInfo *GetTrustedInfoByOsAccountId(int32_t osAccountId)
+{
+    OsAccountTrustedInfo *info = FindTrustedInfoByOsAccountId(osAccountId);
+    if (info != NULL) {
+        return info;
+    }
     LOGI("[DB]: Create a new os account database cache! [Id]: %d", osAccountId);
     OsAccountTrustedInfo newInfo;
     newInfo.osAccountId = osAccountId;
     newInfo.groups = CreateGroupEntryVec();
     newInfo.devices = CreateDeviceEntryVec();
+    BuildAccessIndex(&newInfo);
     OsAccountTrustedInfo *returnInfo = g_deviceauthDb.pushBackT(&g_deviceauthDb, newInfo);
     if (returnInfo == NULL) {
         LOGE("[DB]: Failed to push osAccountInfo to database!");
         DestroyGroupEntryVec(&newInfo.groups);
         DestroyDeviceEntryVec(&newInfo.devices);
+        ClearAccessIndex(&newInfo.accessIndex);
     }
     return returnInfo;
 }
@@ -352,6 +554,7 @@ static bool LoadGroups(HCDataBaseV1 *db, GroupEntryVec *vec)
 {
     uint32_t index;
     TlvGroupElement *group = NULL;
+    (void)vec->reserve(vec, db->groups.data.size(&db->groups.data));
     FOR_EACH_HC_VECTOR(db->groups.data, index, group) {
         TrustedGroupEntry *entry = CreateGroupEntry();
         if (entry == NULL) {
@@ -378,6 +581,7 @@ static bool LoadDevices(HCDataBaseV1 *db, DeviceEntryVec *vec)
 {
     uint32_t index;
     TlvDeviceElement *device = NULL;
+    (void)vec->reserve(vec, db->devices.data.size(&db->devices.data));
     FOR_EACH_HC_VECTOR(db->devices.data, index, device) {
         TrustedDeviceEntry *entry = CreateDeviceEntry();
         if (entry == NULL) {
@@ -481,10 +685,12 @@ static void LoadOsAccountDb(int32_t osAccountId)
         return;
     }
     DeleteParcel(&parcel);
+    BuildAccessIndex(&info);
     if (g_deviceauthDb.pushBackT(&g_deviceauthDb, info) == NULL) {
         LOGE("[DB]: Failed to push osAccountInfo to database!");
         ClearGroupEntryVec(&info.groups);
         ClearDeviceEntryVec(&info.devices);
+        ClearAccessIndex(&info.accessIndex);
     }
     LOGI("[DB]: Load os account db successfully! [Id]: %d", osAccountId);
 }
@@ -578,6 +784,7 @@ static bool SaveGroups(const GroupEntryVec *vec, HCDataBaseV1 *db)
 {
     uint32_t index;
     TrustedGroupEntry **entry;
+    (void)db->groups.data.reserve(&db->groups.data, vec->size(vec));
     FOR_EACH_HC_VECTOR(*vec, index, entry) {
         TlvGroupElement tmp;
         TlvGroupElement *element = db->groups.data.pushBack(&db->groups.data, &tmp);
@@ -597,6 +804,7 @@ static bool SaveDevices(const DeviceEntryVec *vec, HCDataBaseV1 *db)
 {
     uint32_t index;
     TrustedDeviceEntry **entry;
+    (void)db->devices.data.reserve(&db->devices.data, vec->size(vec));
     FOR_EACH_HC_VECTOR(*vec, index, entry) {
         TlvDeviceElement tmp;
         TlvDeviceElement *element = db->devices.data.pushBack(&db->devices.data, &tmp);
@@ -685,6 +893,15 @@ static bool CompareQueryGroupParams(const QueryGroupParams *params, const Truste
     return true;
 }
 
+static bool IsGroupMatched(const OsAccountTrustedInfo *info, const QueryGroupParams *params,
+    const TrustedGroupEntry *entry)
+{
+    if (!CompareQueryGroupParams(params, entry)) {
+        return false;
+    }
+    return (params->appId == NULL) || IsGroupAccessibleByApp(info, params->appId, entry);
+}
+
 static bool CompareQueryDeviceParams(const QueryDeviceParams *params, const TrustedDeviceEntry *entry)
 {
     if ((params->groupId != NULL) && (strcmp(params->groupId, StringGet(&entry->groupId)) != 0)) {
@@ -772,6 +989,183 @@ static void PostDeviceUnBoundMsg(OsAccountTrustedInfo *info, const TrustedDevice
     }
 }
 
+/* The group is copied under the lock, so that a batch can be broadcast after the database is unlocked. */
+static TrustedGroupEntry *CopyGroupToPost(const OsAccountTrustedInfo *info, const char *groupId)
+{
+    if (!IsBroadcastSupported()) {
+        return NULL;
+    }
+    QueryGroupParams groupParams = InitQueryGroupParams();
+    groupParams.groupId = groupId;
+    TrustedGroupEntry **groupEntryPtr = QueryGroupEntryPtrIfMatch(&info->groups, &groupParams);
+    if (groupEntryPtr == NULL) {
+        return NULL;
+    }
+    TrustedGroupEntry *groupEntry = DeepCopyGroupEntry(*groupEntryPtr);
+    if (groupEntry == NULL) {
+        LOGE("[DB]: Failed to copy the group to broadcast!");
+    }
+    return groupEntry;
+}
+
+#define BATCH_KEY_NOT_MATCHED UINT32_MAX
+
+/* A key of a batch with the position of its entry, the keys are sorted to match the batch in one database pass. */
+typedef struct {
+    const char *key;
+    uint32_t position;
+    uint32_t matchedPosition;
+} BatchKey;
+
+/* Equal keys keep the batch order, so the last of them is the entry a key listed twice keeps. */
+static int CompareBatchKey(const void *left, const void *right)
+{
+    const BatchKey *leftKey = (const BatchKey *)left;
+    const BatchKey *rightKey = (const BatchKey *)right;
+    int res = strcmp(leftKey->key, rightKey->key);
+    if (res != 0) {
+        return res;
+    }
+    return (leftKey->position < rightKey->position) ? -1 : (int)(leftKey->position > rightKey->position);
+}
+
+/* Sorts the keys and keeps the last position of each one, returns the number of keys kept. */
+static uint32_t SortBatchKeys(BatchKey *keys, uint32_t num)
+{
+    qsort(keys, num, sizeof(BatchKey), CompareBatchKey);
+    uint32_t keptNum = 0;
+    for (uint32_t i = 0; i < num; i++) {
+        if ((i + 1 < num) && (strcmp(keys[i].key, keys[i + 1].key) == 0)) {
+            continue;
+        }
+        keys[keptNum++] = keys[i];
+    }
+    return keptNum;
+}
+
+static BatchKey *SearchBatchKey(BatchKey *keys, uint32_t num, const char *key)
+{
+    uint32_t low = 0;
+    uint32_t high = num;
+    while (low < high) {
+        uint32_t mid = low + (high - low) / 2;
+        int32_t res = strcmp(keys[mid].key, key);
+        if (res == 0) {
+            return &keys[mid];
+        }
+        if (res < 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return NULL;
+}
+
+static BatchKey *AllocBatchKeys(uint32_t num)
+{
+    if ((num == 0) || (num > CLIB_MAX_MALLOC_SIZE / sizeof(BatchKey))) {
+        LOGE("[DB]: Invalid number of batch keys! [Num]: %u", num);
+        return NULL;
+    }
+    BatchKey *keys = (BatchKey *)HcMalloc(num * sizeof(BatchKey), 0);
+    if (keys == NULL) {
+        LOGE("[DB]: Failed to allocate batch keys memory! [Num]: %u", num);
+    }
+    return keys;
+}
+
+/* The udids of the entries must be set, they are borrowed by the keys. */
+static BatchKey *CreateUdidKeys(const DeviceEntryVec *entries, uint32_t *keyNum)
+{
+    uint32_t num = HC_VECTOR_SIZE(entries);
+    BatchKey *keys = AllocBatchKeys(num);
+    if (keys == NULL) {
+        return NULL;
+    }
+    for (uint32_t i = 0; i < num; i++) {
+        keys[i].key = StringGet(&HC_VECTOR_GET(entries, i)->udid);
+        keys[i].position = i;
+        keys[i].matchedPosition = BATCH_KEY_NOT_MATCHED;
+    }
+    *keyNum = SortBatchKeys(keys, num);
+    return keys;
+}
+
+static void QueryUntrustedUdids(const OsAccountTrustedInfo *info, const DeviceEntryVec *delEntries,
+    StringVector *udids)
+{
+    uint32_t index;
+    TrustedDeviceEntry **delEntry = NULL;
+    FOR_EACH_HC_VECTOR(*delEntries, index, delEntry) {
+        QueryDeviceParams params = InitQueryDeviceParams();
+        params.udid = StringGet(&(*delEntry)->udid);
+        if (QueryDeviceEntryPtrIfMatch(&info->devices, &params) != NULL) {
+            continue;
+        }
+        HcString udid = CreateString();
+        if (!StringSetPointer(&udid, params.udid) || (udids->pushBackT(udids, udid) == NULL)) {
+            LOGE("[DB]: Failed to record an untrusted udid!");
+            DeleteString(&udid);
+        }
+    }
+}
+
+/*
+ * Must be called with the database locked, after the devices have been removed. The deleted udids are matched in one
+ * pass over the database, without the memory to sort them each one is queried on its own.
+ */
+static void CollectUntrustedUdids(const OsAccountTrustedInfo *info, const DeviceEntryVec *delEntries,
+    StringVector *udids)
+{
+    if (HC_VECTOR_SIZE(delEntries) == 0) {
+        return;
+    }
+    uint32_t keyNum = 0;
+    BatchKey *keys = CreateUdidKeys(delEntries, &keyNum);
+    if (keys == NULL) {
+        QueryUntrustedUdids(info, delEntries, udids);
+        return;
+    }
+    uint32_t index;
+    TrustedDeviceEntry **entry = NULL;
+    FOR_EACH_HC_VECTOR(info->devices, index, entry) {
+        BatchKey *key = SearchBatchKey(keys, keyNum, StringGet(&(*entry)->udid));
+        if (key != NULL) {
+            key->matchedPosition = index;
+        }
+    }
+    /* Collected in the order of delEntries, a udid deleted twice is collected once. */
+    FOR_EACH_HC_VECTOR(*delEntries, index, entry) {
+        const char *delUdid = StringGet(&(*entry)->udid);
+        BatchKey *key = SearchBatchKey(keys, keyNum, delUdid);
+        if ((key == NULL) || (key->position != index) || (key->matchedPosition != BATCH_KEY_NOT_MATCHED)) {
+            continue;
+        }
+        HcString udid = CreateString();
+        if (!StringSetPointer(&udid, delUdid) || (udids->pushBackT(udids, udid) == NULL)) {
+            LOGE("[DB]: Failed to record an untrusted udid!");
+            DeleteString(&udid);
+        }
+    }
+    HcFree(keys);
+}
+
+/* Posted as the per-device deletions used to post them, each unbound device is followed by its not-trusted one. */
+static void PostDevicesUnBoundAndNotTrustedMsg(const TrustedGroupEntry *groupEntry, const DeviceEntryVec *delEntries,
+    const StringVector *untrustedUdids)
+{
+    if (groupEntry != NULL) {
+        GetBroadcaster()->postOnDevicesUnBound(delEntries, groupEntry, untrustedUdids);
+        return;
+    }
+    uint32_t index;
+    HcString *udid = NULL;
+    FOR_EACH_HC_VECTOR(*untrustedUdids, index, udid) {
+        GetBroadcaster()->postOnDeviceNotTrusted(StringGet(udid));
+    }
+}
+
 QueryGroupParams InitQueryGroupParams(void)
 {
     QueryGroupParams params = {
@@ -780,7 +1174,8 @@ QueryGroupParams InitQueryGroupParams(void)
         .ownerName = NULL,
         .userId = NULL,
         .groupType = ALL_GROUP,
-        .groupVisibility = ALL_GROUP_VISIBILITY
+        .groupVisibility = ALL_GROUP_VISIBILITY,
+        .appId = NULL
     };
     return params;
 }
@@ -917,8 +1312,11 @@ int32_t AddGroup(int32_t osAccountId, const TrustedGroupEntry *groupEntry)
     params.groupId = StringGet(&groupEntry->id);
     TrustedGroupEntry **oldEntryPtr = QueryGroupEntryPtrIfMatch(&info->groups, &params);
     if (oldEntryPtr != NULL) {
+        UnindexGroupAccess(info, *oldEntryPtr);
         DestroyGroupEntry(*oldEntryPtr);
         *oldEntryPtr = newEntry;
+        IndexGroupAccess(info, newEntry);
+        g_dbGeneration++;
         PostGroupCreatedMsg(newEntry);
         g_databaseMutex->unlock(g_databaseMutex);
         LOGI("[DB]: Replace an old group successfully! [GroupType]: %d", groupEntry->type);
@@ -930,6 +1328,8 @@ int32_t AddGroup(int32_t osAccountId, const TrustedGroupEntry *groupEntry)
         LOGE("[DB]: Failed to push groupEntry to vec!");
         return HC_ERR_MEMORY_COPY;
     }
+    IndexGroupAccess(info, newEntry);
+    g_dbGeneration++;
     PostGroupCreatedMsg(newEntry);
     g_databaseMutex->unlock(g_databaseMutex);
     LOGI("[DB]: Add a group to database successfully! [GroupType]: %d", groupEntry->type);
@@ -961,6 +1361,7 @@ int32_t AddTrustedDevice(int32_t osAccountId, const TrustedDeviceEntry *deviceEn
     if (oldEntryPtr != NULL) {
         DestroyDeviceEntry(*oldEntryPtr);
         *oldEntryPtr = newEntry;
+        g_dbGeneration++;
         PostDeviceBoundMsg(info, newEntry);
         g_databaseMutex->unlock(g_databaseMutex);
         LOGI("[DB]: Replace an old trusted device successfully!");
@@ -972,6 +1373,7 @@ int32_t AddTrustedDevice(int32_t osAccountId, const TrustedDeviceEntry *deviceEn
         LOGE("[DB]: Failed to push deviceEntry to vec!");
         return HC_ERR_MEMORY_COPY;
     }
+    g_dbGeneration++;
     PostDeviceBoundMsg(info, newEntry);
     g_databaseMutex->unlock(g_databaseMutex);
     LOGI("[DB]: Add a trusted device to database successfully!");
@@ -996,12 +1398,14 @@ int32_t DelGroup(int32_t osAccountId, const QueryGroupParams *params)
     TrustedGroupEntry **entry = NULL;
     while (index < HC_VECTOR_SIZE(&info->groups)) {
         entry = info->groups.getp(&info->groups, index);
-        if ((entry == NULL) || (*entry == NULL) || (!CompareQueryGroupParams(params, *entry))) {
+        if ((entry == NULL) || (*entry == NULL) || (!IsGroupMatched(info, params, *entry))) {
             index++;
             continue;
         }
         TrustedGroupEntry *popEntry;
         HC_VECTOR_POPELEMENT(&info->groups, &popEntry, index);
+        UnindexGroupAccess(info, popEntry);
+        g_dbGeneration++;
         PostGroupDeletedMsg(popEntry);
         LOGI("[DB]: Delete a group from database successfully! [GroupType]: %d", popEntry->type);
         DestroyGroupEntry(popEntry);
@@ -1036,6 +1440,7 @@ int32_t DelTrustedDevice(int32_t osAccountId, const QueryDeviceParams *params)
         }
         TrustedDeviceEntry *popEntry;
         HC_VECTOR_POPELEMENT(&info->devices, &popEntry, index);
+        g_dbGeneration++;
         PostDeviceUnBoundMsg(info, popEntry);
         LOGI("[DB]: Delete a trusted device from database successfully!");
         DestroyDeviceEntry(popEntry);
@@ -1046,6 +1451,410 @@ int32_t DelTrustedDevice(int32_t osAccountId, const QueryDeviceParams *params)
     return HC_SUCCESS;
 }
 
+/*
+ * The batch needs the whole capacity up front to be added atomically. Growing one push at a time would hit the
+ * same CLIB_MAX_MALLOC_SIZE limit of a vector, only halfway through the batch.
+ */
+static bool ReserveDeviceEntries(DeviceEntryVec *vec, uint32_t count)
+{
+    if (HC_VECTOR_RESERVE(vec, count)) {
+        return true;
+    }
+    if (count > CLIB_MAX_MALLOC_SIZE / sizeof(TrustedDeviceEntry *)) {
+        LOGE("[DB]: Too many device entries for one vector! [Num]: %u, [MaxNum]: %u", count,
+            (uint32_t)(CLIB_MAX_MALLOC_SIZE / sizeof(TrustedDeviceEntry *)));
+    } else {
+        LOGE("[DB]: Failed to reserve memory for device entries! [Num]: %u", count);
+    }
+    return false;
+}
+
+/* Every entry of a batch needs a udid and must belong to the group of the batch. */
+static bool IsDeviceBatchValid(const DeviceEntryVec *deviceEntries, const char *groupId)
+{
+    uint32_t index;
+    TrustedDeviceEntry **entry = NULL;
+    FOR_EACH_HC_VECTOR(*deviceEntries, index, entry) {
+        const char *entryGroupId = (*entry != NULL) ? StringGet(&(*entry)->groupId) : NULL;
+        if ((entryGroupId == NULL) || (strcmp(entryGroupId, groupId) != 0)) {
+            LOGE("[DB]: The devices of a batch must belong to the same group!");
+            return false;
+        }
+        if (StringGet(&(*entry)->udid) == NULL) {
+            LOGE("[DB]: The udid of a device in the batch is NULL!");
+            return false;
+        }
+    }
+    return true;
+}
+
+/* The devices to add, indexed by udid. A udid listed twice keeps its last entry, the others are dropped. */
+typedef struct {
+    BatchKey *udids;
+    uint32_t udidNum;
+    /* The copies by batch position, NULL for the dropped entries. */
+    TrustedDeviceEntry **copies;
+    /* The entries of the caller which are kept, in batch order, to be broadcast after the database is unlocked. */
+    DeviceEntryVec boundEntries;
+} DeviceBatch;
+
+static void DestroyDeviceBatch(DeviceBatch *batch, uint32_t count)
+{
+    if (batch->copies != NULL) {
+        for (uint32_t i = 0; i < count; i++) {
+            if (batch->copies[i] != NULL) {
+                DestroyDeviceEntry(batch->copies[i]);
+            }
+        }
+        HcFree(batch->copies);
+    }
+    HcFree(batch->udids);
+    /* The bound entries are owned by the caller. */
+    DESTROY_HC_VECTOR(DeviceEntryVec, &batch->boundEntries);
+}
+
+/*
+ * All the copies are made before the database is locked, so a failed batch leaves the database untouched. The udids
+ * are the only part a failed batch can still be matched with, they are set even if the rest fails.
+ */
+static int32_t CreateDeviceBatch(const DeviceEntryVec *deviceEntries, DeviceBatch *batch)
+{
+    uint32_t count = HC_VECTOR_SIZE(deviceEntries);
+    batch->copies = NULL;
+    batch->boundEntries = CreateDeviceEntryVec();
+    batch->udids = CreateUdidKeys(deviceEntries, &batch->udidNum);
+    if (batch->udids == NULL) {
+        return HC_ERR_ALLOC_MEMORY;
+    }
+    batch->copies = (TrustedDeviceEntry **)HcMalloc(count * sizeof(TrustedDeviceEntry *), 0);
+    if ((batch->copies == NULL) || !ReserveDeviceEntries(&batch->boundEntries, batch->udidNum)) {
+        LOGE("[DB]: Failed to allocate device batch memory!");
+        return HC_ERR_ALLOC_MEMORY;
+    }
+    for (uint32_t i = 0; i < batch->udidNum; i++) {
+        uint32_t position = batch->udids[i].position;
+        batch->copies[position] = DeepCopyDeviceEntry(HC_VECTOR_GET(deviceEntries, position));
+        if (batch->copies[position] == NULL) {
+            return HC_ERR_MEMORY_COPY;
+        }
+    }
+    /* The capacity has been reserved, the pushes below do not reallocate. */
+    for (uint32_t i = 0; i < count; i++) {
+        if (batch->copies[i] != NULL) {
+            (void)batch->boundEntries.pushBackT(&batch->boundEntries, HC_VECTOR_GET(deviceEntries, i));
+        }
+    }
+    return HC_SUCCESS;
+}
+
+/* One pass over the database finds the trusted device of the group which each udid of the batch replaces. */
+static uint32_t MatchOldDevices(const OsAccountTrustedInfo *info, const char *groupId, DeviceBatch *batch)
+{
+    uint32_t matchedNum = 0;
+    uint32_t index;
+    TrustedDeviceEntry **entry = NULL;
+    FOR_EACH_HC_VECTOR(info->devices, index, entry) {
+        if (strcmp(StringGet(&(*entry)->groupId), groupId) != 0) {
+            continue;
+        }
+        BatchKey *key = SearchBatchKey(batch->udids, batch->udidNum, StringGet(&(*entry)->udid));
+        if ((key != NULL) && (key->matchedPosition == BATCH_KEY_NOT_MATCHED)) {
+            key->matchedPosition = index;
+            matchedNum++;
+        }
+    }
+    return matchedNum;
+}
+
+static void MarkNewEntries(const DeviceBatch *batch, bool *isNewEntries)
+{
+    if (isNewEntries == NULL) {
+        return;
+    }
+    for (uint32_t i = 0; i < batch->udidNum; i++) {
+        isNewEntries[batch->udids[i].position] = (batch->udids[i].matchedPosition == BATCH_KEY_NOT_MATCHED);
+    }
+}
+
+/* The old devices are replaced in place and the new ones appended in batch order, into the reserved capacity. */
+static void MoveBatchToDatabase(OsAccountTrustedInfo *info, DeviceBatch *batch, uint32_t count)
+{
+    for (uint32_t i = 0; i < batch->udidNum; i++) {
+        const BatchKey *key = &batch->udids[i];
+        if (key->matchedPosition == BATCH_KEY_NOT_MATCHED) {
+            continue;
+        }
+        TrustedDeviceEntry **oldEntry = HC_VECTOR_GETP(&info->devices, key->matchedPosition);
+        DestroyDeviceEntry(*oldEntry);
+        *oldEntry = batch->copies[key->position];
+        batch->copies[key->position] = NULL;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        if (batch->copies[i] != NULL) {
+            (void)info->devices.pushBackT(&info->devices, batch->copies[i]);
+            batch->copies[i] = NULL;
+        }
+    }
+}
+
+/* The database is left untouched unless the new devices all fit in, they are appended into the reserved capacity. */
+static int32_t AddDeviceBatch(OsAccountTrustedInfo *info, DeviceBatch *batch, uint32_t count, uint32_t matchedNum)
+{
+    if (!ReserveDeviceEntries(&info->devices, HC_VECTOR_SIZE(&info->devices) + batch->udidNum - matchedNum)) {
+        return HC_ERR_ALLOC_MEMORY;
+    }
+    MoveBatchToDatabase(info, batch, count);
+    return HC_SUCCESS;
+}
+
+/* Posted without the database lock, the group is the copy made under it. */
+static void PostDevicesBoundMsg(const TrustedGroupEntry *groupEntry, const DeviceEntryVec *deviceEntries)
+{
+    if (groupEntry != NULL) {
+        GetBroadcaster()->postOnDevicesBound(deviceEntries, groupEntry);
+    }
+}
+
+int32_t AddTrustedDevices(int32_t osAccountId, const DeviceEntryVec *deviceEntries, bool *isNewEntries)
+{
+    LOGI("[DB]: Start to add trusted devices to database!");
+    uint32_t count = (deviceEntries != NULL) ? HC_VECTOR_SIZE(deviceEntries) : 0;
+    if (count == 0) {
+        LOGE("[DB]: The input deviceEntries is empty!");
+        return HC_ERR_INVALID_PARAMS;
+    }
+    if (isNewEntries != NULL) {
+        (void)memset_s(isNewEntries, count * sizeof(bool), 0, count * sizeof(bool));
+    }
+    const TrustedDeviceEntry *firstEntry = HC_VECTOR_GET(deviceEntries, 0);
+    const char *groupId = (firstEntry != NULL) ? StringGet(&firstEntry->groupId) : NULL;
+    if ((groupId == NULL) || !IsDeviceBatchValid(deviceEntries, groupId)) {
+        return HC_ERR_INVALID_PARAMS;
+    }
+    DeviceBatch batch;
+    int32_t res = CreateDeviceBatch(deviceEntries, &batch);
+    if (batch.udids == NULL) {
+        DestroyDeviceBatch(&batch, count);
+        return res;
+    }
+    g_databaseMutex->lock(g_databaseMutex);
+    OsAccountTrustedInfo *info = GetTrustedInfoByOsAccountId(osAccountId);
+    /* The udids are matched before a failed copy is reported, so isNewEntries also tells a failed batch apart. */
+    uint32_t matchedNum = (info != NULL) ? MatchOldDevices(info, groupId, &batch) : 0;
+    MarkNewEntries(&batch, isNewEntries);
+    if (res == HC_SUCCESS) {
+        res = (info != NULL) ? AddDeviceBatch(info, &batch, count, matchedNum) : HC_ERR_INVALID_PARAMS;
+    }
+    if (res != HC_SUCCESS) {
+        g_databaseMutex->unlock(g_databaseMutex);
+        DestroyDeviceBatch(&batch, count);
+        return res;
+    }
+    g_dbGeneration++;
+    TrustedGroupEntry *groupEntry = CopyGroupToPost(info, groupId);
+    g_databaseMutex->unlock(g_databaseMutex);
+    PostDevicesBoundMsg(groupEntry, &batch.boundEntries);
+    if (groupEntry != NULL) {
+        DestroyGroupEntry(groupEntry);
+    }
+    LOGI("[DB]: Add trusted devices to database successfully! [Num]: %u, [ReplacedNum]: %u", batch.udidNum,
+        matchedNum);
+    DestroyDeviceBatch(&batch, count);
+    return HC_SUCCESS;
+}
+
+/* The authIds are borrowed by the keys, the ones which are not set are skipped. */
+static BatchKey *CreateAuthIdKeys(const StringVector *authIds, uint32_t *keyNum)
+{
+    BatchKey *keys = AllocBatchKeys(HC_VECTOR_SIZE(authIds));
+    if (keys == NULL) {
+        return NULL;
+    }
+    uint32_t num = 0;
+    uint32_t index;
+    HcString *authId = NULL;
+    FOR_EACH_HC_VECTOR(*authIds, index, authId) {
+        if (StringGet(authId) == NULL) {
+            continue;
+        }
+        keys[num].key = StringGet(authId);
+        keys[num].position = num;
+        keys[num].matchedPosition = BATCH_KEY_NOT_MATCHED;
+        num++;
+    }
+    *keyNum = SortBatchKeys(keys, num);
+    return keys;
+}
+
+/* Without authIds all the devices of the group are removed. */
+static bool IsDeviceToRemove(const TrustedDeviceEntry *entry, const char *groupId, BatchKey *authIds,
+    uint32_t authIdNum)
+{
+    if (strcmp(StringGet(&entry->groupId), groupId) != 0) {
+        return false;
+    }
+    if (authIds == NULL) {
+        return true;
+    }
+    const char *authId = StringGet(&entry->authId);
+    return (authId != NULL) && (SearchBatchKey(authIds, authIdNum, authId) != NULL);
+}
+
+/*
+ * One pass moves the devices to remove to delEntries and compacts the others in place, keeping their order. The
+ * capacity of delEntries must have been reserved, so that the pushes can't fail halfway.
+ */
+static void RemoveMatchedDevices(OsAccountTrustedInfo *info, const char *groupId, BatchKey *authIds,
+    uint32_t authIdNum, DeviceEntryVec *delEntries)
+{
+    uint32_t count = HC_VECTOR_SIZE(&info->devices);
+    uint32_t keptNum = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        TrustedDeviceEntry *entry = HC_VECTOR_GET(&info->devices, i);
+        if (IsDeviceToRemove(entry, groupId, authIds, authIdNum)) {
+            (void)delEntries->pushBackT(delEntries, entry);
+        } else {
+            *HC_VECTOR_GETP(&info->devices, keptNum++) = entry;
+        }
+    }
+    (void)HC_VECTOR_TRUNCATE(&info->devices, keptNum);
+}
+
+/* The capacity covers all the devices of the account, so none of the removed ones can be left without an owner. */
+static bool ReserveDelEntries(const OsAccountTrustedInfo *info, DeviceEntryVec *delEntries)
+{
+    return ReserveDeviceEntries(delEntries, HC_VECTOR_SIZE(delEntries) + HC_VECTOR_SIZE(&info->devices));
+}
+
+int32_t DelTrustedDevices(int32_t osAccountId, const char *groupId, const StringVector *authIds,
+    DeviceEntryVec *delEntries)
+{
+    LOGI("[DB]: Start to delete trusted devices from database!");
+    if ((groupId == NULL) || (authIds == NULL) || (delEntries == NULL)) {
+        LOGE("[DB]: The input params contains NULL value!");
+        return HC_ERR_NULL_PTR;
+    }
+    if (HC_VECTOR_SIZE(authIds) == 0) {
+        return HC_SUCCESS;
+    }
+    uint32_t keyNum = 0;
+    BatchKey *keys = CreateAuthIdKeys(authIds, &keyNum);
+    if (keys == NULL) {
+        return HC_ERR_ALLOC_MEMORY;
+    }
+    StringVector untrustedUdids = CreateStrVector();
+    g_databaseMutex->lock(g_databaseMutex);
+    OsAccountTrustedInfo *info = GetTrustedInfoByOsAccountId(osAccountId);
+    int32_t res = (info != NULL) ? HC_SUCCESS : HC_ERR_INVALID_PARAMS;
+    if ((info != NULL) && !ReserveDelEntries(info, delEntries)) {
+        res = HC_ERR_ALLOC_MEMORY;
+    }
+    if (res != HC_SUCCESS) {
+        g_databaseMutex->unlock(g_databaseMutex);
+        DestroyStrVector(&untrustedUdids);
+        HcFree(keys);
+        return res;
+    }
+    RemoveMatchedDevices(info, groupId, keys, keyNum, delEntries);
+    uint32_t count = HC_VECTOR_SIZE(delEntries);
+    TrustedGroupEntry *groupEntry = NULL;
+    if (count > 0) {
+        g_dbGeneration++;
+        groupEntry = CopyGroupToPost(info, groupId);
+        if (IsBroadcastSupported()) {
+            CollectUntrustedUdids(info, delEntries, &untrustedUdids);
+        }
+    }
+    g_databaseMutex->unlock(g_databaseMutex);
+    HcFree(keys);
+    if ((count > 0) && IsBroadcastSupported()) {
+        PostDevicesUnBoundAndNotTrustedMsg(groupEntry, delEntries, &untrustedUdids);
+    }
+    DestroyStrVector(&untrustedUdids);
+    if (groupEntry != NULL) {
+        DestroyGroupEntry(groupEntry);
+    }
+    LOGI("[DB]: Number of trusted devices deleted: %u", count);
+    return HC_SUCCESS;
+}
+
+/* The capacity of delEntries is reserved before any device is removed, so a failure leaves the database unchanged. */
+static int32_t RemoveGroupDevices(OsAccountTrustedInfo *info, const char *groupId, DeviceEntryVec *delEntries)
+{
+    if (!ReserveDelEntries(info, delEntries)) {
+        return HC_ERR_ALLOC_MEMORY;
+    }
+    RemoveMatchedDevices(info, groupId, NULL, 0, delEntries);
+    return HC_SUCCESS;
+}
+
+static TrustedGroupEntry *RemoveGroupById(OsAccountTrustedInfo *info, const char *groupId)
+{
+    uint32_t index;
+    TrustedGroupEntry **entry = NULL;
+    FOR_EACH_HC_VECTOR(info->groups, index, entry) {
+        if (strcmp(StringGet(&(*entry)->id), groupId) == 0) {
+            TrustedGroupEntry *popEntry;
+            HC_VECTOR_POPELEMENT(&info->groups, &popEntry, index);
+            UnindexGroupAccess(info, popEntry);
+            return popEntry;
+        }
+    }
+    return NULL;
+}
+
+/* Posted without the database lock, in the order the per-entry deletions used to post them. */
+static void PostGroupCascadeMsg(const TrustedGroupEntry *groupEntry, const DeviceEntryVec *delEntries,
+    const StringVector *untrustedUdids)
+{
+    if (!IsBroadcastSupported()) {
+        return;
+    }
+    PostDevicesUnBoundAndNotTrustedMsg(groupEntry, delEntries, untrustedUdids);
+    if (groupEntry != NULL) {
+        GetBroadcaster()->postOnGroupDeleted(groupEntry);
+    }
+}
+
+int32_t DelGroupCascade(int32_t osAccountId, const char *groupId, DeviceEntryVec *delEntries)
+{
+    LOGI("[DB]: Start to delete a group and its devices from database!");
+    if (groupId == NULL) {
+        LOGE("[DB]: The input groupId is NULL!");
+        return HC_ERR_NULL_PTR;
+    }
+    DeviceEntryVec localEntries = CreateDeviceEntryVec();
+    DeviceEntryVec *removedEntries = (delEntries != NULL) ? delEntries : &localEntries;
+    StringVector untrustedUdids = CreateStrVector();
+    g_databaseMutex->lock(g_databaseMutex);
+    OsAccountTrustedInfo *info = GetTrustedInfoByOsAccountId(osAccountId);
+    int32_t res = (info != NULL) ? RemoveGroupDevices(info, groupId, removedEntries) : HC_ERR_INVALID_PARAMS;
+    if (res != HC_SUCCESS) {
+        g_databaseMutex->unlock(g_databaseMutex);
+        DestroyStrVector(&untrustedUdids);
+        ClearDeviceEntryVec(&localEntries);
+        return res;
+    }
+    TrustedGroupEntry *groupEntry = RemoveGroupById(info, groupId);
+    uint32_t count = HC_VECTOR_SIZE(removedEntries);
+    if ((groupEntry != NULL) || (count > 0)) {
+        g_dbGeneration++;
+    }
+    if (IsBroadcastSupported()) {
+        CollectUntrustedUdids(info, removedEntries, &untrustedUdids);
+    }
+    g_databaseMutex->unlock(g_databaseMutex);
+    PostGroupCascadeMsg(groupEntry, removedEntries, &untrustedUdids);
+    DestroyStrVector(&untrustedUdids);
+    ClearDeviceEntryVec(&localEntries);
+    if (groupEntry != NULL) {
+        LOGI("[DB]: Delete a group from database successfully! [GroupType]: %d", groupEntry->type);
+        DestroyGroupEntry(groupEntry);
+    }
+    LOGI("[DB]: Number of trusted devices deleted with the group: %u", count);
+    return HC_SUCCESS;
+}
+
 int32_t QueryGroups(int32_t osAccountId, const QueryGroupParams *params, GroupEntryVec *vec)
 {
     if ((params == NULL) || (vec == NULL)) {
@@ -1061,7 +1870,7 @@ int32_t QueryGroups(int32_t osAccountId, const QueryGroupParams *params, GroupEn
     uint32_t index;
     TrustedGroupEntry **entry;
     FOR_EACH_HC_VECTOR(info->groups, index, entry) {
-        if ((entry == NULL) || (*entry == NULL) || (!CompareQueryGroupParams(params, *entry))) {
+        if ((entry == NULL) || (*entry == NULL) || (!IsGroupMatched(info, params, *entry))) {
             continue;
         }
         TrustedGroupEntry *newEntry = DeepCopyGroupEntry(*entry);
@@ -1110,6 +1919,152 @@ int32_t QueryDevices(int32_t osAccountId, const QueryDeviceParams *params, Devic
     return HC_SUCCESS;
 }
 
+int32_t RemoveInaccessibleGroups(int32_t osAccountId, const char *appId, GroupEntryVec *vec)
+{
+    if ((appId == NULL) || (vec == NULL)) {
+        LOGE("[DB]: The input appId or vec is NULL!");
+        return HC_ERR_NULL_PTR;
+    }
+    g_databaseMutex->lock(g_databaseMutex);
+    OsAccountTrustedInfo *info = GetTrustedInfoByOsAccountId(osAccountId);
+    if (info == NULL) {
+        g_databaseMutex->unlock(g_databaseMutex);
+        return HC_ERR_INVALID_PARAMS;
+    }
+    uint32_t index = 0;
+    TrustedGroupEntry **entry = NULL;
+    while (index < HC_VECTOR_SIZE(vec)) {
+        entry = vec->getp(vec, index);
+        if ((entry == NULL) || (*entry == NULL) || IsGroupAccessibleByApp(info, appId, *entry)) {
+            index++;
+            continue;
+        }
+        LOGI("[DB]: Remove a group without permission!");
+        TrustedGroupEntry *popEntry = NULL;
+        HC_VECTOR_POPELEMENT(vec, &popEntry, index);
+        DestroyGroupEntry(popEntry);
+    }
+    g_databaseMutex->unlock(g_databaseMutex);
+    return HC_SUCCESS;
+}
+
+bool ExistsGroup(int32_t osAccountId, const QueryGroupParams *params)
+{
+    if (params == NULL) {
+        LOGE("[DB]: The input params is NULL!");
+        return false;
+    }
+    bool isExist = false;
+    g_databaseMutex->lock(g_databaseMutex);
+    const OsAccountTrustedInfo *info = FindTrustedInfoByOsAccountId(osAccountId);
+    uint32_t index;
+    TrustedGroupEntry **entry;
+    if (info != NULL) {
+        FOR_EACH_HC_VECTOR(info->groups, index, entry) {
+            if ((entry != NULL) && (*entry != NULL) && IsGroupMatched(info, params, *entry)) {
+                isExist = true;
+                break;
+            }
+        }
+    }
+    g_databaseMutex->unlock(g_databaseMutex);
+    return isExist;
+}
+
+bool ExistsDevice(int32_t osAccountId, const QueryDeviceParams *params)
+{
+    if (params == NULL) {
+        LOGE("[DB]: The input params is NULL!");
+        return false;
+    }
+    g_databaseMutex->lock(g_databaseMutex);
+    const OsAccountTrustedInfo *info = FindTrustedInfoByOsAccountId(osAccountId);
+    bool isExist = (info != NULL) && (QueryDeviceEntryPtrIfMatch(&info->devices, params) != NULL);
+    g_databaseMutex->unlock(g_databaseMutex);
+    return isExist;
+}
+
+uint32_t CountDevices(int32_t osAccountId, const QueryDeviceParams *params)
+{
+    if (params == NULL) {
+        LOGE("[DB]: The input params is NULL!");
+        return 0;
+    }
+    uint32_t count = 0;
+    g_databaseMutex->lock(g_databaseMutex);
+    const OsAccountTrustedInfo *info = FindTrustedInfoByOsAccountId(osAccountId);
+    uint32_t index;
+    TrustedDeviceEntry **entry;
+    if (info != NULL) {
+        FOR_EACH_HC_VECTOR(info->devices, index, entry) {
+            if ((entry != NULL) && (*entry != NULL) && CompareQueryDeviceParams(params, *entry)) {
+                count++;
+            }
+        }
+    }
+    g_databaseMutex->unlock(g_databaseMutex);
+    return count;
+}
+
+int32_t VisitGroup(int32_t osAccountId, const QueryGroupParams *params, GroupEntryVisitor visitor, void *ctx)
+{
+    if ((params == NULL) || (visitor == NULL)) {
+        LOGE("[DB]: The input params or visitor is NULL!");
+        return HC_ERR_NULL_PTR;
+    }
+    int32_t res = HC_ERR_GROUP_NOT_EXIST;
+    g_databaseMutex->lock(g_databaseMutex);
+    const OsAccountTrustedInfo *info = FindTrustedInfoByOsAccountId(osAccountId);
+    uint32_t index;
+    TrustedGroupEntry **entry;
+    if (info != NULL) {
+        FOR_EACH_HC_VECTOR(info->groups, index, entry) {
+            if ((entry != NULL) && (*entry != NULL) && IsGroupMatched(info, params, *entry)) {
+                res = visitor(*entry, ctx);
+                break;
+            }
+        }
+    }
+    g_databaseMutex->unlock(g_databaseMutex);
+    return res;
+}
+
+int32_t VisitDevice(int32_t osAccountId, const QueryDeviceParams *params, DeviceEntryVisitor visitor, void *ctx)
+{
+    if ((params == NULL) || (visitor == NULL)) {
+        LOGE("[DB]: The input params or visitor is NULL!");
+        return HC_ERR_NULL_PTR;
+    }
+    int32_t res = HC_ERR_DEVICE_NOT_EXIST;
+    g_databaseMutex->lock(g_databaseMutex);
+    const OsAccountTrustedInfo *info = FindTrustedInfoByOsAccountId(osAccountId);
+    TrustedDeviceEntry **entry = (info == NULL) ? NULL : QueryDeviceEntryPtrIfMatch(&info->devices, params);
+    if (entry != NULL) {
+        res = visitor(*entry, ctx);
+    }
+    g_databaseMutex->unlock(g_databaseMutex);
+    return res;
+}
+
+int32_t CheckGroupAccess(int32_t osAccountId, const char *groupId, const char *appId)
+{
+    if ((groupId == NULL) || (appId == NULL)) {
+        LOGE("[DB]: The input groupId or appId is NULL!");
+        return HC_ERR_NULL_PTR;
+    }
+    QueryGroupParams params = InitQueryGroupParams();
+    params.groupId = groupId;
+    int32_t res = HC_ERR_GROUP_NOT_EXIST;
+    g_databaseMutex->lock(g_databaseMutex);
+    const OsAccountTrustedInfo *info = FindTrustedInfoByOsAccountId(osAccountId);
+    TrustedGroupEntry **entry = (info == NULL) ? NULL : QueryGroupEntryPtrIfMatch(&info->groups, &params);
+    if ((entry != NULL) && (*entry != NULL)) {
+        res = IsGroupAccessibleByApp(info, appId, *entry) ? HC_SUCCESS : HC_ERR_ACCESS_DENIED;
+    }
+    g_databaseMutex->unlock(g_databaseMutex);
+    return res;
+}
+
 int32_t SaveOsAccountDb(int32_t osAccountId)
 {
     g_databaseMutex->lock(g_databaseMutex);
@@ -1135,6 +2090,44 @@ int32_t SaveOsAccountDb(int32_t osAccountId)
     return HC_SUCCESS;
 }
 
+void DropOsAccountDb(int32_t osAccountId)
+{
+    char infoPath[MAX_DB_PATH_LEN] = { 0 };
+    if (!GetOsAccountInfoPath(osAccountId, infoPath, MAX_DB_PATH_LEN)) {
+        LOGE("[DB]: Failed to get os account info path!");
+        return;
+    }
+    OsAccountTrustedInfo dropInfo;
+    bool isDropped = false;
+    g_databaseMutex->lock(g_databaseMutex);
+    uint32_t index;
+    OsAccountTrustedInfo *info = NULL;
+    FOR_EACH_HC_VECTOR(g_deviceauthDb, index, info) {
+        if (info->osAccountId == osAccountId) {
+            isDropped = HC_VECTOR_SWAP_REMOVE(&g_deviceauthDb, &dropInfo, index);
+            break;
+        }
+    }
+    /* Unlinked under the lock, so a save of the account which is already running can't leave the file behind. */
+    HcFileRemove(infoPath);
+    g_dbGeneration++;
+    g_databaseMutex->unlock(g_databaseMutex);
+    if (isDropped) {
+        ClearGroupEntryVec(&dropInfo.groups);
+        ClearDeviceEntryVec(&dropInfo.devices);
+        ClearAccessIndex(&dropInfo.accessIndex);
+    }
+    LOGI("[DB]: Drop an os account database successfully! [Id]: %d", osAccountId);
+}
+
+uint64_t GetDbGeneration(void)
+{
+    g_databaseMutex->lock(g_databaseMutex);
+    uint64_t generation = g_dbGeneration;
+    g_databaseMutex->unlock(g_databaseMutex);
+    return generation;
+}
+
 int32_t InitDatabase(void)
 {
     if (g_databaseMutex == NULL) {
@@ -1150,8 +2143,11 @@ int32_t InitDatabase(void)
             return HC_ERROR;
         }
     }
+    g_databaseMutex->lock(g_databaseMutex);
     g_deviceauthDb = CREATE_HC_VECTOR(DeviceAuthDb);
     LoadDeviceAuthDb();
+    g_dbGeneration++;
+    g_databaseMutex->unlock(g_databaseMutex);
     return HC_SUCCESS;
 }
 
@@ -1163,8 +2159,10 @@ void DestroyDatabase(void)
     FOR_EACH_HC_VECTOR(g_deviceauthDb, index, info) {
         ClearGroupEntryVec(&info->groups);
         ClearDeviceEntryVec(&info->devices);
+        ClearAccessIndex(&info->accessIndex);
     }
     DESTROY_HC_VECTOR(DeviceAuthDb, &g_deviceauthDb);
+    g_dbGeneration++;
     g_databaseMutex->unlock(g_databaseMutex);
     if (g_databaseMutex != NULL) {
         DestroyHcMutex(g_databaseMutex);
@@ -15,15 +15,20 @@
 
 #include "device_auth.h"
 
+#include "account_module.h"
 #include "alg_loader.h"
 #include "callback_manager.h"
 #include "channel_manager.h"
 #include "common_defs.h"
+#include "data_manager.h"
 #include "dev_auth_module_manager.h"
+#include "ephemeral_pool.h"
 #include "group_auth_manager.h"
 #include "group_manager.h"
+#include "hal_error.h"
 #include "hc_init_protection.h"
 #include "hc_log.h"
+#include "hc_types.h"
 #include "json_utils.h"
 #include "os_account_adapter.h"
 #include "session_manager.h"
@@ -32,6 +37,35 @@
 static GroupAuthManager *g_groupAuthManager =  NULL;
 static DeviceGroupManager *g_groupManagerInstance = NULL;
 
+static void DoAuthDeviceTask(HcTaskBase *task)
+{
+    HcMemModule prevModule = HcSetMemModule(HC_MEM_MODULE_GROUP_AUTH);
+    DoAuthDevice(task);
+    (void)HcSetMemModule(prevModule);
+}
+
+static void DoProcessAuthDataTask(HcTaskBase *task)
+{
+    HcMemModule prevModule = HcSetMemModule(HC_MEM_MODULE_GROUP_AUTH);
+    DoProcessAuthData(task);
+    (void)HcSetMemModule(prevModule);
+}
+
+/* Blocks still live once every module is destroyed are leaked, the peaks show where the churn is. */
+static void DumpMemStat(void)
+{
+    static const char *moduleNames[HC_MEM_MODULE_NUM] = { "common", "group manager", "group auth" };
+    for (int32_t module = HC_MEM_MODULE_COMMON; module < HC_MEM_MODULE_NUM; module++) {
+        HcMemStat stat;
+        if (HcGetMemStat((HcMemModule)module, &stat) != HAL_SUCCESS) {
+            return;
+        }
+        LOGI("[Service]: Memory of %s! [Allocs]: %" PRIu64 ", [LiveBlocks]: %u, [CurBytes]: %" PRIu64
+            ", [PeakBytes]: %" PRIu64, moduleNames[module], stat.allocCount, stat.liveCount, stat.curBytes,
+            stat.peakBytes);
+    }
+}
+
 static void DestroyGroupAuthTask(HcTaskBase *task)
 {
     AuthDeviceTask *realTask = (AuthDeviceTask *)task;
@@ -41,7 +75,7 @@ static void DestroyGroupAuthTask(HcTaskBase *task)
 static bool InitAuthDeviceTask(int32_t osAccountId, AuthDeviceTask *task, int64_t authReqId, CJson *authParams,
     const DeviceAuthCallback *gaCallback)
 {
-    task->base.doAction = DoAuthDevice;
+    task->base.doAction = DoAuthDeviceTask;
     task->base.destroy = DestroyGroupAuthTask;
     task->authReqId = authReqId;
     if (AddByteToJson(authParams, FIELD_REQUEST_ID, (const uint8_t*)&authReqId, sizeof(int64_t)) != HC_SUCCESS) {
@@ -64,7 +98,7 @@ static bool InitAuthDeviceTask(int32_t osAccountId, AuthDeviceTask *task, int64_
 static bool InitProcessDataTask(AuthDeviceTask *task, int64_t authReqId,
     CJson *receivedData, const DeviceAuthCallback *gaCallback)
 {
-    task->base.doAction = DoProcessAuthData;
+    task->base.doAction = DoProcessAuthDataTask;
     task->base.destroy = DestroyGroupAuthTask;
     task->authReqId = authReqId;
     if (AddByteToJson(receivedData, FIELD_REQUEST_ID, (const uint8_t*)&authReqId, sizeof(int64_t)) != HC_SUCCESS) {
@@ -186,6 +220,17 @@ static void DestroyGmAndGa(void)
     }
 }
 
+/*
+ * Runs on the os account notification thread, so the cleanup never holds up the HichainThread. The cached entries are
+ * released here too, with the handler lock of the os account adapter held.
+ */
+static void OnOsAccountRemoved(int32_t osAccountId)
+{
+    LOGI("[Service]: Drop the data of a removed os account! [Id]: %d", osAccountId);
+    DropOsAccountDb(osAccountId);
+    DropOsAccountCredentials(osAccountId);
+}
+
 static int32_t InitAllModules(void)
 {
     int32_t res = GetLoaderInstance()->initAlg();
@@ -193,9 +238,11 @@ static int32_t InitAllModules(void)
         LOGE("[End]: [Service]: Failed to init algorithm module!");
         return res;
     }
+    InitOsAccountAdapter();
     res = InitModules();
     if (res != HC_SUCCESS) {
         LOGE("[End]: [Service]: Failed to init all authenticator modules!");
+        DestroyOsAccountAdapter();
         return res;
     }
     res = InitCallbackManager();
@@ -213,6 +260,13 @@ static int32_t InitAllModules(void)
         LOGE("[End]: [Service]: Failed to init worker thread!");
         goto CLEAN_ALL;
     }
+    res = InitEphemeralPool();
+    if (res != HC_SUCCESS) {
+        LOGE("[End]: [Service]: Failed to init ephemeral pool!");
+        DestroyTaskManager();
+        goto CLEAN_ALL;
+    }
+    SetOsAccountRemovedHandler(OnOsAccountRemoved);
     return res;
 CLEAN_ALL:
     DestroySessionManager();
@@ -221,6 +275,7 @@ CLEAN_CALLBACK:
     DestroyCallbackManager();
 CLEAN_MODULE:
     DestroyModules();
+    DestroyOsAccountAdapter();
     return res;
 }
 
@@ -252,15 +307,20 @@ DEVICE_AUTH_API_PUBLIC void DestroyDeviceAuthService(void)
         LOGI("[End]: [Service]: The service has not been initialized!");
         return;
     }
+    SetOsAccountRemovedHandler(NULL);
     DestroyTaskManager();
+    DestroyEphemeralPool();
     DestroyGroupManager();
     DestroySessionManager();
     DestroyGmAndGa();
     DestroyModules();
     DestroyChannelManager();
     DestroyCallbackManager();
+    DestroyOsAccountAdapter();
+    DumpMemStat();
     SetDeInitStatus();
     LOGI("[End]: [Service]: Destroy device auth service successfully!");
+    DevAuthStopLogWriter();
 }
 
 DEVICE_AUTH_API_PUBLIC const DeviceGroupManager *GetGmInstance(void)
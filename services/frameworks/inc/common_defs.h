@@ -99,6 +99,9 @@
 #define FIELD_RMV_ID "rmvId"
 #define FIELD_RMV_AUTH_INFO "rmvAuthInfo"
 #define FIELD_RMV_RETURN "rmvReturn"
+#define FIELD_RESUME_MAC "resumeMac"
+#define FIELD_RESUME_NONCE "resumeNonce"
+#define FIELD_RESUME_TICKET "resumeTicket"
 #define FIELD_SALT "salt"
 #define FIELD_ISO_SALT "isoSalt"
 #define FIELD_SEED "seed"
@@ -22,7 +22,17 @@
 extern "C" {
 #endif
 
+typedef void (*OsAccountRemovedHandler)(int32_t osAccountId);
+
+/* Subscribes to os account switches so that the active os account can be cached, failures are logged only. */
+void InitOsAccountAdapter(void);
+void DestroyOsAccountAdapter(void);
 int32_t DevAuthGetRealOsAccountLocalId(int32_t inputId);
+/*
+ * The handler is called on the os account notification thread when an os account is removed. Setting NULL waits for
+ * a handler which is still running.
+ */
+void SetOsAccountRemovedHandler(OsAccountRemovedHandler handler);
 
 #ifdef __cplusplus
 }
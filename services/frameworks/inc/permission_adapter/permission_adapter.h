@@ -23,6 +23,9 @@ extern "C" {
 #endif
 
 int32_t CheckPermission(void);
+/* Keeps the cached decisions in line with the permission changes the token service notifies. */
+int32_t RegisterPermissionChangeCallback(void);
+void UnregisterPermissionChangeCallback(void);
 
 #ifdef __cplusplus
 }
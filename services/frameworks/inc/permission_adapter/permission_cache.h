@@ -0,0 +1,49 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PERMISSION_CACHE_H
+#define PERMISSION_CACHE_H
+
+#include <stdint.h>
+
+#ifndef PERMISSION_CACHE_TTL
+#define PERMISSION_CACHE_TTL 60
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Decides the permission of a calling token with the access token service. HC_SUCCESS and
+ * HC_ERR_ACCESS_DENIED are final and get cached, any other result is treated as transient.
+ */
+typedef int32_t (*PermissionDecisionFunc)(uint32_t tokenId);
+
+/*
+ * Returns the cached decision for tokenId, asking decide only on a miss or after PERMISSION_CACHE_TTL seconds.
+ * A change of the token's permissions drops its decision, PERMISSION_CACHE_TTL bounds the changes not notified.
+ */
+int32_t CheckPermissionWithCache(uint32_t tokenId, PermissionDecisionFunc decide);
+/* Drops the decision of one token, its next check asks the token service again. */
+void InvalidatePermissionCache(uint32_t tokenId);
+/* Drops all decisions, called when the service is destroyed. */
+void ClearPermissionCache(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
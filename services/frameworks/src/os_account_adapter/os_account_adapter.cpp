@@ -15,26 +15,203 @@
 
 #include "os_account_adapter.h"
 
+#include <mutex>
 #include <vector>
 #include "device_auth.h"
 #include "hc_log.h"
 #ifdef SUPPORT_OS_ACCOUNT
 #include "os_account_manager.h"
+#include "os_account_subscriber.h"
 #endif
 
+#ifdef SUPPORT_OS_ACCOUNT
+/*
+ * The active os account is cached only while the switch subscription is alive,
+ * without it every ANY_OS_ACCOUNT request asks the account service again.
+ * The generation counts the switches, an id queried across one of them is not cached.
+ */
+static std::mutex g_osAccountMutex;
+static int32_t g_activeOsAccountId = INVALID_OS_ACCOUNT;
+static uint32_t g_activeOsAccountGeneration = 0;
+
+class ActiveOsAccountSubscriber : public OHOS::AccountSA::OsAccountSubscriber {
+public:
+    explicit ActiveOsAccountSubscriber(const OHOS::AccountSA::OsAccountSubscribeInfo &info)
+        : OHOS::AccountSA::OsAccountSubscriber(info) {}
+
+    void OnAccountsChanged(const int &id) override
+    {
+        LOGI("[Account]: Os account switched! [Id]: %d", id);
+        std::lock_guard<std::mutex> lock(g_osAccountMutex);
+        g_activeOsAccountId = INVALID_OS_ACCOUNT;
+        g_activeOsAccountGeneration++;
+    }
+};
+
+static std::shared_ptr<ActiveOsAccountSubscriber> g_accountSubscriber = nullptr;
+
+/* Held while the handler runs, so that clearing the handler waits for a cleanup in progress. */
+static std::mutex g_removedHandlerMutex;
+static OsAccountRemovedHandler g_removedHandler = nullptr;
+
+class RemovedOsAccountSubscriber : public OHOS::AccountSA::OsAccountSubscriber {
+public:
+    explicit RemovedOsAccountSubscriber(const OHOS::AccountSA::OsAccountSubscribeInfo &info)
+        : OHOS::AccountSA::OsAccountSubscriber(info) {}
+
+    void OnAccountsChanged(const int &id) override
+    {
+        LOGI("[Account]: Os account removed! [Id]: %d", id);
+        std::lock_guard<std::mutex> lock(g_removedHandlerMutex);
+        if (g_removedHandler != nullptr) {
+            g_removedHandler(id);
+        }
+    }
+};
+
+static std::shared_ptr<RemovedOsAccountSubscriber> g_removedSubscriber = nullptr;
+
+/* Subscribed without g_osAccountMutex, a switch notification waiting for the lock must not wait for the ipc. */
+static void SubscribeOsAccountRemoved(void)
+{
+    {
+        std::lock_guard<std::mutex> lock(g_osAccountMutex);
+        if (g_removedSubscriber != nullptr) {
+            return;
+        }
+    }
+    OHOS::AccountSA::OsAccountSubscribeInfo subscribeInfo(OHOS::AccountSA::OS_ACCOUNT_SUBSCRIBE_TYPE::REMOVED,
+        "deviceauth_removed_os_account");
+    std::shared_ptr<RemovedOsAccountSubscriber> subscriber =
+        std::make_shared<RemovedOsAccountSubscriber>(subscribeInfo);
+    OHOS::ErrCode res = OHOS::AccountSA::OsAccountManager::SubscribeOsAccount(subscriber);
+    if (res != OHOS::ERR_OK) {
+        LOGW("[Account]: Failed to subscribe os account removal, its data is kept! res: %d", res);
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(g_osAccountMutex);
+        if (g_removedSubscriber == nullptr) {
+            g_removedSubscriber.swap(subscriber);
+        }
+    }
+    /* Subscribed twice by concurrent callers, the later one is dropped. */
+    if (subscriber != nullptr) {
+        (void)OHOS::AccountSA::OsAccountManager::UnsubscribeOsAccount(subscriber);
+    }
+}
+
+static int32_t QueryActiveOsAccountId(void)
+{
+    std::vector<int> activatedOsAccountIds;
+    LOGI("[OsAccountManager][In]: QueryActiveOsAccountIds!");
+    OHOS::ErrCode res = OHOS::AccountSA::OsAccountManager::QueryActiveOsAccountIds(activatedOsAccountIds);
+    LOGI("[OsAccountManager][Out]: QueryActiveOsAccountIds! res: %d", res);
+    if ((res != OHOS::ERR_OK) || (activatedOsAccountIds.size() <= 0)) {
+        LOGE("[Account]: QueryActiveOsAccountIds fail! res: %d", res);
+        return INVALID_OS_ACCOUNT;
+    }
+    return activatedOsAccountIds[0];
+}
+
+static int32_t GetActiveOsAccountId(void)
+{
+    uint32_t generation;
+    {
+        std::lock_guard<std::mutex> lock(g_osAccountMutex);
+        if (g_activeOsAccountId != INVALID_OS_ACCOUNT) {
+            return g_activeOsAccountId;
+        }
+        generation = g_activeOsAccountGeneration;
+    }
+    /* Queried without the lock, neither the other callers nor a switch notification wait for the ipc. */
+    int32_t osAccountId = QueryActiveOsAccountId();
+    std::lock_guard<std::mutex> lock(g_osAccountMutex);
+    if ((g_accountSubscriber != nullptr) && (generation == g_activeOsAccountGeneration)) {
+        g_activeOsAccountId = osAccountId;
+    }
+    return osAccountId;
+}
+
+static void SubscribeOsAccountSwitched(void)
+{
+    {
+        std::lock_guard<std::mutex> lock(g_osAccountMutex);
+        if (g_accountSubscriber != nullptr) {
+            return;
+        }
+    }
+    OHOS::AccountSA::OsAccountSubscribeInfo subscribeInfo(OHOS::AccountSA::OS_ACCOUNT_SUBSCRIBE_TYPE::ACTIVED,
+        "deviceauth_active_os_account");
+    std::shared_ptr<ActiveOsAccountSubscriber> subscriber = std::make_shared<ActiveOsAccountSubscriber>(subscribeInfo);
+    OHOS::ErrCode res = OHOS::AccountSA::OsAccountManager::SubscribeOsAccount(subscriber);
+    if (res != OHOS::ERR_OK) {
+        LOGW("[Account]: Failed to subscribe os account switch, the active os account is not cached! res: %d", res);
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(g_osAccountMutex);
+        if (g_accountSubscriber == nullptr) {
+            g_accountSubscriber.swap(subscriber);
+            /* A switch before the subscription was not notified, the ids queried until now are not cached. */
+            g_activeOsAccountId = INVALID_OS_ACCOUNT;
+            g_activeOsAccountGeneration++;
+        }
+    }
+    if (subscriber != nullptr) {
+        (void)OHOS::AccountSA::OsAccountManager::UnsubscribeOsAccount(subscriber);
+    }
+}
+#endif
+
+void InitOsAccountAdapter(void)
+{
+#ifdef SUPPORT_OS_ACCOUNT
+    SubscribeOsAccountRemoved();
+    SubscribeOsAccountSwitched();
+#endif
+}
+
+void DestroyOsAccountAdapter(void)
+{
+#ifdef SUPPORT_OS_ACCOUNT
+    std::shared_ptr<RemovedOsAccountSubscriber> removedSubscriber = nullptr;
+    std::shared_ptr<ActiveOsAccountSubscriber> accountSubscriber = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(g_osAccountMutex);
+        removedSubscriber.swap(g_removedSubscriber);
+        accountSubscriber.swap(g_accountSubscriber);
+        g_activeOsAccountId = INVALID_OS_ACCOUNT;
+        g_activeOsAccountGeneration++;
+    }
+    /* Unsubscribed after unlocking, a switch notification waiting for the lock must not wait for the unsubscribe. */
+    if (removedSubscriber != nullptr) {
+        (void)OHOS::AccountSA::OsAccountManager::UnsubscribeOsAccount(removedSubscriber);
+    }
+    if (accountSubscriber != nullptr) {
+        (void)OHOS::AccountSA::OsAccountManager::UnsubscribeOsAccount(accountSubscriber);
+    }
+#endif
+}
+
+void SetOsAccountRemovedHandler(OsAccountRemovedHandler handler)
+{
+#ifdef SUPPORT_OS_ACCOUNT
+    std::lock_guard<std::mutex> lock(g_removedHandlerMutex);
+    g_removedHandler = handler;
+#else
+    (void)handler;
+#endif
+}
+
 int32_t DevAuthGetRealOsAccountLocalId(int32_t inputId)
 {
     if (inputId == ANY_OS_ACCOUNT) {
 #ifdef SUPPORT_OS_ACCOUNT
-        std::vector<int> activatedOsAccountIds;
-        LOGI("[OsAccountManager][In]: QueryActiveOsAccountIds!");
-        OHOS::ErrCode res = OHOS::AccountSA::OsAccountManager::QueryActiveOsAccountIds(activatedOsAccountIds);
-        LOGI("[OsAccountManager][Out]: QueryActiveOsAccountIds! res: %d", res);
-        if ((res != OHOS::ERR_OK) || (activatedOsAccountIds.size() <= 0)) {
-            LOGE("[Account]: QueryActiveOsAccountIds fail! res: %d", res);
+        int32_t osAccountId = GetActiveOsAccountId();
+        if (osAccountId == INVALID_OS_ACCOUNT) {
             return INVALID_OS_ACCOUNT;
         }
-        int osAccountId = activatedOsAccountIds[0];
         LOGI("[Account]: Use activated os account! [Id]: %d", osAccountId);
         return osAccountId;
 #else
@@ -16,8 +16,21 @@
 #include "os_account_adapter.h"
 #include "device_auth.h"
 
+void InitOsAccountAdapter(void)
+{
+}
+
+void DestroyOsAccountAdapter(void)
+{
+}
+
 int32_t DevAuthGetRealOsAccountLocalId(int32_t inputId)
 {
     (void)inputId;
     return DEFAULT_OS_ACCOUNT;
 }
+
+void SetOsAccountRemovedHandler(OsAccountRemovedHandler handler)
+{
+    (void)handler;
+}
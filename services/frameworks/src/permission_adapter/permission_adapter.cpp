@@ -15,18 +15,35 @@
 
 #include "permission_adapter.h"
 
+#include <memory>
+#include <mutex>
 #include "accesstoken_kit.h"
 #include "ipc_skeleton.h"
+#include "perm_state_change_callback_customize.h"
 
 #include "device_auth_defines.h"
 #include "hc_log.h"
+#include "permission_cache.h"
 
 using namespace OHOS;
 using namespace OHOS::Security::AccessToken;
 
-int32_t CheckPermission(void)
+class PermissionChangeCallback : public PermStateChangeCallbackCustomize {
+public:
+    explicit PermissionChangeCallback(const PermStateChangeScope &scope) : PermStateChangeCallbackCustomize(scope) {}
+
+    void PermStateChangeCallback(PermStateChangeInfo &result) override
+    {
+        LOGI("Permission of a token changed, drop its cached decision!");
+        InvalidatePermissionCache(result.tokenID);
+    }
+};
+
+static std::mutex g_permissionCallbackMutex;
+static std::shared_ptr<PermissionChangeCallback> g_permissionCallback = nullptr;
+
+static int32_t DecidePermission(uint32_t tokenId)
 {
-    AccessTokenID tokenId = IPCSkeleton::GetCallingTokenID();
     ATokenTypeEnum tokenType = AccessTokenKit::GetTokenTypeFlag(tokenId);
     if (tokenType == TOKEN_NATIVE) {
         NativeTokenInfo findInfo;
@@ -39,10 +56,58 @@ int32_t CheckPermission(void)
             return HC_SUCCESS;
         } else {
             LOGE("Check permission(APL3=SYSTEM_CORE) failed! APL: %d", findInfo.apl);
-            return HC_ERROR;
+            return HC_ERR_ACCESS_DENIED;
         }
     } else {
         LOGE("Invalid token type: %d", tokenType);
+        return HC_ERR_ACCESS_DENIED;
+    }
+}
+
+int32_t CheckPermission(void)
+{
+    AccessTokenID tokenId = IPCSkeleton::GetCallingTokenID();
+    return (CheckPermissionWithCache(tokenId, DecidePermission) == HC_SUCCESS) ? HC_SUCCESS : HC_ERROR;
+}
+
+/* The token service is called without the lock, a notification in progress never waits for it. */
+int32_t RegisterPermissionChangeCallback(void)
+{
+    {
+        std::lock_guard<std::mutex> lock(g_permissionCallbackMutex);
+        if (g_permissionCallback != nullptr) {
+            return HC_SUCCESS;
+        }
+    }
+    /* An empty scope covers all the tokens and permissions. */
+    PermStateChangeScope scope;
+    std::shared_ptr<PermissionChangeCallback> callback = std::make_shared<PermissionChangeCallback>(scope);
+    int32_t res = AccessTokenKit::RegisterPermStateChangeCallback(callback);
+    if (res != 0) {
+        LOGW("Failed to register the permission change callback, only the ttl applies! res: %d", res);
         return HC_ERROR;
     }
+    {
+        std::lock_guard<std::mutex> lock(g_permissionCallbackMutex);
+        if (g_permissionCallback == nullptr) {
+            g_permissionCallback.swap(callback);
+        }
+    }
+    /* Registered twice by concurrent callers, the later one is dropped. */
+    if (callback != nullptr) {
+        (void)AccessTokenKit::UnRegisterPermStateChangeCallback(callback);
+    }
+    return HC_SUCCESS;
+}
+
+void UnregisterPermissionChangeCallback(void)
+{
+    std::shared_ptr<PermissionChangeCallback> callback = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(g_permissionCallbackMutex);
+        callback.swap(g_permissionCallback);
+    }
+    if (callback != nullptr) {
+        (void)AccessTokenKit::UnRegisterPermStateChangeCallback(callback);
+    }
 }
\ No newline at end of file
@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "permission_cache.h"
+#include <pthread.h>
+#include <stdbool.h>
+#include "device_auth_defines.h"
+#include "hc_time.h"
+
+#define PERMISSION_CACHE_SIZE 32
+
+typedef struct {
+    bool inUse;
+    uint32_t tokenId;
+    int32_t decision;
+    int64_t decideTime;
+} PermissionCacheEntry;
+
+static pthread_mutex_t g_permissionCacheMutex = PTHREAD_MUTEX_INITIALIZER;
+static PermissionCacheEntry g_permissionCache[PERMISSION_CACHE_SIZE];
+
+static PermissionCacheEntry *FindPermissionEntry(uint32_t tokenId)
+{
+    for (uint32_t i = 0; i < PERMISSION_CACHE_SIZE; i++) {
+        if (g_permissionCache[i].inUse && (g_permissionCache[i].tokenId == tokenId)) {
+            return &g_permissionCache[i];
+        }
+    }
+    return NULL;
+}
+
+static PermissionCacheEntry *GetFreeOrOldestPermissionEntry(void)
+{
+    PermissionCacheEntry *oldest = &g_permissionCache[0];
+    for (uint32_t i = 0; i < PERMISSION_CACHE_SIZE; i++) {
+        if (!g_permissionCache[i].inUse) {
+            return &g_permissionCache[i];
+        }
+        if (g_permissionCache[i].decideTime < oldest->decideTime) {
+            oldest = &g_permissionCache[i];
+        }
+    }
+    return oldest;
+}
+
+static bool GetCachedDecision(uint32_t tokenId, int32_t *decision)
+{
+    bool isHit = false;
+    (void)pthread_mutex_lock(&g_permissionCacheMutex);
+    PermissionCacheEntry *entry = FindPermissionEntry(tokenId);
+    if (entry != NULL) {
+        int64_t elapsedTime = HcGetIntervalTime(entry->decideTime);
+        if ((elapsedTime >= 0) && (elapsedTime < PERMISSION_CACHE_TTL)) {
+            *decision = entry->decision;
+            isHit = true;
+        } else {
+            entry->inUse = false;
+        }
+    }
+    (void)pthread_mutex_unlock(&g_permissionCacheMutex);
+    return isHit;
+}
+
+static void CacheDecision(uint32_t tokenId, int32_t decision)
+{
+    int64_t curTime = HcGetCurTime();
+    if (curTime < 0) {
+        return;
+    }
+    (void)pthread_mutex_lock(&g_permissionCacheMutex);
+    PermissionCacheEntry *entry = FindPermissionEntry(tokenId);
+    if (entry == NULL) {
+        entry = GetFreeOrOldestPermissionEntry();
+    }
+    entry->inUse = true;
+    entry->tokenId = tokenId;
+    entry->decision = decision;
+    entry->decideTime = curTime;
+    (void)pthread_mutex_unlock(&g_permissionCacheMutex);
+}
+
+int32_t CheckPermissionWithCache(uint32_t tokenId, PermissionDecisionFunc decide)
+{
+    if (decide == NULL) {
+        return HC_ERR_NULL_PTR;
+    }
+    int32_t decision = HC_ERROR;
+    if (GetCachedDecision(tokenId, &decision)) {
+        return decision;
+    }
+    /* Decided outside the lock, concurrent misses of one caller may both ask the token service. */
+    decision = decide(tokenId);
+    if ((decision == HC_SUCCESS) || (decision == HC_ERR_ACCESS_DENIED)) {
+        CacheDecision(tokenId, decision);
+    }
+    return decision;
+}
+
+void InvalidatePermissionCache(uint32_t tokenId)
+{
+    (void)pthread_mutex_lock(&g_permissionCacheMutex);
+    PermissionCacheEntry *entry = FindPermissionEntry(tokenId);
+    if (entry != NULL) {
+        entry->inUse = false;
+    }
+    (void)pthread_mutex_unlock(&g_permissionCacheMutex);
+}
+
+void ClearPermissionCache(void)
+{
+    (void)pthread_mutex_lock(&g_permissionCacheMutex);
+    for (uint32_t i = 0; i < PERMISSION_CACHE_SIZE; i++) {
+        g_permissionCache[i].inUse = false;
+    }
+    (void)pthread_mutex_unlock(&g_permissionCacheMutex);
+}
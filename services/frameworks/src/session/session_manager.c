@@ -105,7 +105,7 @@ static void DestroyRequest(int64_t requestId)
     FOR_EACH_HC_VECTOR(g_requestVec, index, request) {
         if ((request != NULL) && (request->requestId == requestId)) {
             RequestInfo tempRequest;
-            HC_VECTOR_POPELEMENT(&g_requestVec, &tempRequest, index);
+            HC_VECTOR_SWAP_REMOVE(&g_requestVec, &tempRequest, index);
             return;
         }
     }
@@ -150,7 +150,7 @@ static void InformTimeOutAndDestroyRequest(const DeviceAuthCallback *callback, i
         if ((requestInfo != NULL) && (requestInfo->sessionId == sessionId)) {
             requestId = requestInfo->requestId;
             RequestInfo tempRequest;
-            HC_VECTOR_POPELEMENT(&g_requestVec, &tempRequest, index);
+            HC_VECTOR_SWAP_REMOVE(&g_requestVec, &tempRequest, index);
             break;
         }
     }
@@ -174,7 +174,7 @@ static void RemoveOverTimeSession(void)
         } else {
             InformTimeOutAndDestroyRequest(ptr->callback, ptr->sessionId);
             ptr->destroy(ptr);
-            g_sessionManagerVec.eraseElement(&(g_sessionManagerVec), session, index);
+            g_sessionManagerVec.swapRemove(&(g_sessionManagerVec), session, index);
         }
         session = g_sessionManagerVec.getp(&(g_sessionManagerVec), index);
     }
@@ -269,7 +269,7 @@ void DestroySession(int64_t requestId)
             if (((Session *)(*session))->sessionId == sessionId) {
                 ((Session *)(*session))->destroy(((Session *)(*session)));
                 *session = NULL;
-                HC_VECTOR_POPELEMENT(&g_sessionManagerVec, session, index);
+                HC_VECTOR_SWAP_REMOVE(&g_sessionManagerVec, session, index);
                 break;
             }
         }
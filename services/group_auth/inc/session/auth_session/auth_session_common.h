@@ -36,6 +36,8 @@ void CreateAuthParamsVec(ParamsVec *vec);
 void DestroyAuthParamsVec(ParamsVec *vec);
 int32_t ReturnSessionKey(int64_t requestId, const CJson *authParam,
     const CJson *out, const DeviceAuthCallback *callback);
+/* Key the last-success memory of the client session by the caller's own os account, pkgName and peer id. */
+int32_t InitAuthSessionPeer(AuthSession *session, int32_t osAccountId, const CJson *param);
 #ifdef __cplusplus
 }
 #endif
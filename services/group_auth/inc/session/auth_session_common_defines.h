@@ -22,11 +22,16 @@
 
 DECLARE_HC_VECTOR(ParamsVec, void*)
 
+/* The hex sha256 of the caller's pkgName and the peer id, with its terminator. */
+#define AUTH_PEER_KEY_LEN 65
+
 typedef struct {
     Session base;
     int32_t curTaskId;
     ParamsVec paramsList;
     uint32_t currentIndex;
+    int32_t osAccountId; /* the os account of the caller */
+    char peerKey[AUTH_PEER_KEY_LEN]; /* empty if the session keeps no last-success memory */
 } AuthSession;
 
 typedef enum {
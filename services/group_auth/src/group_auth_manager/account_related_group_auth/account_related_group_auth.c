@@ -51,7 +51,7 @@ static AccountRelatedGroupAuth g_accountRelatedGroupAuth = {
 static int32_t GetSessionKeyForAccount(const CJson *sendToSelf, CJson *returnToSelf)
 {
     int32_t keyLen = DEFAULT_RETURN_KEY_LENGTH;
-    uint8_t *sessionKey = (uint8_t *)HcMalloc(keyLen, 0);
+    uint8_t *sessionKey = (uint8_t *)HcMallocNoZero(keyLen);
     if (sessionKey == NULL) {
         LOGE("Failed to allocate memory for sessionKey!");
         return HC_ERR_ALLOC_MEMORY;
@@ -118,7 +118,7 @@ static int32_t AddSessionKeyToSelfData(const CJson *authParam, const CJson *send
 {
     int32_t keyLen = DEFAULT_RETURN_KEY_LENGTH;
     (void)GetIntFromJson(authParam, FIELD_KEY_LENGTH, &keyLen);
-    uint8_t *sessionKey = (uint8_t *)HcMalloc(keyLen, 0);
+    uint8_t *sessionKey = (uint8_t *)HcMallocNoZero(keyLen);
     if (sessionKey == NULL) {
         LOGE("Failed to allocate memory for sessionKey!");
         return HC_ERR_ALLOC_MEMORY;
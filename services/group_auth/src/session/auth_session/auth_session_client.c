@@ -181,6 +181,9 @@ static Session *CreateClientAuthSessionInner(int32_t osAccountId, CJson *param,
     session->base.callback = callback;
     session->currentIndex = 0;
     session->paramsList = authParamsVec;
+    if (InitAuthSessionPeer(session, osAccountId, param) != HC_SUCCESS) {
+        LOGW("No peer key of the caller, the group that succeeds is not remembered.");
+    }
     res = GenerateSessionOrTaskId(&session->base.sessionId);
     if (res != HC_SUCCESS) {
         LOGE("Failed to generate session id!");
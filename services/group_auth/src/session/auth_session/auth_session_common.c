@@ -28,8 +28,151 @@
 #include "json_utils.h"
 
 #define MIN_PROTOCOL_VERSION "1.0.0"
+#define AUTH_GROUP_MEMORY_SIZE 16
 IMPLEMENT_HC_VECTOR(ParamsVec, void *, 1)
 
+/* The group each peer last authenticated with on the client, tried first next time. Session thread only. */
+typedef struct {
+    bool inUse;
+    int32_t osAccountId;
+    char peerKey[AUTH_PEER_KEY_LEN];
+    char groupId[MAX_STRING_LEN + 1];
+    uint32_t lastUsed;
+} AuthGroupMemory;
+
+static AuthGroupMemory g_authGroupMemory[AUTH_GROUP_MEMORY_SIZE];
+static uint32_t g_authGroupMemoryClock = 0;
+
+static int32_t GetAuthPeerKey(const CJson *authParam, char *peerKey, uint32_t peerKeyLen)
+{
+    const char *pkgName = GetStringFromJson(authParam, FIELD_SERVICE_PKG_NAME);
+    const char *peerId = GetStringFromJson(authParam, FIELD_PEER_CONN_DEVICE_ID);
+    if (peerId == NULL) {
+        peerId = GetStringFromJson(authParam, FIELD_PEER_AUTH_ID);
+    }
+    if ((pkgName == NULL) || (peerId == NULL)) {
+        return HC_ERR_NULL_PTR;
+    }
+    uint32_t pkgNameLen = HcStrlen(pkgName);
+    uint32_t peerIdLen = HcStrlen(peerId);
+    uint32_t infoLen = pkgNameLen + 1 + peerIdLen;
+    uint8_t *info = (uint8_t *)HcMalloc(infoLen, 0);
+    if (info == NULL) {
+        return HC_ERR_ALLOC_MEMORY;
+    }
+    /* The zeroed byte after pkgName keeps the two names apart. */
+    if ((memcpy_s(info, infoLen, pkgName, pkgNameLen) != EOK) ||
+        (memcpy_s(info + pkgNameLen + 1, peerIdLen, peerId, peerIdLen) != EOK)) {
+        HcFree(info);
+        return HC_ERR_MEMORY_COPY;
+    }
+    int32_t res = GetInfoHash(info, infoLen, peerKey, peerKeyLen);
+    HcFree(info);
+    return res;
+}
+
+static AuthGroupMemory *FindAuthGroupMemory(int32_t osAccountId, const char *peerKey)
+{
+    if (peerKey[0] == '\0') {
+        return NULL;
+    }
+    for (uint32_t i = 0; i < AUTH_GROUP_MEMORY_SIZE; i++) {
+        if (g_authGroupMemory[i].inUse && (g_authGroupMemory[i].osAccountId == osAccountId) &&
+            (strcmp(g_authGroupMemory[i].peerKey, peerKey) == 0)) {
+            return &g_authGroupMemory[i];
+        }
+    }
+    return NULL;
+}
+
+static AuthGroupMemory *GetFreeOrOldestAuthGroupMemory(void)
+{
+    AuthGroupMemory *oldest = &g_authGroupMemory[0];
+    for (uint32_t i = 0; i < AUTH_GROUP_MEMORY_SIZE; i++) {
+        if (!g_authGroupMemory[i].inUse) {
+            return &g_authGroupMemory[i];
+        }
+        if (g_authGroupMemory[i].lastUsed < oldest->lastUsed) {
+            oldest = &g_authGroupMemory[i];
+        }
+    }
+    return oldest;
+}
+
+/* The candidate param carries the pkgName of the group, so the key is the one the session took from the caller. */
+static void RememberAuthGroup(const AuthSession *session, const CJson *authParam)
+{
+    const char *groupId = GetStringFromJson(authParam, FIELD_GROUP_ID);
+    if ((groupId == NULL) || (HcStrlen(groupId) > MAX_STRING_LEN) || (session->peerKey[0] == '\0')) {
+        return;
+    }
+    AuthGroupMemory *entry = FindAuthGroupMemory(session->osAccountId, session->peerKey);
+    if (entry == NULL) {
+        entry = GetFreeOrOldestAuthGroupMemory();
+    }
+    if ((strcpy_s(entry->peerKey, AUTH_PEER_KEY_LEN, session->peerKey) != EOK) ||
+        (strcpy_s(entry->groupId, sizeof(entry->groupId), groupId) != EOK)) {
+        entry->inUse = false;
+        return;
+    }
+    entry->inUse = true;
+    entry->osAccountId = session->osAccountId;
+    entry->lastUsed = ++g_authGroupMemoryClock;
+}
+
+static void ForgetAuthGroup(const AuthSession *session, const CJson *authParam)
+{
+    const char *groupId = GetStringFromJson(authParam, FIELD_GROUP_ID);
+    AuthGroupMemory *entry = FindAuthGroupMemory(session->osAccountId, session->peerKey);
+    if ((groupId != NULL) && (entry != NULL) && (strcmp(entry->groupId, groupId) == 0)) {
+        entry->inUse = false;
+    }
+}
+
+static bool IsClientAuthParam(const CJson *authParam)
+{
+    bool isClient = false;
+    (void)GetBoolFromJson(authParam, FIELD_IS_CLIENT, &isClient);
+    return isClient;
+}
+
+int32_t InitAuthSessionPeer(AuthSession *session, int32_t osAccountId, const CJson *param)
+{
+    session->osAccountId = osAccountId;
+    int32_t res = GetAuthPeerKey(param, session->peerKey, AUTH_PEER_KEY_LEN);
+    if (res != HC_SUCCESS) {
+        session->peerKey[0] = '\0';
+    }
+    return res;
+}
+
+static void PreferRememberedAuthGroup(int32_t osAccountId, const CJson *param, ParamsVec *paramsVec)
+{
+    char peerKey[AUTH_PEER_KEY_LEN] = { 0 };
+    if ((paramsVec->size(paramsVec) <= 1) || !IsClientAuthParam(param) ||
+        (GetAuthPeerKey(param, peerKey, AUTH_PEER_KEY_LEN) != HC_SUCCESS)) {
+        return;
+    }
+    const AuthGroupMemory *entry = FindAuthGroupMemory(osAccountId, peerKey);
+    if (entry == NULL) {
+        return;
+    }
+    const char *rememberedGroupId = entry->groupId;
+    for (uint32_t i = 1; i < paramsVec->size(paramsVec); i++) {
+        const char *groupId = GetStringFromJson((const CJson *)paramsVec->get(paramsVec, i), FIELD_GROUP_ID);
+        if ((groupId == NULL) || (strcmp(groupId, rememberedGroupId) != 0)) {
+            continue;
+        }
+        LOGI("Try the group that last authenticated with the peer first.");
+        void *remembered = paramsVec->get(paramsVec, i);
+        for (uint32_t j = i; j > 0; j--) {
+            *(paramsVec->getp(paramsVec, j)) = paramsVec->get(paramsVec, j - 1);
+        }
+        *(paramsVec->getp(paramsVec, 0)) = remembered;
+        return;
+    }
+}
+
 static bool IsOldFormatParams(const CJson *param)
 {
     int32_t authForm = AUTH_FORM_INVALID_TYPE;
@@ -381,6 +524,9 @@ int32_t GetAuthParamsList(int32_t osAccountId, const CJson *param, ParamsVec *au
         ret = GetBleGroupInfoAndAuthParams(param, authParamsVec);
     } else {
         ret = GetCandidateAuthInfo(osAccountId, groupId, param, authParamsVec);
+        if ((ret == HC_SUCCESS) && (groupId == NULL)) {
+            PreferRememberedAuthGroup(osAccountId, param, authParamsVec);
+        }
     }
     return ret;
 }
@@ -616,7 +762,7 @@ int32_t ReturnSessionKey(int64_t requestId, const CJson *authParam,
 {
     int32_t keyLen = DEFAULT_RETURN_KEY_LENGTH;
     (void)GetIntFromJson(authParam, FIELD_KEY_LENGTH, &keyLen);
-    uint8_t *sessionKey = (uint8_t *)HcMalloc(keyLen, 0);
+    uint8_t *sessionKey = (uint8_t *)HcMallocNoZero(keyLen);
     if (sessionKey == NULL) {
         LOGE("Failed to allocate memory for sessionKey!");
         return HC_ERR_ALLOC_MEMORY;
@@ -674,6 +820,9 @@ int32_t InformAuthError(AuthSession *session, const CJson *out, int errorCode)
         LOGE("The json data in session is null!");
         return HC_ERR_NULL_PTR;
     }
+    if (IsClientAuthParam(paramInSession)) {
+        ForgetAuthGroup(session, paramInSession);
+    }
     int32_t res;
     if (out == NULL) {
         res = ReturnErrorToPeerBySession(paramInSession, session->base.callback);
@@ -729,6 +878,9 @@ int32_t ProcessTaskStatusForAuth(const AuthSession *session, const CJson *param,
             }
             break;
         case FINISH:
+            if (IsClientAuthParam(param)) {
+                RememberAuthGroup(session, param);
+            }
             ReturnFinishData(session, out);
             ClearSensitiveStringInJson(out, FIELD_SESSION_KEY);
             res = FINISH;
@@ -27,6 +27,7 @@ typedef struct {
     int32_t opCode;
     CJson *params;
     const DeviceAuthCallback *cb;
+    void (*func)(HcTaskBase *task);
 } GroupManagerTask;
 
 typedef struct {
@@ -28,6 +28,11 @@ typedef struct {
     void (*postOnGroupDeleted)(const TrustedGroupEntry *groupEntry);
     void (*postOnDeviceBound)(const char *peerUdid, const TrustedGroupEntry *groupEntry);
     void (*postOnDeviceUnBound)(const char *peerUdid, const TrustedGroupEntry *groupEntry);
+    /* Batch variants, the group info is generated once and posted for every device of the batch. */
+    void (*postOnDevicesBound)(const DeviceEntryVec *deviceEntries, const TrustedGroupEntry *groupEntry);
+    /* A device whose udid is in untrustedUdids is followed by its not-trusted notification, as if unbound alone. */
+    void (*postOnDevicesUnBound)(const DeviceEntryVec *deviceEntries, const TrustedGroupEntry *groupEntry,
+        const StringVector *untrustedUdids);
     void (*postOnDeviceNotTrusted)(const char *peerUdid);
     void (*postOnLastGroupDeleted)(const char *peerUdid, int groupType);
     void (*postOnTrustedDeviceNumChanged)(int curTrustedDeviceNum);
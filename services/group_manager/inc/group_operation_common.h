@@ -19,14 +19,17 @@
 #include "string_util.h"
 #include "data_manager.h"
 #include "json_utils.h"
+#include "json_writer.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 bool IsAccountRelatedGroup(int groupType);
-int32_t GenerateReturnGroupInfo(const TrustedGroupEntry *groupInfo, CJson *returnJson);
-int32_t GenerateReturnDevInfo(const TrustedDeviceEntry *devInfo, CJson *returnJson);
+int32_t WriteReturnGroupInfo(JsonWriter *writer, const TrustedGroupEntry *groupEntry);
+int32_t WriteReturnDevInfo(JsonWriter *writer, const TrustedDeviceEntry *devInfo);
+int32_t GenerateReturnGroupInfo(const TrustedGroupEntry *groupEntry, char **returnGroupInfo);
+int32_t GenerateReturnDevInfo(const TrustedDeviceEntry *devInfo, char **returnDevInfo);
 
 bool IsUserTypeValid(int userType);
 bool IsExpireTimeValid(int expireTime);
@@ -70,7 +73,22 @@ int32_t AddGroupToDatabaseByJson(int32_t osAccountId, int32_t (*generateGroupPar
     const char *, TrustedGroupEntry*), const CJson *jsonParams, const char *groupId);
 int32_t AddDeviceToDatabaseByJson(int32_t osAccountId, int32_t (*generateDevParams)(const CJson*, const char*,
     TrustedDeviceEntry*), const CJson *jsonParams, const char *groupId);
+/* Collect the deviceIds of a member list to delete from the group, the local device is never collected. */
+int32_t GetPeerAuthIdsFromDeviceList(int32_t osAccountId, const char *groupId, const CJson *deviceList,
+    StringVector *authIds);
+/*
+ * Add the members of an account related group as one batch: the tokens are imported first, the devices are added
+ * under one database lock and saved once. The members which fail to be generated or imported are skipped.
+ */
+int32_t AddMembersToDatabaseByJson(int32_t osAccountId, int32_t (*generateDevParams)(const CJson*, const char*,
+    TrustedDeviceEntry*), const CJson *deviceList, const char *groupId, uint32_t *addedCount);
+/* Delete the listed peer members and their tokens as one batch, the database is saved once. */
+int32_t DelMembersFromDatabaseByJson(int32_t osAccountId, const CJson *deviceList, const char *groupId,
+    uint32_t *deletedCount);
+int32_t DelPeerDeviceToken(int32_t osAccountId, const TrustedDeviceEntry *entry);
 int32_t DelGroupFromDb(int32_t osAccountId, const char *groupId);
+/* Same as DelGroupFromDb, the removed devices are returned in delEntries for the caller to clean up their tokens. */
+int32_t DelGroupAndDevicesFromDb(int32_t osAccountId, const char *groupId, DeviceEntryVec *delEntries);
 
 int32_t ConvertGroupIdToJsonStr(const char *groupId, char **returnJsonStr);
 int32_t GenerateBindSuccessData(const char *peerAuthId, const char *groupId, char **returnDataStr);
@@ -92,7 +110,7 @@ int32_t CheckGroupAccessible(int32_t osAccountId, const char *groupId, const cha
 int32_t CheckGroupEditAllowed(int32_t osAccountId, const char *groupId, const char *appId);
 int32_t GetGroupInfo(int32_t osAccountId, int groupType, const char *groupId, const char *groupName,
     const char *groupOwner, GroupEntryVec *groupEntryVec);
-int32_t GetJoinedGroups(int32_t osAccountId, int groupType, GroupEntryVec *groupEntryVec);
+int32_t GetJoinedGroups(int32_t osAccountId, const char *appId, int groupType, GroupEntryVec *groupEntryVec);
 int32_t GetTrustedDevInfoById(int32_t osAccountId, const char *deviceId, bool isUdid, const char *groupId,
     TrustedDeviceEntry *deviceEntry);
 int32_t GetTrustedDevices(int32_t osAccountId, const char *groupId, DeviceEntryVec *deviceEntryVec);
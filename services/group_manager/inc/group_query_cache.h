@@ -0,0 +1,54 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GROUP_QUERY_CACHE_H
+#define GROUP_QUERY_CACHE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef enum {
+    QUERY_JOINED_GROUPS = 0,
+    QUERY_RELATED_GROUPS,
+    QUERY_DEVICE_IN_GROUP,
+} GroupQueryType;
+
+typedef struct {
+    int32_t osAccountId;
+    GroupQueryType type;
+    const char *appId;
+    int32_t intArg; /* groupType for joined groups, isUdid for the others */
+    const char *strArg; /* peerDeviceId for related groups, groupId for device in group */
+    const char *extStrArg; /* deviceId for device in group */
+} GroupQueryKey;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int32_t InitGroupQueryCache(void);
+void DestroyGroupQueryCache(void);
+
+/*
+ * Results are only returned if they were cached at the given database generation.
+ * The returned string is a copy, need to call FreeJsonString to free it when it's no longer in use.
+ */
+bool GetCachedQueryResult(const GroupQueryKey *key, uint64_t generation, char **returnStr, uint32_t *returnNum);
+void CacheQueryResult(const GroupQueryKey *key, uint64_t generation, const char *resultStr, uint32_t resultNum);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -33,28 +33,6 @@ IMPLEMENT_HC_VECTOR(ListenerEntryVec, ListenerEntry, 1);
 static ListenerEntryVec g_listenerEntryVec;
 static HcMutex *g_broadcastMutex = NULL;
 
-static int32_t GenerateMessage(const TrustedGroupEntry *groupEntry, char **returnGroupInfo)
-{
-    CJson *message = CreateJson();
-    if (message == NULL) {
-        LOGE("Failed to allocate message memory!");
-        return HC_ERR_ALLOC_MEMORY;
-    }
-    int32_t result = GenerateReturnGroupInfo(groupEntry, message);
-    if (result != HC_SUCCESS) {
-        FreeJson(message);
-        return result;
-    }
-    char *messageStr = PackJsonToString(message);
-    FreeJson(message);
-    if (messageStr == NULL) {
-        LOGE("Failed to convert json to string!");
-        return HC_ERR_JSON_FAIL;
-    }
-    *returnGroupInfo = messageStr;
-    return HC_SUCCESS;
-}
-
 static void PostOnGroupCreated(const TrustedGroupEntry *groupEntry)
 {
     if (groupEntry == NULL) {
@@ -62,7 +40,7 @@ static void PostOnGroupCreated(const TrustedGroupEntry *groupEntry)
         return;
     }
     char *messageStr = NULL;
-    if (GenerateMessage(groupEntry, &messageStr) != HC_SUCCESS) {
+    if (GenerateReturnGroupInfo(groupEntry, &messageStr) != HC_SUCCESS) {
         return;
     }
     uint32_t index;
@@ -85,7 +63,7 @@ static void PostOnGroupDeleted(const TrustedGroupEntry *groupEntry)
         return;
     }
     char *messageStr = NULL;
-    if (GenerateMessage(groupEntry, &messageStr) != HC_SUCCESS) {
+    if (GenerateReturnGroupInfo(groupEntry, &messageStr) != HC_SUCCESS) {
         return;
     }
     uint32_t index;
@@ -108,7 +86,7 @@ static void PostOnDeviceBound(const char *peerUdid, const TrustedGroupEntry *gro
         return;
     }
     char *messageStr = NULL;
-    if (GenerateMessage(groupEntry, &messageStr) != HC_SUCCESS) {
+    if (GenerateReturnGroupInfo(groupEntry, &messageStr) != HC_SUCCESS) {
         return;
     }
     uint32_t index;
@@ -131,7 +109,7 @@ static void PostOnDeviceUnBound(const char *peerUdid, const TrustedGroupEntry *g
         return;
     }
     char *messageStr = NULL;
-    if (GenerateMessage(groupEntry, &messageStr) != HC_SUCCESS) {
+    if (GenerateReturnGroupInfo(groupEntry, &messageStr) != HC_SUCCESS) {
         return;
     }
     uint32_t index;
@@ -147,21 +125,106 @@ static void PostOnDeviceUnBound(const char *peerUdid, const TrustedGroupEntry *g
     g_broadcastMutex->unlock(g_broadcastMutex);
 }
 
-static void PostOnDeviceNotTrusted(const char *peerUdid)
+static void PostOnDevicesBound(const DeviceEntryVec *deviceEntries, const TrustedGroupEntry *groupEntry)
 {
-    if (peerUdid == NULL) {
-        LOGE("The peerUdid is NULL!");
+    if ((deviceEntries == NULL) || (groupEntry == NULL)) {
+        LOGE("The deviceEntries or groupEntry is NULL!");
+        return;
+    }
+    char *messageStr = NULL;
+    if (GenerateReturnGroupInfo(groupEntry, &messageStr) != HC_SUCCESS) {
         return;
     }
     uint32_t index;
     ListenerEntry *entry = NULL;
     g_broadcastMutex->lock(g_broadcastMutex);
+    FOR_EACH_HC_VECTOR(g_listenerEntryVec, index, entry) {
+        if ((entry == NULL) || (entry->listener == NULL) || (entry->listener->onDeviceBound == NULL)) {
+            continue;
+        }
+        LOGI("[Broadcaster]: PostOnDevicesBound! [AppId]: %s, [Num]: %u", entry->appId,
+            HC_VECTOR_SIZE(deviceEntries));
+        uint32_t devIndex;
+        TrustedDeviceEntry **devEntry = NULL;
+        FOR_EACH_HC_VECTOR(*deviceEntries, devIndex, devEntry) {
+            entry->listener->onDeviceBound(StringGet(&(*devEntry)->udid), messageStr);
+        }
+    }
+    FreeJsonString(messageStr);
+    g_broadcastMutex->unlock(g_broadcastMutex);
+}
+
+static bool IsUdidInVector(const StringVector *udids, const char *udid)
+{
+    uint32_t index;
+    HcString *item = NULL;
+    FOR_EACH_HC_VECTOR(*udids, index, item) {
+        if (strcmp(StringGet(item), udid) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* Must be called with the broadcaster locked. */
+static void NotifyDeviceUnBound(const char *peerUdid, const char *messageStr)
+{
+    uint32_t index;
+    ListenerEntry *entry = NULL;
+    FOR_EACH_HC_VECTOR(g_listenerEntryVec, index, entry) {
+        if ((entry != NULL) && (entry->listener != NULL) && (entry->listener->onDeviceUnBound != NULL)) {
+            entry->listener->onDeviceUnBound(peerUdid, messageStr);
+        }
+    }
+}
+
+/* Must be called with the broadcaster locked. */
+static void NotifyDeviceNotTrusted(const char *peerUdid)
+{
+    uint32_t index;
+    ListenerEntry *entry = NULL;
     FOR_EACH_HC_VECTOR(g_listenerEntryVec, index, entry) {
         if ((entry != NULL) && (entry->listener != NULL) && (entry->listener->onDeviceNotTrusted != NULL)) {
             LOGI("[Broadcaster]: PostOnDeviceNotTrusted! [AppId]: %s", entry->appId);
             entry->listener->onDeviceNotTrusted(peerUdid);
         }
     }
+}
+
+static void PostOnDevicesUnBound(const DeviceEntryVec *deviceEntries, const TrustedGroupEntry *groupEntry,
+    const StringVector *untrustedUdids)
+{
+    if ((deviceEntries == NULL) || (groupEntry == NULL) || (untrustedUdids == NULL)) {
+        LOGE("The deviceEntries, groupEntry or untrustedUdids is NULL!");
+        return;
+    }
+    char *messageStr = NULL;
+    if (GenerateReturnGroupInfo(groupEntry, &messageStr) != HC_SUCCESS) {
+        return;
+    }
+    LOGI("[Broadcaster]: PostOnDevicesUnBound! [Num]: %u", HC_VECTOR_SIZE(deviceEntries));
+    uint32_t index;
+    TrustedDeviceEntry **devEntry = NULL;
+    g_broadcastMutex->lock(g_broadcastMutex);
+    FOR_EACH_HC_VECTOR(*deviceEntries, index, devEntry) {
+        const char *peerUdid = StringGet(&(*devEntry)->udid);
+        NotifyDeviceUnBound(peerUdid, messageStr);
+        if (IsUdidInVector(untrustedUdids, peerUdid)) {
+            NotifyDeviceNotTrusted(peerUdid);
+        }
+    }
+    FreeJsonString(messageStr);
+    g_broadcastMutex->unlock(g_broadcastMutex);
+}
+
+static void PostOnDeviceNotTrusted(const char *peerUdid)
+{
+    if (peerUdid == NULL) {
+        LOGE("The peerUdid is NULL!");
+        return;
+    }
+    g_broadcastMutex->lock(g_broadcastMutex);
+    NotifyDeviceNotTrusted(peerUdid);
     g_broadcastMutex->unlock(g_broadcastMutex);
 }
 
@@ -259,6 +322,8 @@ static Broadcaster g_broadcaster = {
     .postOnGroupDeleted = PostOnGroupDeleted,
     .postOnDeviceBound = PostOnDeviceBound,
     .postOnDeviceUnBound = PostOnDeviceUnBound,
+    .postOnDevicesBound = PostOnDevicesBound,
+    .postOnDevicesUnBound = PostOnDevicesUnBound,
     .postOnDeviceNotTrusted = PostOnDeviceNotTrusted,
     .postOnLastGroupDeleted = PostOnLastGroupDeleted,
     .postOnTrustedDeviceNumChanged = PostOnTrustedDeviceNumChanged
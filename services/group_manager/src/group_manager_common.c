@@ -16,13 +16,22 @@
 #include "group_manager_common.h"
 
 #include "hc_log.h"
+#include "hc_types.h"
 #include "common_defs.h"
 #include "callback_manager.h"
 #include "task_manager.h"
 
+static void DoGroupManagerTask(HcTaskBase *task)
+{
+    HcMemModule prevModule = HcSetMemModule(HC_MEM_MODULE_GROUP_MANAGER);
+    ((GroupManagerTask *)task)->func(task);
+    (void)HcSetMemModule(prevModule);
+}
+
 static int32_t InitGroupManagerTask(GroupManagerTask *task, GMTaskParams *taskParams, TaskFunc func)
 {
-    task->base.doAction = func;
+    task->base.doAction = DoGroupManagerTask;
+    task->func = func;
     task->base.destroy = DestroyGroupManagerTask;
     task->osAccountId = taskParams->osAccountId;
     task->opCode = taskParams->opCode;
@@ -18,12 +18,14 @@
 #include "alg_defs.h"
 #include "broadcast_manager.h"
 #include "callback_manager.h"
+#include "clib_error.h"
 #include "common_defs.h"
 #include "data_manager.h"
 #include "dev_auth_module_manager.h"
 #include "device_auth_defines.h"
 #include "group_manager_common.h"
 #include "group_operation_common.h"
+#include "group_query_cache.h"
 #include "hc_dev_info.h"
 #include "hc_log.h"
 #include "os_account_adapter.h"
@@ -48,85 +50,65 @@ static bool IsGroupTypeSupported(int groupType)
 
 static void RemoveNoPermissionGroup(int32_t osAccountId, GroupEntryVec *groupEntryVec, const char *appId)
 {
-    uint32_t index = 0;
-    TrustedGroupEntry **groupEntryPtr = NULL;
-    while (index < groupEntryVec->size(groupEntryVec)) {
-        groupEntryPtr = groupEntryVec->getp(groupEntryVec, index);
-        if ((groupEntryPtr == NULL) || (*groupEntryPtr == NULL)) {
-            index++;
-            continue;
-        }
-        if (CheckGroupAccessible(osAccountId, StringGet(&(*groupEntryPtr)->id), appId) == HC_SUCCESS) {
-            index++;
-            continue;
+    if (RemoveInaccessibleGroups(osAccountId, appId, groupEntryVec) != HC_SUCCESS) {
+        LOGE("Failed to filter accessible groups, remove all groups!");
+        ClearGroupEntryVec(groupEntryVec);
+        *groupEntryVec = CreateGroupEntryVec();
+    }
+}
+
+static int32_t WriteGroupVecFunc(JsonWriter *writer, const void *ctx)
+{
+    const GroupEntryVec *groupInfoVec = (const GroupEntryVec *)ctx;
+    int32_t res = JsonWriterStartArray(writer, NULL);
+    if (res != CLIB_SUCCESS) {
+        return res;
+    }
+    uint32_t index;
+    TrustedGroupEntry **groupInfoPtr = NULL;
+    FOR_EACH_HC_VECTOR(*groupInfoVec, index, groupInfoPtr) {
+        if ((groupInfoPtr != NULL) && ((*groupInfoPtr) != NULL) &&
+            (WriteReturnGroupInfo(writer, *groupInfoPtr) != HC_SUCCESS)) {
+            return CLIB_FAILED;
         }
-        LOGI("Remove a group without permission!");
-        TrustedGroupEntry *tempEntry = NULL;
-        HC_VECTOR_POPELEMENT(groupEntryVec, &tempEntry, index);
-        DestroyGroupEntry(tempEntry);
     }
+    return JsonWriterEndArray(writer);
 }
 
-static int32_t GenerateReturnEmptyArrayStr(char **returnVec)
+static int32_t WriteDeviceVecFunc(JsonWriter *writer, const void *ctx)
 {
-    CJson *json = CreateJsonArray();
-    if (json == NULL) {
-        LOGE("Failed to allocate json memory!");
-        return HC_ERR_JSON_FAIL;
+    const DeviceEntryVec *devInfoVec = (const DeviceEntryVec *)ctx;
+    int32_t res = JsonWriterStartArray(writer, NULL);
+    if (res != CLIB_SUCCESS) {
+        return res;
     }
-    *returnVec = PackJsonToString(json);
-    FreeJson(json);
-    if (*returnVec == NULL) {
-        LOGE("Failed to convert json to string!");
-        return HC_ERR_JSON_FAIL;
+    uint32_t index;
+    TrustedDeviceEntry **devInfoPtr = NULL;
+    FOR_EACH_HC_VECTOR(*devInfoVec, index, devInfoPtr) {
+        if ((devInfoPtr != NULL) && ((*devInfoPtr) != NULL) &&
+            (WriteReturnDevInfo(writer, *devInfoPtr) != HC_SUCCESS)) {
+            return CLIB_FAILED;
+        }
     }
-    return HC_SUCCESS;
+    return JsonWriterEndArray(writer);
 }
 
 static int32_t GenerateReturnGroupVec(GroupEntryVec *groupInfoVec, char **returnGroupVec, uint32_t *groupNum)
 {
     if (HC_VECTOR_SIZE(groupInfoVec) == 0) {
         LOGI("No group is found based on the query parameters!");
-        *groupNum = 0;
-        return GenerateReturnEmptyArrayStr(returnGroupVec);
-    }
-
-    CJson *json = CreateJsonArray();
-    if (json == NULL) {
-        LOGE("Failed to allocate json memory!");
-        return HC_ERR_JSON_FAIL;
     }
     uint32_t groupCount = 0;
     uint32_t index;
     TrustedGroupEntry **groupInfoPtr = NULL;
     FOR_EACH_HC_VECTOR(*groupInfoVec, index, groupInfoPtr) {
-        if (groupInfoPtr != NULL) {
-            TrustedGroupEntry *groupInfo = *groupInfoPtr;
-            CJson *groupInfoJson = CreateJson();
-            if (groupInfoJson == NULL) {
-                LOGE("Failed to allocate groupInfoJson memory!");
-                FreeJson(json);
-                return HC_ERR_ALLOC_MEMORY;
-            }
-            int32_t result = GenerateReturnGroupInfo(groupInfo, groupInfoJson);
-            if (result != HC_SUCCESS) {
-                FreeJson(groupInfoJson);
-                FreeJson(json);
-                return result;
-            }
-            if (AddObjToArray(json, groupInfoJson) != HC_SUCCESS) {
-                LOGE("Failed to add groupInfoStr to returnGroupVec!");
-                FreeJson(groupInfoJson);
-                FreeJson(json);
-                return HC_ERR_JSON_FAIL;
-            }
+        if ((groupInfoPtr != NULL) && ((*groupInfoPtr) != NULL)) {
             ++groupCount;
         }
     }
-    *returnGroupVec = PackJsonToString(json);
-    FreeJson(json);
+    *returnGroupVec = WriteJsonToString(WriteGroupVecFunc, groupInfoVec);
     if ((*returnGroupVec) == NULL) {
-        LOGE("Failed to convert json to string!");
+        LOGE("Failed to convert groupInfoVec to string!");
         return HC_ERR_JSON_FAIL;
     }
     *groupNum = groupCount;
@@ -137,46 +119,18 @@ static int32_t GenerateReturnDeviceVec(DeviceEntryVec *devInfoVec, char **return
 {
     if (HC_VECTOR_SIZE(devInfoVec) == 0) {
         LOGI("No device is found based on the query parameters!");
-        *deviceNum = 0;
-        return GenerateReturnEmptyArrayStr(returnDevInfoVec);
-    }
-
-    CJson *json = CreateJsonArray();
-    if (json == NULL) {
-        LOGE("Failed to allocate json memory!");
-        return HC_ERR_JSON_FAIL;
     }
     uint32_t devCount = 0;
     uint32_t index;
     TrustedDeviceEntry **devInfoPtr = NULL;
     FOR_EACH_HC_VECTOR(*devInfoVec, index, devInfoPtr) {
         if ((devInfoPtr != NULL) && ((*devInfoPtr) != NULL)) {
-            TrustedDeviceEntry *devInfo = (TrustedDeviceEntry*)(*devInfoPtr);
-            CJson *devInfoJson = CreateJson();
-            if (devInfoJson == NULL) {
-                LOGE("Failed to allocate devInfoJson memory!");
-                FreeJson(json);
-                return HC_ERR_ALLOC_MEMORY;
-            }
-            int32_t result = GenerateReturnDevInfo(devInfo, devInfoJson);
-            if (result != HC_SUCCESS) {
-                FreeJson(devInfoJson);
-                FreeJson(json);
-                return result;
-            }
-            if (AddObjToArray(json, devInfoJson) != HC_SUCCESS) {
-                LOGE("Failed to add devInfoStr to returnGroupVec!");
-                FreeJson(devInfoJson);
-                FreeJson(json);
-                return HC_ERR_JSON_FAIL;
-            }
             ++devCount;
         }
     }
-    *returnDevInfoVec = PackJsonToString(json);
-    FreeJson(json);
+    *returnDevInfoVec = WriteJsonToString(WriteDeviceVecFunc, devInfoVec);
     if ((*returnDevInfoVec) == NULL) {
-        LOGE("Failed to convert json to string!");
+        LOGE("Failed to convert devInfoVec to string!");
         return HC_ERR_JSON_FAIL;
     }
     *deviceNum = devCount;
@@ -943,25 +897,9 @@ static int32_t GetAccessibleGroupInfoById(int32_t osAccountId, const char *appId
         LOGE("Failed to get groupEntry from db!");
         return HC_ERR_DB;
     }
-    CJson *groupInfoJson = CreateJson();
-    if (groupInfoJson == NULL) {
-        LOGE("Failed to allocate groupInfoJson memory!");
-        DestroyGroupEntry(groupEntry);
-        return HC_ERR_JSON_FAIL;
-    }
-    int32_t result = GenerateReturnGroupInfo(groupEntry, groupInfoJson);
+    int32_t result = GenerateReturnGroupInfo(groupEntry, returnGroupInfo);
     DestroyGroupEntry(groupEntry);
-    if (result != HC_SUCCESS) {
-        FreeJson(groupInfoJson);
-        return result;
-    }
-    *returnGroupInfo = PackJsonToString(groupInfoJson);
-    FreeJson(groupInfoJson);
-    if (*returnGroupInfo == NULL) {
-        LOGE("Failed to convert json to string!");
-        return HC_ERR_JSON_FAIL;
-    }
-    return HC_SUCCESS;
+    return result;
 }
 
 static int32_t GetAccessibleGroupInfo(int32_t osAccountId, const char *appId, const char *queryParams,
@@ -1018,15 +956,22 @@ static int32_t GetAccessibleJoinedGroups(int32_t osAccountId, const char *appId,
         LOGE("Invalid group type!");
         return HC_ERR_INVALID_PARAMS;
     }
+    GroupQueryKey key = { osAccountId, QUERY_JOINED_GROUPS, appId, groupType, NULL, NULL };
+    uint64_t generation = GetDbGeneration();
+    if (GetCachedQueryResult(&key, generation, returnGroupVec, groupNum)) {
+        return HC_SUCCESS;
+    }
     GroupEntryVec groupEntryVec = CreateGroupEntryVec();
-    int32_t result = GetJoinedGroups(osAccountId, groupType, &groupEntryVec);
+    int32_t result = GetJoinedGroups(osAccountId, appId, groupType, &groupEntryVec);
     if (result != HC_SUCCESS) {
         ClearGroupEntryVec(&groupEntryVec);
         return result;
     }
-    RemoveNoPermissionGroup(osAccountId, &groupEntryVec, appId);
     result = GenerateReturnGroupVec(&groupEntryVec, returnGroupVec, groupNum);
     ClearGroupEntryVec(&groupEntryVec);
+    if (result == HC_SUCCESS) {
+        CacheQueryResult(&key, generation, *returnGroupVec, *groupNum);
+    }
     return result;
 }
 
@@ -1040,6 +985,11 @@ static int32_t GetAccessibleRelatedGroups(int32_t osAccountId, const char *appId
         return HC_ERR_INVALID_PARAMS;
     }
     LOGI("Start to get related groups! [AppId]: %s", appId);
+    GroupQueryKey key = { osAccountId, QUERY_RELATED_GROUPS, appId, isUdid, peerDeviceId, NULL };
+    uint64_t generation = GetDbGeneration();
+    if (GetCachedQueryResult(&key, generation, returnGroupVec, groupNum)) {
+        return HC_SUCCESS;
+    }
     GroupEntryVec groupEntryVec = CreateGroupEntryVec();
     int32_t result = GetRelatedGroups(osAccountId, peerDeviceId, isUdid, &groupEntryVec);
     if (result != HC_SUCCESS) {
@@ -1049,6 +999,9 @@ static int32_t GetAccessibleRelatedGroups(int32_t osAccountId, const char *appId
     RemoveNoPermissionGroup(osAccountId, &groupEntryVec, appId);
     result = GenerateReturnGroupVec(&groupEntryVec, returnGroupVec, groupNum);
     ClearGroupEntryVec(&groupEntryVec);
+    if (result == HC_SUCCESS) {
+        CacheQueryResult(&key, generation, *returnGroupVec, *groupNum);
+    }
     return result;
 }
 
@@ -1079,25 +1032,9 @@ static int32_t GetAccessibleDeviceInfoById(int32_t osAccountId, const char *appI
         DestroyDeviceEntry(deviceEntry);
         return HC_ERR_DEVICE_NOT_EXIST;
     }
-    CJson *devInfoJson = CreateJson();
-    if (devInfoJson == NULL) {
-        LOGE("Failed to allocate devInfoJson memory!");
-        DestroyDeviceEntry(deviceEntry);
-        return HC_ERR_JSON_FAIL;
-    }
-    int32_t result = GenerateReturnDevInfo(deviceEntry, devInfoJson);
+    int32_t result = GenerateReturnDevInfo(deviceEntry, returnDeviceInfo);
     DestroyDeviceEntry(deviceEntry);
-    if (result != HC_SUCCESS) {
-        FreeJson(devInfoJson);
-        return result;
-    }
-    *returnDeviceInfo = PackJsonToString(devInfoJson);
-    FreeJson(devInfoJson);
-    if (*returnDeviceInfo == NULL) {
-        LOGE("Failed to convert json to string!");
-        return HC_ERR_JSON_FAIL;
-    }
-    return HC_SUCCESS;
+    return result;
 }
 
 static int32_t GetAccessibleTrustedDevices(int32_t osAccountId, const char *appId, const char *groupId,
@@ -1128,14 +1065,9 @@ static int32_t GetAccessibleTrustedDevices(int32_t osAccountId, const char *appI
     return result;
 }
 
-static bool IsDeviceInAccessibleGroup(int32_t osAccountId, const char *appId, const char *groupId,
+static bool IsDeviceInAccessibleGroupNoCache(int32_t osAccountId, const char *appId, const char *groupId,
     const char *deviceId, bool isUdid)
 {
-    osAccountId = DevAuthGetRealOsAccountLocalId(osAccountId);
-    if ((appId == NULL) || (groupId == NULL) || (deviceId == NULL) || (osAccountId == INVALID_OS_ACCOUNT)) {
-        LOGE("Invalid input parameters!");
-        return false;
-    }
     if (!IsGroupExistByGroupId(osAccountId, groupId)) {
         LOGE("No group is found based on the query parameters!");
         return false;
@@ -1147,6 +1079,25 @@ static bool IsDeviceInAccessibleGroup(int32_t osAccountId, const char *appId, co
     return IsTrustedDeviceInGroup(osAccountId, groupId, deviceId, isUdid);
 }
 
+static bool IsDeviceInAccessibleGroup(int32_t osAccountId, const char *appId, const char *groupId,
+    const char *deviceId, bool isUdid)
+{
+    osAccountId = DevAuthGetRealOsAccountLocalId(osAccountId);
+    if ((appId == NULL) || (groupId == NULL) || (deviceId == NULL) || (osAccountId == INVALID_OS_ACCOUNT)) {
+        LOGE("Invalid input parameters!");
+        return false;
+    }
+    GroupQueryKey key = { osAccountId, QUERY_DEVICE_IN_GROUP, appId, isUdid, groupId, deviceId };
+    uint64_t generation = GetDbGeneration();
+    uint32_t isInGroup = 0;
+    if (GetCachedQueryResult(&key, generation, NULL, &isInGroup)) {
+        return (isInGroup != 0);
+    }
+    bool result = IsDeviceInAccessibleGroupNoCache(osAccountId, appId, groupId, deviceId, isUdid);
+    CacheQueryResult(&key, generation, NULL, result ? 1 : 0);
+    return result;
+}
+
 static int32_t GetPkInfoList(int32_t osAccountId, const char *appId, const char *queryParams,
     char **returnInfoList, uint32_t *returnInfoNum)
 {
@@ -1224,9 +1175,14 @@ static const GroupImpl g_groupImplInstance = {
 
 int32_t InitGroupRelatedModule(void)
 {
+    if (InitGroupQueryCache() != HC_SUCCESS) {
+        LOGE("[End]: [Service]: Failed to init group query cache!");
+        return HC_ERR_SERVICE_NEED_RESTART;
+    }
     if (IsBroadcastSupported()) {
         if (InitBroadcastManager() != HC_SUCCESS) {
             LOGE("[End]: [Service]: Failed to init broadcast manage module!");
+            DestroyGroupQueryCache();
             return HC_ERR_SERVICE_NEED_RESTART;
         }
     }
@@ -1236,6 +1192,7 @@ int32_t InitGroupRelatedModule(void)
 void DestroyGroupRelatedModule(void)
 {
     DestroyBroadcastManager();
+    DestroyGroupQueryCache();
 }
 
 const GroupImpl *GetGroupImplInstance(void)
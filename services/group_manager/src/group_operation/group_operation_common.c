@@ -15,7 +15,9 @@
 
 #include "group_operation_common.h"
 
+#include "account_module.h"
 #include "alg_loader.h"
+#include "clib_error.h"
 #include "string_util.h"
 #include "common_defs.h"
 #include "data_manager.h"
@@ -26,28 +28,23 @@
 #include "hc_dev_info.h"
 #include "hc_log.h"
 
-static bool IsGroupManager(const char *appId, const TrustedGroupEntry *entry)
+static int32_t CheckGroupManagerVisitor(const TrustedGroupEntry *entry, void *ctx)
 {
     uint32_t index;
     HcString *manager = NULL;
     FOR_EACH_HC_VECTOR(entry->managers, index, manager) {
-        if (strcmp(StringGet(manager), appId) == 0) {
-            return true;
+        if (strcmp(StringGet(manager), (const char *)ctx) == 0) {
+            return HC_SUCCESS;
         }
     }
-    return false;
+    return HC_ERR_ACCESS_DENIED;
 }
 
-static bool IsGroupFriend(const char *appId, const TrustedGroupEntry *entry)
+static int32_t VisitGroupById(int32_t osAccountId, const char *groupId, GroupEntryVisitor visitor, void *ctx)
 {
-    uint32_t index;
-    HcString *trustedFriend = NULL;
-    FOR_EACH_HC_VECTOR(entry->friends, index, trustedFriend) {
-        if (strcmp(StringGet(trustedFriend), appId) == 0) {
-            return true;
-        }
-    }
-    return false;
+    QueryGroupParams params = InitQueryGroupParams();
+    params.groupId = groupId;
+    return VisitGroup(osAccountId, &params, visitor, ctx);
 }
 
 static int32_t GetGroupNumByOwner(int32_t osAccountId, const char *ownerName)
@@ -71,12 +68,16 @@ static int32_t GetGroupNumByOwner(int32_t osAccountId, const char *ownerName)
     return count;
 }
 
+static int32_t CopyDeviceEntryVisitor(const TrustedDeviceEntry *entry, void *ctx)
+{
+    *(TrustedDeviceEntry **)ctx = DeepCopyDeviceEntry(entry);
+    return HC_SUCCESS;
+}
+
 TrustedDeviceEntry *GetTrustedDeviceEntryById(int32_t osAccountId, const char *deviceId, bool isUdid,
     const char *groupId)
 {
-    uint32_t index;
-    TrustedDeviceEntry **deviceEntry = NULL;
-    DeviceEntryVec deviceEntryVec = CreateDeviceEntryVec();
+    TrustedDeviceEntry *returnEntry = NULL;
     QueryDeviceParams params = InitQueryDeviceParams();
     params.groupId = groupId;
     if (isUdid) {
@@ -84,20 +85,14 @@ TrustedDeviceEntry *GetTrustedDeviceEntryById(int32_t osAccountId, const char *d
     } else {
         params.authId = deviceId;
     }
-    if (QueryDevices(osAccountId, &params, &deviceEntryVec) != HC_SUCCESS) {
-        LOGE("Failed to query trusted devices!");
-        ClearDeviceEntryVec(&deviceEntryVec);
-        return NULL;
-    }
-    FOR_EACH_HC_VECTOR(deviceEntryVec, index, deviceEntry) {
-        if ((deviceEntry != NULL) && (*deviceEntry != NULL)) {
-            TrustedDeviceEntry *returnEntry = DeepCopyDeviceEntry(*deviceEntry);
-            ClearDeviceEntryVec(&deviceEntryVec);
-            return returnEntry;
-        }
-    }
-    ClearDeviceEntryVec(&deviceEntryVec);
-    return NULL;
+    (void)VisitDevice(osAccountId, &params, CopyDeviceEntryVisitor, &returnEntry);
+    return returnEntry;
+}
+
+static int32_t CopyGroupEntryVisitor(const TrustedGroupEntry *entry, void *ctx)
+{
+    *(TrustedGroupEntry **)ctx = DeepCopyGroupEntry(entry);
+    return HC_SUCCESS;
 }
 
 TrustedGroupEntry *GetGroupEntryById(int32_t osAccountId, const char *groupId)
@@ -106,25 +101,9 @@ TrustedGroupEntry *GetGroupEntryById(int32_t osAccountId, const char *groupId)
         LOGE("The input groupId is NULL!");
         return NULL;
     }
-    uint32_t index;
-    TrustedGroupEntry **entry = NULL;
-    GroupEntryVec groupEntryVec = CreateGroupEntryVec();
-    QueryGroupParams params = InitQueryGroupParams();
-    params.groupId = groupId;
-    if (QueryGroups(osAccountId, &params, &groupEntryVec) != HC_SUCCESS) {
-        LOGE("Failed to query groups!");
-        ClearGroupEntryVec(&groupEntryVec);
-        return NULL;
-    }
-    FOR_EACH_HC_VECTOR(groupEntryVec, index, entry) {
-        if ((entry != NULL) && (*entry != NULL)) {
-            TrustedGroupEntry *returnEntry = DeepCopyGroupEntry(*entry);
-            ClearGroupEntryVec(&groupEntryVec);
-            return returnEntry;
-        }
-    }
-    ClearGroupEntryVec(&groupEntryVec);
-    return NULL;
+    TrustedGroupEntry *returnEntry = NULL;
+    (void)VisitGroupById(osAccountId, groupId, CopyGroupEntryVisitor, &returnEntry);
+    return returnEntry;
 }
 
 bool IsTrustedDeviceInGroup(int32_t osAccountId, const char *groupId, const char *deviceId, bool isUdid)
@@ -133,12 +112,14 @@ bool IsTrustedDeviceInGroup(int32_t osAccountId, const char *groupId, const char
         LOGE("The input groupId or deviceId is NULL!");
         return false;
     }
-    TrustedDeviceEntry *entry = GetTrustedDeviceEntryById(osAccountId, deviceId, isUdid, groupId);
-    if (entry == NULL) {
-        return false;
+    QueryDeviceParams params = InitQueryDeviceParams();
+    params.groupId = groupId;
+    if (isUdid) {
+        params.udid = deviceId;
+    } else {
+        params.authId = deviceId;
     }
-    DestroyDeviceEntry(entry);
-    return true;
+    return ExistsDevice(osAccountId, &params);
 }
 
 int32_t CheckGroupNumLimit(int32_t osAccountId, int32_t groupType, const char *appId)
@@ -163,30 +144,28 @@ bool IsLocalDevice(const char *udid)
     return (strcmp(localUdid, udid) == 0);
 }
 
+static int32_t CheckGroupOwnerVisitor(const TrustedGroupEntry *entry, void *ctx)
+{
+    if (HC_VECTOR_SIZE(&entry->managers) <= 0) {
+        LOGE("The group does not have manager and owner!");
+        return HC_ERR_ACCESS_DENIED;
+    }
+    HcString entryManager = HC_VECTOR_GET(&entry->managers, 0);
+    const char *groupOwner = StringGet(&entryManager);
+    return ((groupOwner != NULL) && (strcmp(groupOwner, (const char *)ctx) == 0)) ? HC_SUCCESS : HC_ERR_ACCESS_DENIED;
+}
+
 bool IsGroupOwner(int32_t osAccountId, const char *groupId, const char *appId)
 {
     if ((groupId == NULL) || (appId == NULL)) {
         LOGE("The input groupId or appId is NULL!");
         return false;
     }
-    TrustedGroupEntry *entry = GetGroupEntryById(osAccountId, groupId);
-    if (entry == NULL) {
+    int32_t res = VisitGroupById(osAccountId, groupId, CheckGroupOwnerVisitor, (void *)appId);
+    if (res == HC_ERR_GROUP_NOT_EXIST) {
         LOGE("The group cannot be found!");
-        return false;
     }
-    if (HC_VECTOR_SIZE(&entry->managers) <= 0) {
-        LOGE("The group does not have manager and owner!");
-        DestroyGroupEntry(entry);
-        return false;
-    }
-    HcString entryManager = HC_VECTOR_GET(&entry->managers, 0);
-    const char *groupOwner = StringGet(&entryManager);
-    if ((groupOwner != NULL) && strcmp(groupOwner, appId) == 0) {
-        DestroyGroupEntry(entry);
-        return true;
-    }
-    DestroyGroupEntry(entry);
-    return false;
+    return (res == HC_SUCCESS);
 }
 
 bool IsGroupExistByGroupId(int32_t osAccountId, const char *groupId)
@@ -195,12 +174,9 @@ bool IsGroupExistByGroupId(int32_t osAccountId, const char *groupId)
         LOGE("The input groupId is NULL!");
         return false;
     }
-    TrustedGroupEntry *entry = GetGroupEntryById(osAccountId, groupId);
-    if (entry == NULL) {
-        return false;
-    }
-    DestroyGroupEntry(entry);
-    return true;
+    QueryGroupParams params = InitQueryGroupParams();
+    params.groupId = groupId;
+    return ExistsGroup(osAccountId, &params);
 }
 
 int32_t CheckGroupAccessible(int32_t osAccountId, const char *groupId, const char *appId)
@@ -209,19 +185,11 @@ int32_t CheckGroupAccessible(int32_t osAccountId, const char *groupId, const cha
         LOGE("The input groupId or appId is NULL!");
         return HC_ERR_NULL_PTR;
     }
-    TrustedGroupEntry *entry = GetGroupEntryById(osAccountId, groupId);
-    if (entry == NULL) {
+    int32_t res = CheckGroupAccess(osAccountId, groupId, appId);
+    if (res == HC_ERR_GROUP_NOT_EXIST) {
         LOGE("The group cannot be found!");
-        return HC_ERR_GROUP_NOT_EXIST;
-    }
-    if ((entry->visibility != GROUP_VISIBILITY_PUBLIC) &&
-        (!IsGroupManager(appId, entry)) &&
-        (!IsGroupFriend(appId, entry))) {
-        DestroyGroupEntry(entry);
-        return HC_ERR_ACCESS_DENIED;
     }
-    DestroyGroupEntry(entry);
-    return HC_SUCCESS;
+    return res;
 }
 
 int32_t CheckGroupEditAllowed(int32_t osAccountId, const char *groupId, const char *appId)
@@ -230,17 +198,11 @@ int32_t CheckGroupEditAllowed(int32_t osAccountId, const char *groupId, const ch
         LOGE("The input groupId or appId is NULL!");
         return HC_ERR_NULL_PTR;
     }
-    TrustedGroupEntry *entry = GetGroupEntryById(osAccountId, groupId);
-    if (entry == NULL) {
+    int32_t res = VisitGroupById(osAccountId, groupId, CheckGroupManagerVisitor, (void *)appId);
+    if (res == HC_ERR_GROUP_NOT_EXIST) {
         LOGE("The group cannot be found!");
-        return HC_ERR_GROUP_NOT_EXIST;
-    }
-    if (!IsGroupManager(appId, entry)) {
-        DestroyGroupEntry(entry);
-        return HC_ERR_ACCESS_DENIED;
     }
-    DestroyGroupEntry(entry);
-    return HC_SUCCESS;
+    return res;
 }
 
 int32_t GetGroupInfo(int32_t osAccountId, int groupType, const char *groupId, const char *groupName,
@@ -259,10 +221,11 @@ int32_t GetGroupInfo(int32_t osAccountId, int groupType, const char *groupId, co
     return QueryGroups(osAccountId, &params, returnGroupEntryVec);
 }
 
-int32_t GetJoinedGroups(int32_t osAccountId, int groupType, GroupEntryVec *returnGroupEntryVec)
+int32_t GetJoinedGroups(int32_t osAccountId, const char *appId, int groupType, GroupEntryVec *returnGroupEntryVec)
 {
     QueryGroupParams params = InitQueryGroupParams();
     params.groupType = groupType;
+    params.appId = appId;
     return QueryGroups(osAccountId, &params, returnGroupEntryVec);
 }
 
@@ -329,128 +292,90 @@ int32_t GetTrustedDevices(int32_t osAccountId, const char *groupId, DeviceEntryV
     return QueryDevices(osAccountId, &params, returnDeviceEntryVec);
 }
 
-static int32_t AddGroupNameToReturn(const TrustedGroupEntry *groupInfo, CJson *json)
+static int32_t WriteStringToReturn(JsonWriter *writer, const char *key, const char *value)
 {
-    const char *groupName = StringGet(&groupInfo->name);
-    if (groupName == NULL) {
-        LOGE("Failed to get groupName from groupInfo!");
+    if (value == NULL) {
+        LOGE("Failed to get %s from entry!", key);
         return HC_ERR_NULL_PTR;
     }
-    if (AddStringToJson(json, FIELD_GROUP_NAME, groupName) != HC_SUCCESS) {
-        LOGE("Failed to add groupName to json!");
+    if (JsonWriterAddString(writer, key, value) != CLIB_SUCCESS) {
+        LOGE("Failed to write %s to json!", key);
         return HC_ERR_JSON_FAIL;
     }
     return HC_SUCCESS;
 }
 
-static int32_t AddGroupIdToReturn(const TrustedGroupEntry *groupInfo, CJson *json)
+static int32_t WriteIntToReturn(JsonWriter *writer, const char *key, int32_t value)
 {
-    const char *groupId = StringGet(&groupInfo->id);
-    if (groupId == NULL) {
-        LOGE("Failed to get groupId from groupInfo!");
-        return HC_ERR_NULL_PTR;
-    }
-    if (AddStringToJson(json, FIELD_GROUP_ID, groupId) != HC_SUCCESS) {
-        LOGE("Failed to add groupId to json!");
+    if (JsonWriterAddInt(writer, key, value) != CLIB_SUCCESS) {
+        LOGE("Failed to write %s to json!", key);
         return HC_ERR_JSON_FAIL;
     }
     return HC_SUCCESS;
 }
 
-static int32_t AddGroupOwnerToReturn(const TrustedGroupEntry *groupInfo, CJson *json)
+bool IsAccountRelatedGroup(int groupType)
 {
-    HcString entryManager = HC_VECTOR_GET(&groupInfo->managers, 0);
-    const char *groupOwner = StringGet(&entryManager);
-    if (groupOwner == NULL) {
-        LOGE("Failed to get groupOwner from groupInfo!");
-        return HC_ERR_NULL_PTR;
-    }
-    if (AddStringToJson(json, FIELD_GROUP_OWNER, groupOwner) != HC_SUCCESS) {
-        LOGE("Failed to add groupOwner to json!");
-        return HC_ERR_JSON_FAIL;
-    }
-    return HC_SUCCESS;
+    return ((groupType == IDENTICAL_ACCOUNT_GROUP) || (groupType == ACROSS_ACCOUNT_AUTHORIZE_GROUP));
 }
 
-static int32_t AddGroupTypeToReturn(const TrustedGroupEntry *groupInfo, CJson *json)
+int32_t WriteReturnGroupInfo(JsonWriter *writer, const TrustedGroupEntry *groupEntry)
 {
-    int32_t groupType = groupInfo->type;
-    if (AddIntToJson(json, FIELD_GROUP_TYPE, groupType) != HC_SUCCESS) {
-        LOGE("Failed to add groupType to json!");
+    HcString entryManager = HC_VECTOR_GET(&groupEntry->managers, 0);
+    int32_t result;
+    if (JsonWriterStartObject(writer, NULL) != CLIB_SUCCESS) {
         return HC_ERR_JSON_FAIL;
     }
-    return HC_SUCCESS;
-}
-
-static int32_t AddGroupVisibilityToReturn(const TrustedGroupEntry *groupInfo, CJson *json)
-{
-    int groupVisibility = groupInfo->visibility;
-    if (AddIntToJson(json, FIELD_GROUP_VISIBILITY, groupVisibility) != HC_SUCCESS) {
-        LOGE("Failed to add groupType to json!");
-        return HC_ERR_JSON_FAIL;
+    if (((result = WriteStringToReturn(writer, FIELD_GROUP_NAME, StringGet(&groupEntry->name))) != HC_SUCCESS) ||
+        ((result = WriteStringToReturn(writer, FIELD_GROUP_ID, StringGet(&groupEntry->id))) != HC_SUCCESS) ||
+        ((result = WriteStringToReturn(writer, FIELD_GROUP_OWNER, StringGet(&entryManager))) != HC_SUCCESS) ||
+        ((result = WriteIntToReturn(writer, FIELD_GROUP_TYPE, groupEntry->type)) != HC_SUCCESS) ||
+        ((result = WriteIntToReturn(writer, FIELD_GROUP_VISIBILITY, groupEntry->visibility)) != HC_SUCCESS)) {
+        return result;
     }
-    return HC_SUCCESS;
+    return (JsonWriterEndObject(writer) == CLIB_SUCCESS) ? HC_SUCCESS : HC_ERR_JSON_FAIL;
 }
 
-static int32_t AddAuthIdToReturn(const TrustedDeviceEntry *deviceInfo, CJson *json)
+int32_t WriteReturnDevInfo(JsonWriter *writer, const TrustedDeviceEntry *devInfo)
 {
-    const char *authId = StringGet(&deviceInfo->authId);
-    if (authId == NULL) {
-        LOGE("Failed to get authId from deviceInfo!");
-        return HC_ERR_NULL_PTR;
-    }
-    if (AddStringToJson(json, FIELD_AUTH_ID, authId) != HC_SUCCESS) {
-        LOGE("Failed to add authId to json!");
+    int32_t result;
+    if (JsonWriterStartObject(writer, NULL) != CLIB_SUCCESS) {
         return HC_ERR_JSON_FAIL;
     }
-    return HC_SUCCESS;
-}
-
-static int32_t AddCredentialTypeToReturn(const TrustedDeviceEntry *deviceInfo, CJson *json)
-{
-    int credentialType = deviceInfo->credential;
-    if (AddIntToJson(json, FIELD_CREDENTIAL_TYPE, credentialType) != HC_SUCCESS) {
-        LOGE("Failed to add credentialType to json!");
-        return HC_ERR_JSON_FAIL;
+    if (((result = WriteStringToReturn(writer, FIELD_AUTH_ID, StringGet(&devInfo->authId))) != HC_SUCCESS) ||
+        ((result = WriteIntToReturn(writer, FIELD_CREDENTIAL_TYPE, devInfo->credential)) != HC_SUCCESS) ||
+        ((result = WriteIntToReturn(writer, FIELD_USER_TYPE, devInfo->devType)) != HC_SUCCESS)) {
+        return result;
     }
-    return HC_SUCCESS;
+    return (JsonWriterEndObject(writer) == CLIB_SUCCESS) ? HC_SUCCESS : HC_ERR_JSON_FAIL;
 }
 
-static int32_t AddUserTypeToReturn(const TrustedDeviceEntry *deviceInfo, CJson *json)
+static int32_t WriteGroupInfoFunc(JsonWriter *writer, const void *ctx)
 {
-    int userType = deviceInfo->devType;
-    if (AddIntToJson(json, FIELD_USER_TYPE, userType) != HC_SUCCESS) {
-        LOGE("Failed to add userType to json!");
-        return HC_ERR_JSON_FAIL;
-    }
-    return HC_SUCCESS;
+    return (WriteReturnGroupInfo(writer, (const TrustedGroupEntry *)ctx) == HC_SUCCESS) ? CLIB_SUCCESS : CLIB_FAILED;
 }
 
-bool IsAccountRelatedGroup(int groupType)
+static int32_t WriteDevInfoFunc(JsonWriter *writer, const void *ctx)
 {
-    return ((groupType == IDENTICAL_ACCOUNT_GROUP) || (groupType == ACROSS_ACCOUNT_AUTHORIZE_GROUP));
+    return (WriteReturnDevInfo(writer, (const TrustedDeviceEntry *)ctx) == HC_SUCCESS) ? CLIB_SUCCESS : CLIB_FAILED;
 }
 
-int32_t GenerateReturnGroupInfo(const TrustedGroupEntry *groupEntry, CJson *returnJson)
+int32_t GenerateReturnGroupInfo(const TrustedGroupEntry *groupEntry, char **returnGroupInfo)
 {
-    int32_t result;
-    if (((result = AddGroupNameToReturn(groupEntry, returnJson)) != HC_SUCCESS) ||
-        ((result = AddGroupIdToReturn(groupEntry, returnJson)) != HC_SUCCESS) ||
-        ((result = AddGroupOwnerToReturn(groupEntry, returnJson)) != HC_SUCCESS) ||
-        ((result = AddGroupTypeToReturn(groupEntry, returnJson)) != HC_SUCCESS) ||
-        ((result = AddGroupVisibilityToReturn(groupEntry, returnJson)) != HC_SUCCESS)) {
-        return result;
+    *returnGroupInfo = WriteJsonToString(WriteGroupInfoFunc, groupEntry);
+    if (*returnGroupInfo == NULL) {
+        LOGE("Failed to convert groupInfo to string!");
+        return HC_ERR_JSON_FAIL;
     }
     return HC_SUCCESS;
 }
 
-int32_t GenerateReturnDevInfo(const TrustedDeviceEntry *devInfo, CJson *returnJson)
+int32_t GenerateReturnDevInfo(const TrustedDeviceEntry *devInfo, char **returnDevInfo)
 {
-    int32_t result;
-    if (((result = AddAuthIdToReturn(devInfo, returnJson)) != HC_SUCCESS) ||
-        ((result = AddCredentialTypeToReturn(devInfo, returnJson)) != HC_SUCCESS) ||
-        ((result = AddUserTypeToReturn(devInfo, returnJson)) != HC_SUCCESS)) {
-        return result;
+    *returnDevInfo = WriteJsonToString(WriteDevInfoFunc, devInfo);
+    if (*returnDevInfo == NULL) {
+        LOGE("Failed to convert devInfo to string!");
+        return HC_ERR_JSON_FAIL;
     }
     return HC_SUCCESS;
 }
@@ -503,19 +428,9 @@ int32_t GetCurDeviceNumByGroupId(int32_t osAccountId, const char *groupId)
         LOGE("The input groupId is NULL!");
         return 0;
     }
-    int count = 0;
     QueryDeviceParams queryDeviceParams = InitQueryDeviceParams();
     queryDeviceParams.groupId = groupId;
-    DeviceEntryVec deviceEntryVec = CreateDeviceEntryVec();
-    int32_t result = QueryDevices(osAccountId, &queryDeviceParams, &deviceEntryVec);
-    if (result != HC_SUCCESS) {
-        LOGE("Failed to query trusted devices!");
-        ClearDeviceEntryVec(&deviceEntryVec);
-        return result;
-    }
-    count = HC_VECTOR_SIZE(&deviceEntryVec);
-    ClearDeviceEntryVec(&deviceEntryVec);
-    return count;
+    return (int32_t)CountDevices(osAccountId, &queryDeviceParams);
 }
 
 int32_t CheckDeviceNumLimit(int32_t osAccountId, const char *groupId, const char *peerUdid)
@@ -895,21 +810,302 @@ int32_t AddDeviceToDatabaseByJson(int32_t osAccountId, int32_t (*generateDevPara
     return result;
 }
 
-int32_t DelGroupFromDb(int32_t osAccountId, const char *groupId)
+static int32_t CopyAuthIdVisitor(const TrustedDeviceEntry *entry, void *ctx)
+{
+    return StringSet((HcString *)ctx, entry->authId) ? HC_SUCCESS : HC_ERR_MEMORY_COPY;
+}
+
+int32_t GetPeerAuthIdsFromDeviceList(int32_t osAccountId, const char *groupId, const CJson *deviceList,
+    StringVector *authIds)
+{
+    if ((groupId == NULL) || (deviceList == NULL) || (authIds == NULL)) {
+        LOGE("The input parameters contains NULL value!");
+        return HC_ERR_INVALID_PARAMS;
+    }
+    char localUdid[INPUT_UDID_LEN] = { 0 };
+    int32_t res = HcGetUdid((uint8_t *)localUdid, INPUT_UDID_LEN);
+    if (res != HC_SUCCESS) {
+        LOGE("Failed to get local udid! res: %d", res);
+        return res;
+    }
+    QueryDeviceParams params = InitQueryDeviceParams();
+    params.groupId = groupId;
+    params.udid = localUdid;
+    HcString localAuthId = CreateString();
+    /* If the local device is not in the group there is nothing to keep back. */
+    (void)VisitDevice(osAccountId, &params, CopyAuthIdVisitor, &localAuthId);
+    int32_t deviceNum = GetItemNum(deviceList);
+    for (int32_t i = 0; i < deviceNum; i++) {
+        const char *deviceId = GetStringFromJson(GetItemFromArray(deviceList, i), FIELD_DEVICE_ID);
+        if (deviceId == NULL) {
+            LOGE("Failed to get deviceId from json!");
+            continue;
+        }
+        if (strcmp(deviceId, StringGet(&localAuthId)) == 0) {
+            LOGE("Do not delete the local device!");
+            continue;
+        }
+        HcString authId = CreateString();
+        if (!StringSetPointer(&authId, deviceId) || (authIds->pushBackT(authIds, authId) == NULL)) {
+            LOGE("Failed to add authId to vec!");
+            DeleteString(&authId);
+            DeleteString(&localAuthId);
+            return HC_ERR_MEMORY_COPY;
+        }
+    }
+    DeleteString(&localAuthId);
+    return HC_SUCCESS;
+}
+
+static int32_t GenerateAddTokenParams(const CJson *jsonParams, CJson *addParams)
+{
+    const char *userId = GetStringFromJson(jsonParams, FIELD_USER_ID);
+    if (userId == NULL) {
+        LOGE("Failed to get userId from json!");
+        return HC_ERR_JSON_GET;
+    }
+    const char *deviceId = GetStringFromJson(jsonParams, FIELD_DEVICE_ID);
+    if (deviceId == NULL) {
+        LOGE("Failed to get deviceId from json!");
+        return HC_ERR_JSON_GET;
+    }
+    if (AddStringToJson(addParams, FIELD_DEVICE_ID, deviceId) != HC_SUCCESS) {
+        LOGE("Failed to add deviceId to json!");
+        return HC_ERR_JSON_ADD;
+    }
+    if (AddStringToJson(addParams, FIELD_USER_ID, userId) != HC_SUCCESS) {
+        LOGE("Failed to add userId to json!");
+        return HC_ERR_JSON_ADD;
+    }
+    return HC_SUCCESS;
+}
+
+static int32_t GenerateDelTokenParams(const TrustedDeviceEntry *entry, CJson *delParams)
+{
+    if (AddIntToJson(delParams, FIELD_CREDENTIAL_TYPE, (int32_t)entry->credential) != HC_SUCCESS) {
+        LOGE("Failed to add credentialType to json!");
+        return HC_ERR_JSON_ADD;
+    }
+    if (AddStringToJson(delParams, FIELD_USER_ID, StringGet(&entry->userId)) != HC_SUCCESS) {
+        LOGE("Failed to add userId to json!");
+        return HC_ERR_JSON_ADD;
+    }
+    if (AddStringToJson(delParams, FIELD_DEVICE_ID, StringGet(&entry->authId)) != HC_SUCCESS) {
+        LOGE("Failed to add deviceId to json!");
+        return HC_ERR_JSON_ADD;
+    }
+    return HC_SUCCESS;
+}
+
+int32_t DelPeerDeviceToken(int32_t osAccountId, const TrustedDeviceEntry *entry)
+{
+    if (entry == NULL) {
+        LOGE("The input entry is NULL!");
+        return HC_ERR_NULL_PTR;
+    }
+    CJson *delParams = CreateJson();
+    if (delParams == NULL) {
+        LOGE("Failed to allocate delParams memory!");
+        return HC_ERR_ALLOC_MEMORY;
+    }
+    int32_t res = GenerateDelTokenParams(entry, delParams);
+    if (res != HC_SUCCESS) {
+        FreeJson(delParams);
+        return res;
+    }
+    res = ProcessAccountCredentials(osAccountId, DELETE_TRUSTED_CREDENTIALS, delParams, NULL);
+    FreeJson(delParams);
+    return res;
+}
+
+static int32_t ImportMemberToken(int32_t osAccountId, CJson *deviceInfo)
+{
+    CJson *credential = GetObjFromJson(deviceInfo, FIELD_CREDENTIAL);
+    if (credential == NULL) {
+        LOGE("Failed to get credential from json!");
+        return HC_ERR_JSON_GET;
+    }
+    int32_t res = GenerateAddTokenParams(deviceInfo, credential);
+    if (res != HC_SUCCESS) {
+        return res;
+    }
+    res = ProcessAccountCredentials(osAccountId, IMPORT_TRUSTED_CREDENTIALS, credential, NULL);
+    if (res != HC_SUCCESS) {
+        LOGE("Failed to import device token! res: %d", res);
+    }
+    return res;
+}
+
+/* The capacity of memberEntries has been reserved for every member, the push below does not reallocate. */
+static int32_t PrepareMemberToAdd(int32_t osAccountId, int32_t (*generateDevParams)(const CJson*, const char*,
+    TrustedDeviceEntry*), CJson *deviceInfo, const char *groupId, DeviceEntryVec *memberEntries)
+{
+    TrustedDeviceEntry *entry = CreateDeviceEntry();
+    if (entry == NULL) {
+        LOGE("Failed to allocate device entry memory!");
+        return HC_ERR_ALLOC_MEMORY;
+    }
+    int32_t res = (*generateDevParams)(deviceInfo, groupId, entry);
+    if (res != HC_SUCCESS) {
+        LOGE("Failed to generate device params! res: %d", res);
+        DestroyDeviceEntry(entry);
+        return res;
+    }
+    res = ImportMemberToken(osAccountId, deviceInfo);
+    if (res != HC_SUCCESS) {
+        DestroyDeviceEntry(entry);
+        return res;
+    }
+    (void)memberEntries->pushBackT(memberEntries, entry);
+    return HC_SUCCESS;
+}
+
+/* Validate every member and import its token first, the members which fail are skipped. */
+static void PrepareMembersToAdd(int32_t osAccountId, int32_t (*generateDevParams)(const CJson*, const char*,
+    TrustedDeviceEntry*), const CJson *deviceList, const char *groupId, DeviceEntryVec *memberEntries)
+{
+    int32_t deviceNum = GetItemNum(deviceList);
+    for (int32_t i = 0; i < deviceNum; i++) {
+        CJson *deviceInfo = GetItemFromArray(deviceList, i);
+        if (deviceInfo == NULL) {
+            LOGE("The deviceInfo is NULL!");
+            continue;
+        }
+        (void)PrepareMemberToAdd(osAccountId, generateDevParams, deviceInfo, groupId, memberEntries);
+    }
+}
+
+/*
+ * The tokens of the members already trusted were overwritten and are kept. If the batch could not even be indexed,
+ * no member is known to be new and the imported tokens are kept: deleting the token of a trusted member would break
+ * its authentication, a stale token is only left unused.
+ */
+static void DelNewMemberTokens(int32_t osAccountId, const DeviceEntryVec *memberEntries, const bool *isNewMembers)
+{
+    uint32_t index;
+    TrustedDeviceEntry **entry = NULL;
+    FOR_EACH_HC_VECTOR(*memberEntries, index, entry) {
+        if (!isNewMembers[index]) {
+            continue;
+        }
+        int32_t res = DelPeerDeviceToken(osAccountId, *entry);
+        if (res != HC_SUCCESS) {
+            LOGE("Failed to delete peer device token! res: %d", res);
+        }
+    }
+}
+
+/* Everything a failed batch needs to roll its tokens back is allocated before the first token is imported. */
+static int32_t ReserveMembersToAdd(const CJson *deviceList, DeviceEntryVec *memberEntries, bool **isNewMembers)
+{
+    int32_t deviceNum = GetItemNum(deviceList);
+    if (deviceNum <= 0) {
+        return HC_SUCCESS;
+    }
+    if (!HC_VECTOR_RESERVE(memberEntries, (uint32_t)deviceNum)) {
+        LOGE("Failed to reserve member entries memory! [Num]: %d", deviceNum);
+        return HC_ERR_ALLOC_MEMORY;
+    }
+    *isNewMembers = (bool *)HcMalloc((uint32_t)deviceNum * sizeof(bool), 0);
+    if (*isNewMembers == NULL) {
+        LOGE("Failed to allocate isNewMembers memory!");
+        return HC_ERR_ALLOC_MEMORY;
+    }
+    return HC_SUCCESS;
+}
+
+int32_t AddMembersToDatabaseByJson(int32_t osAccountId, int32_t (*generateDevParams)(const CJson*, const char*,
+    TrustedDeviceEntry*), const CJson *deviceList, const char *groupId, uint32_t *addedCount)
+{
+    if ((generateDevParams == NULL) || (deviceList == NULL) || (groupId == NULL) || (addedCount == NULL)) {
+        LOGE("The input parameters contains NULL value!");
+        return HC_ERR_INVALID_PARAMS;
+    }
+    *addedCount = 0;
+    DeviceEntryVec memberEntries = CreateDeviceEntryVec();
+    bool *isNewMembers = NULL;
+    int32_t res = ReserveMembersToAdd(deviceList, &memberEntries, &isNewMembers);
+    if ((res != HC_SUCCESS) || (isNewMembers == NULL)) {
+        ClearDeviceEntryVec(&memberEntries);
+        return res;
+    }
+    PrepareMembersToAdd(osAccountId, generateDevParams, deviceList, groupId, &memberEntries);
+    *addedCount = HC_VECTOR_SIZE(&memberEntries);
+    if (*addedCount == 0) {
+        HcFree(isNewMembers);
+        ClearDeviceEntryVec(&memberEntries);
+        return HC_SUCCESS;
+    }
+    res = AddTrustedDevices(osAccountId, &memberEntries, isNewMembers);
+    if (res != HC_SUCCESS) {
+        LOGE("Failed to add devices to database! res: %d", res);
+        DelNewMemberTokens(osAccountId, &memberEntries, isNewMembers);
+    }
+    HcFree(isNewMembers);
+    ClearDeviceEntryVec(&memberEntries);
+    if (res != HC_SUCCESS) {
+        return res;
+    }
+    res = SaveOsAccountDb(osAccountId);
+    if (res != HC_SUCCESS) {
+        LOGE("Failed to save database! res: %d", res);
+    }
+    return res;
+}
+
+int32_t DelMembersFromDatabaseByJson(int32_t osAccountId, const CJson *deviceList, const char *groupId,
+    uint32_t *deletedCount)
+{
+    if (deletedCount == NULL) {
+        LOGE("The input deletedCount is NULL!");
+        return HC_ERR_INVALID_PARAMS;
+    }
+    *deletedCount = 0;
+    StringVector authIds = CreateStrVector();
+    int32_t res = GetPeerAuthIdsFromDeviceList(osAccountId, groupId, deviceList, &authIds);
+    if ((res != HC_SUCCESS) || (HC_VECTOR_SIZE(&authIds) == 0)) {
+        DestroyStrVector(&authIds);
+        return res;
+    }
+    DeviceEntryVec delEntries = CreateDeviceEntryVec();
+    res = DelTrustedDevices(osAccountId, groupId, &authIds, &delEntries);
+    DestroyStrVector(&authIds);
+    if (res != HC_SUCCESS) {
+        LOGE("Failed to delete devices from database! res: %d", res);
+        ClearDeviceEntryVec(&delEntries);
+        return res;
+    }
+    *deletedCount = HC_VECTOR_SIZE(&delEntries);
+    uint32_t index;
+    TrustedDeviceEntry **entry = NULL;
+    FOR_EACH_HC_VECTOR(delEntries, index, entry) {
+        if (IsLocalDevice(StringGet(&(*entry)->udid))) {
+            continue;
+        }
+        res = DelPeerDeviceToken(osAccountId, *entry);
+        if (res != HC_SUCCESS) {
+            LOGE("Failed to delete peer device token! res: %d", res);
+        }
+    }
+    ClearDeviceEntryVec(&delEntries);
+    if (*deletedCount == 0) {
+        return HC_SUCCESS;
+    }
+    res = SaveOsAccountDb(osAccountId);
+    if (res != HC_SUCCESS) {
+        LOGE("Failed to save database! res: %d", res);
+    }
+    return res;
+}
+
+int32_t DelGroupAndDevicesFromDb(int32_t osAccountId, const char *groupId, DeviceEntryVec *delEntries)
 {
     if (groupId == NULL) {
         LOGE("The input groupId is NULL!");
         return HC_ERR_NULL_PTR;
     }
-    QueryGroupParams queryGroupParams = InitQueryGroupParams();
-    queryGroupParams.groupId = groupId;
-    QueryDeviceParams queryDeviceParams = InitQueryDeviceParams();
-    queryDeviceParams.groupId = groupId;
     int32_t result = HC_SUCCESS;
-    if (DelTrustedDevice(osAccountId, &queryDeviceParams) != HC_SUCCESS) {
-        result = HC_ERR_DEL_GROUP;
-    }
-    if (DelGroup(osAccountId, &queryGroupParams) != HC_SUCCESS) {
+    if (DelGroupCascade(osAccountId, groupId, delEntries) != HC_SUCCESS) {
         result = HC_ERR_DEL_GROUP;
     }
     if (SaveOsAccountDb(osAccountId) != HC_SUCCESS) {
@@ -918,6 +1114,11 @@ int32_t DelGroupFromDb(int32_t osAccountId, const char *groupId)
     return result;
 }
 
+int32_t DelGroupFromDb(int32_t osAccountId, const char *groupId)
+{
+    return DelGroupAndDevicesFromDb(osAccountId, groupId, NULL);
+}
+
 int32_t ConvertGroupIdToJsonStr(const char *groupId, char **returnJsonStr)
 {
     if ((groupId == NULL) || (returnJsonStr == NULL)) {
@@ -1070,19 +1271,22 @@ int32_t ProcessKeyPair(int action, const CJson *jsonParams, const char *groupId)
     return result;
 }
 
+static int32_t GetGroupTypeVisitor(const TrustedGroupEntry *entry, void *ctx)
+{
+    *(int32_t *)ctx = entry->type;
+    return HC_SUCCESS;
+}
+
 int32_t GetGroupTypeFromDb(int32_t osAccountId, const char *groupId, int32_t *returnGroupType)
 {
     if ((groupId == NULL) || (returnGroupType == NULL)) {
         LOGE("The input parameters contains NULL value!");
         return HC_ERR_INVALID_PARAMS;
     }
-    TrustedGroupEntry *groupEntry = GetGroupEntryById(osAccountId, groupId);
-    if (groupEntry == NULL) {
+    if (VisitGroupById(osAccountId, groupId, GetGroupTypeVisitor, returnGroupType) != HC_SUCCESS) {
         LOGE("Failed to get groupEntry from db!");
         return HC_ERR_DB;
     }
-    *returnGroupType = groupEntry->type;
-    DestroyGroupEntry(groupEntry);
     return HC_SUCCESS;
 }
 
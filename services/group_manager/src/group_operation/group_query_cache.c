@@ -0,0 +1,248 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "group_query_cache.h"
+
+#include "device_auth_defines.h"
+#include "hc_log.h"
+#include "hc_mutex.h"
+#include "hc_types.h"
+#include "json_utils.h"
+#include "json_writer.h"
+#include "securec.h"
+
+#define GROUP_QUERY_CACHE_SIZE 16
+#define FNV_OFFSET_BASIS 2166136261U
+#define FNV_PRIME 16777619U
+
+typedef struct {
+    bool isUsed;
+    uint32_t hash;
+    uint64_t generation;
+    uint64_t lastUsedTick;
+    int32_t osAccountId;
+    GroupQueryType type;
+    int32_t intArg;
+    char *appId;
+    char *strArg;
+    char *extStrArg;
+    char *resultStr;
+    uint32_t resultNum;
+} GroupQueryCacheEntry;
+
+static HcMutex *g_queryCacheMutex = NULL;
+static GroupQueryCacheEntry g_queryCache[GROUP_QUERY_CACHE_SIZE];
+static uint64_t g_queryCacheTick = 0;
+
+static uint32_t HashBytes(uint32_t hash, const void *data, uint32_t len)
+{
+    const uint8_t *p = (const uint8_t *)data;
+    for (uint32_t i = 0; i < len; i++) {
+        hash ^= p[i];
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+static uint32_t HashString(uint32_t hash, const char *str)
+{
+    if (str == NULL) {
+        return HashBytes(hash, "", sizeof(char));
+    }
+    /* Include the terminator so that adjacent strings can not be shifted into each other. */
+    return HashBytes(hash, str, HcStrlen(str) + sizeof(char));
+}
+
+static uint32_t HashQueryKey(const GroupQueryKey *key)
+{
+    uint32_t hash = FNV_OFFSET_BASIS;
+    hash = HashBytes(hash, &key->osAccountId, sizeof(key->osAccountId));
+    hash = HashBytes(hash, &key->type, sizeof(key->type));
+    hash = HashBytes(hash, &key->intArg, sizeof(key->intArg));
+    hash = HashString(hash, key->appId);
+    hash = HashString(hash, key->strArg);
+    return HashString(hash, key->extStrArg);
+}
+
+static bool IsStringEqual(const char *cached, const char *str)
+{
+    if ((cached == NULL) || (str == NULL)) {
+        return cached == str;
+    }
+    return strcmp(cached, str) == 0;
+}
+
+static bool IsKeyMatched(const GroupQueryCacheEntry *entry, uint32_t hash, const GroupQueryKey *key)
+{
+    return entry->isUsed && (entry->hash == hash) && (entry->osAccountId == key->osAccountId) &&
+        (entry->type == key->type) && (entry->intArg == key->intArg) && IsStringEqual(entry->appId, key->appId) &&
+        IsStringEqual(entry->strArg, key->strArg) && IsStringEqual(entry->extStrArg, key->extStrArg);
+}
+
+static void ClearCacheEntry(GroupQueryCacheEntry *entry)
+{
+    HcFree(entry->appId);
+    HcFree(entry->strArg);
+    HcFree(entry->extStrArg);
+    if (entry->resultStr != NULL) {
+        FreeJsonString(entry->resultStr);
+    }
+    (void)memset_s(entry, sizeof(GroupQueryCacheEntry), 0, sizeof(GroupQueryCacheEntry));
+}
+
+static char *CopyKeyString(const char *str, bool *isSuccess)
+{
+    if (str == NULL) {
+        return NULL;
+    }
+    uint32_t len = HcStrlen(str) + sizeof(char);
+    char *copy = (char *)HcMalloc(len, 0);
+    if ((copy == NULL) || (memcpy_s(copy, len, str, len) != EOK)) {
+        HcFree(copy);
+        *isSuccess = false;
+        return NULL;
+    }
+    return copy;
+}
+
+static GroupQueryCacheEntry *SelectVictimEntry(uint64_t generation)
+{
+    GroupQueryCacheEntry *victim = &g_queryCache[0];
+    for (uint32_t i = 0; i < GROUP_QUERY_CACHE_SIZE; i++) {
+        GroupQueryCacheEntry *entry = &g_queryCache[i];
+        if (!entry->isUsed || (entry->generation != generation)) {
+            return entry;
+        }
+        if (entry->lastUsedTick < victim->lastUsedTick) {
+            victim = entry;
+        }
+    }
+    return victim;
+}
+
+static GroupQueryCacheEntry *FindCacheEntry(const GroupQueryKey *key, uint32_t hash)
+{
+    for (uint32_t i = 0; i < GROUP_QUERY_CACHE_SIZE; i++) {
+        if (IsKeyMatched(&g_queryCache[i], hash, key)) {
+            return &g_queryCache[i];
+        }
+    }
+    return NULL;
+}
+
+bool GetCachedQueryResult(const GroupQueryKey *key, uint64_t generation, char **returnStr, uint32_t *returnNum)
+{
+    if ((key == NULL) || (returnNum == NULL) || (g_queryCacheMutex == NULL)) {
+        return false;
+    }
+    uint32_t hash = HashQueryKey(key);
+    g_queryCacheMutex->lock(g_queryCacheMutex);
+    GroupQueryCacheEntry *entry = FindCacheEntry(key, hash);
+    if (entry == NULL) {
+        g_queryCacheMutex->unlock(g_queryCacheMutex);
+        return false;
+    }
+    if (entry->generation != generation) {
+        ClearCacheEntry(entry);
+        g_queryCacheMutex->unlock(g_queryCacheMutex);
+        return false;
+    }
+    if (returnStr != NULL) {
+        if (entry->resultStr == NULL) {
+            g_queryCacheMutex->unlock(g_queryCacheMutex);
+            return false;
+        }
+        *returnStr = CopyJsonString(entry->resultStr);
+        if (*returnStr == NULL) {
+            g_queryCacheMutex->unlock(g_queryCacheMutex);
+            return false;
+        }
+    }
+    *returnNum = entry->resultNum;
+    entry->lastUsedTick = ++g_queryCacheTick;
+    g_queryCacheMutex->unlock(g_queryCacheMutex);
+    return true;
+}
+
+void CacheQueryResult(const GroupQueryKey *key, uint64_t generation, const char *resultStr, uint32_t resultNum)
+{
+    if ((key == NULL) || (g_queryCacheMutex == NULL)) {
+        return;
+    }
+    GroupQueryCacheEntry newEntry = { 0 };
+    bool isSuccess = true;
+    newEntry.isUsed = true;
+    newEntry.hash = HashQueryKey(key);
+    newEntry.generation = generation;
+    newEntry.osAccountId = key->osAccountId;
+    newEntry.type = key->type;
+    newEntry.intArg = key->intArg;
+    newEntry.appId = CopyKeyString(key->appId, &isSuccess);
+    newEntry.strArg = CopyKeyString(key->strArg, &isSuccess);
+    newEntry.extStrArg = CopyKeyString(key->extStrArg, &isSuccess);
+    newEntry.resultNum = resultNum;
+    if (resultStr != NULL) {
+        newEntry.resultStr = CopyJsonString(resultStr);
+        isSuccess = isSuccess && (newEntry.resultStr != NULL);
+    }
+    if (!isSuccess) {
+        LOGE("Failed to copy the query result to cache!");
+        ClearCacheEntry(&newEntry);
+        return;
+    }
+    g_queryCacheMutex->lock(g_queryCacheMutex);
+    GroupQueryCacheEntry *entry = FindCacheEntry(key, newEntry.hash);
+    if (entry == NULL) {
+        entry = SelectVictimEntry(generation);
+    }
+    ClearCacheEntry(entry);
+    newEntry.lastUsedTick = ++g_queryCacheTick;
+    *entry = newEntry;
+    g_queryCacheMutex->unlock(g_queryCacheMutex);
+}
+
+int32_t InitGroupQueryCache(void)
+{
+    if (g_queryCacheMutex == NULL) {
+        g_queryCacheMutex = (HcMutex *)HcMalloc(sizeof(HcMutex), 0);
+        if (g_queryCacheMutex == NULL) {
+            LOGE("Failed to allocate query cache mutex memory!");
+            return HC_ERR_ALLOC_MEMORY;
+        }
+        if (InitHcMutex(g_queryCacheMutex) != HC_SUCCESS) {
+            LOGE("Failed to init query cache mutex!");
+            HcFree(g_queryCacheMutex);
+            g_queryCacheMutex = NULL;
+            return HC_ERROR;
+        }
+    }
+    return HC_SUCCESS;
+}
+
+void DestroyGroupQueryCache(void)
+{
+    if (g_queryCacheMutex == NULL) {
+        return;
+    }
+    g_queryCacheMutex->lock(g_queryCacheMutex);
+    for (uint32_t i = 0; i < GROUP_QUERY_CACHE_SIZE; i++) {
+        ClearCacheEntry(&g_queryCache[i]);
+    }
+    g_queryCacheTick = 0;
+    g_queryCacheMutex->unlock(g_queryCacheMutex);
+    DestroyHcMutex(g_queryCacheMutex);
+    HcFree(g_queryCacheMutex);
+    g_queryCacheMutex = NULL;
+}
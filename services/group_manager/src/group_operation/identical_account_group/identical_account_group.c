@@ -128,18 +128,6 @@ static int32_t CheckCreateParams(int32_t osAccountId, const CJson *jsonParams)
     return HC_SUCCESS;
 }
 
-static int32_t DelDeviceById(int32_t osAccountId, const char *groupId, const char *deviceId, bool isUdid)
-{
-    QueryDeviceParams queryDeviceParams = InitQueryDeviceParams();
-    queryDeviceParams.groupId = groupId;
-    if (isUdid) {
-        queryDeviceParams.udid = deviceId;
-    } else {
-        queryDeviceParams.authId = deviceId;
-    }
-    return DelTrustedDevice(osAccountId, &queryDeviceParams);
-}
-
 static int32_t ImportSelfToken(int32_t osAccountId, CJson *jsonParams)
 {
     const char *userId = GetStringFromJson(jsonParams, FIELD_USER_ID);
@@ -184,29 +172,6 @@ static int32_t DelSelfToken(int32_t osAccountId, CJson *jsonParams)
     return ProcessAccountCredentials(osAccountId, DELETE_SELF_CREDENTIAL, credJson, NULL);
 }
 
-static int32_t GenerateAddTokenParams(const CJson *jsonParams, CJson *addParams)
-{
-    const char *userId = GetStringFromJson(jsonParams, FIELD_USER_ID);
-    if (userId == NULL) {
-        LOGE("Failed to get userId from json!");
-        return HC_ERR_JSON_GET;
-    }
-    const char *deviceId = GetStringFromJson(jsonParams, FIELD_DEVICE_ID);
-    if (deviceId == NULL) {
-        LOGE("Failed to get deviceId from json!");
-        return HC_ERR_JSON_GET;
-    }
-    if (AddStringToJson(addParams, FIELD_DEVICE_ID, deviceId) != HC_SUCCESS) {
-        LOGE("Failed to add deviceId to json!");
-        return HC_ERR_JSON_ADD;
-    }
-    if (AddStringToJson(addParams, FIELD_USER_ID, userId) != HC_SUCCESS) {
-        LOGE("Failed to add userId to json!");
-        return HC_ERR_JSON_ADD;
-    }
-    return HC_SUCCESS;
-}
-
 static int32_t GenerateDelTokenParams(const TrustedDeviceEntry *entry, CJson *delParams)
 {
     if (AddIntToJson(delParams, FIELD_CREDENTIAL_TYPE, (int32_t)entry->credential) != HC_SUCCESS) {
@@ -281,8 +246,7 @@ static void DelAllPeerTokens(int32_t osAccountId, const DeviceEntryVec *vec)
 static int32_t DelAcrossAccountGroupAndTokens(int32_t osAccountId, const char *groupId)
 {
     DeviceEntryVec deviceList = CreateDeviceEntryVec();
-    (void)GetTrustedDevices(osAccountId, groupId, &deviceList);
-    int32_t res = DelGroupFromDb(osAccountId, groupId);
+    int32_t res = DelGroupAndDevicesFromDb(osAccountId, groupId, &deviceList);
     DelAllPeerTokens(osAccountId, &deviceList);
     ClearDeviceEntryVec(&deviceList);
     return res;
@@ -328,8 +292,7 @@ static int32_t DelGroupAndTokens(int32_t osAccountId, const char *groupId)
         res = HC_ERR_DEL_GROUP;
     }
     DeviceEntryVec deviceList = CreateDeviceEntryVec();
-    (void)GetTrustedDevices(osAccountId, groupId, &deviceList);
-    if (DelGroupFromDb(osAccountId, groupId) != HC_SUCCESS) {
+    if (DelGroupAndDevicesFromDb(osAccountId, groupId, &deviceList) != HC_SUCCESS) {
         res = HC_ERR_DEL_GROUP;
     }
     DelAllTokens(osAccountId, &deviceList);
@@ -352,70 +315,6 @@ static int32_t GenerateTrustedDevParams(const CJson *jsonParams, const char *gro
     return HC_SUCCESS;
 }
 
-static int32_t AddDeviceAndToken(int32_t osAccountId, CJson *jsonParams, CJson *deviceInfo)
-{
-    const char *groupId = GetStringFromJson(jsonParams, FIELD_GROUP_ID);
-    if (groupId == NULL) {
-        LOGE("Failed to get groupId from json!");
-        return HC_ERR_JSON_GET;
-    }
-    CJson *credential = GetObjFromJson(deviceInfo, FIELD_CREDENTIAL);
-    if (credential == NULL) {
-        LOGE("Failed to get credential from json!");
-        return HC_ERR_JSON_GET;
-    }
-    int32_t res = GenerateAddTokenParams(deviceInfo, credential);
-    if (res != HC_SUCCESS) {
-        return res;
-    }
-    res = ProcessAccountCredentials(osAccountId, IMPORT_TRUSTED_CREDENTIALS, credential, NULL);
-    if (res != HC_SUCCESS) {
-        LOGE("Failed to import device token! res: %d", res);
-        return res;
-    }
-    res = AddDeviceToDatabaseByJson(osAccountId, GenerateTrustedDevParams, deviceInfo, groupId);
-    if (res != HC_SUCCESS) {
-        LOGE("Failed to add device to database! res: %d", res);
-    }
-    return res;
-}
-
-static int32_t DelPeerDeviceAndToken(int32_t osAccountId, CJson *jsonParams, CJson *deviceInfo)
-{
-    const char *groupId = GetStringFromJson(jsonParams, FIELD_GROUP_ID);
-    if (groupId == NULL) {
-        LOGE("Failed to get groupId from json!");
-        return HC_ERR_JSON_GET;
-    }
-    const char *deviceId = GetStringFromJson(deviceInfo, FIELD_DEVICE_ID);
-    if (deviceId == NULL) {
-        LOGE("Failed to get deviceId from json!");
-        return HC_ERR_JSON_GET;
-    }
-    TrustedDeviceEntry *entry = GetTrustedDeviceEntryById(osAccountId, deviceId, false, groupId);
-    if (entry == NULL) {
-        LOGE("Failed to get device from db!");
-        return HC_ERR_DEVICE_NOT_EXIST;
-    }
-    if (IsLocalDevice(StringGet(&entry->udid))) {
-        LOGE("Do not delete the local device!");
-        DestroyDeviceEntry(entry);
-        return HC_ERR_INVALID_PARAMS;
-    }
-    int32_t res = DelDeviceById(osAccountId, groupId, deviceId, false);
-    if (res != HC_SUCCESS) {
-        LOGE("Failed to delete device from database! res: %d", res);
-        DestroyDeviceEntry(entry);
-        return res;
-    }
-    res = DelDeviceToken(osAccountId, entry, false);
-    DestroyDeviceEntry(entry);
-    if (res != HC_SUCCESS) {
-        LOGE("Failed to delete token! res: %d", res);
-    }
-    return res;
-}
-
 static int32_t CheckChangeParams(int32_t osAccountId, const char *appId, CJson *jsonParams)
 {
     const char *groupId = GetStringFromJson(jsonParams, FIELD_GROUP_ID);
@@ -514,25 +413,19 @@ static int32_t AddMultiMembersToGroup(int32_t osAccountId, const char *appId, CJ
     if (res != HC_SUCCESS) {
         return res;
     }
+    const char *groupId = GetStringFromJson(jsonParams, FIELD_GROUP_ID);
     CJson *deviceList = GetObjFromJson(jsonParams, FIELD_DEVICE_LIST);
     if (deviceList == NULL) {
         LOGE("Failed to get deviceList from json!");
         return HC_ERR_JSON_GET;
     }
-    int32_t deviceNum = GetItemNum(deviceList);
-    int32_t addedCount = 0;
-    for (int32_t i = 0; i < deviceNum; i++) {
-        CJson *deviceInfo = GetItemFromArray(deviceList, i);
-        if (deviceInfo == NULL) {
-            LOGE("The deviceInfo is NULL!");
-            continue;
-        }
-        if (AddDeviceAndToken(osAccountId, jsonParams, deviceInfo) == HC_SUCCESS) {
-            addedCount++;
-        }
+    uint32_t addedCount = 0;
+    res = AddMembersToDatabaseByJson(osAccountId, GenerateTrustedDevParams, deviceList, groupId, &addedCount);
+    if (res != HC_SUCCESS) {
+        return res;
     }
-    LOGI("[End]: Add multiple members to a identical account group successfully! [ListNum]: %d, [AddedNum]: %d",
-        deviceNum, addedCount);
+    LOGI("[End]: Add multiple members to a identical account group successfully! [ListNum]: %d, [AddedNum]: %u",
+        GetItemNum(deviceList), addedCount);
     return HC_SUCCESS;
 }
 
@@ -547,25 +440,19 @@ static int32_t DelMultiMembersFromGroup(int32_t osAccountId, const char *appId,
     if (res != HC_SUCCESS) {
         return res;
     }
+    const char *groupId = GetStringFromJson(jsonParams, FIELD_GROUP_ID);
     CJson *deviceList = GetObjFromJson(jsonParams, FIELD_DEVICE_LIST);
     if (deviceList == NULL) {
         LOGE("Failed to get deviceList from json!");
         return HC_ERR_JSON_GET;
     }
-    int32_t deviceNum = GetItemNum(deviceList);
-    int32_t deletedCount = 0;
-    for (int32_t i = 0; i < deviceNum; i++) {
-        CJson *deviceInfo = GetItemFromArray(deviceList, i);
-        if (deviceInfo == NULL) {
-            LOGE("The deviceInfo is NULL!");
-            continue;
-        }
-        if (DelPeerDeviceAndToken(osAccountId, jsonParams, deviceInfo) == HC_SUCCESS) {
-            deletedCount++;
-        }
+    uint32_t deletedCount = 0;
+    res = DelMembersFromDatabaseByJson(osAccountId, deviceList, groupId, &deletedCount);
+    if (res != HC_SUCCESS) {
+        return res;
     }
-    LOGI("[End]: Delete multiple members from a identical account group successfully! [ListNum]: %d, [DeletedNum]: %d",
-        deviceNum, deletedCount);
+    LOGI("[End]: Delete multiple members from a identical account group successfully! [ListNum]: %d, [DeletedNum]: %u",
+        GetItemNum(deviceList), deletedCount);
     return HC_SUCCESS;
 }
 
@@ -281,8 +281,9 @@ static int32_t TryAddPeerUserTypeToParams(const CJson *jsonParams, BindSession *
     return HC_SUCCESS;
 }
 
-static int32_t AddGroupInfoToParams(const TrustedGroupEntry *entry, CJson *params)
+static int32_t AddGroupInfoToParams(const TrustedGroupEntry *entry, void *ctx)
 {
+    CJson *params = (CJson *)ctx;
     if (AddStringToJson(params, FIELD_GROUP_ID, StringGet(&entry->id)) != HC_SUCCESS) {
         LOGE("Failed to add groupId to json!");
         return HC_ERR_JSON_FAIL;
@@ -317,17 +318,14 @@ static int32_t AddDevInfoToParams(const TrustedDeviceEntry *devAuthParams, CJson
 
 static int32_t AddGroupInfoByDatabase(int32_t osAccountId, const char *groupId, CJson *params)
 {
-    TrustedGroupEntry *entry = GetGroupEntryById(osAccountId, groupId);
-    if (entry == NULL) {
+    QueryGroupParams queryParams = InitQueryGroupParams();
+    queryParams.groupId = groupId;
+    int32_t res = VisitGroup(osAccountId, &queryParams, AddGroupInfoToParams, params);
+    if (res == HC_ERR_GROUP_NOT_EXIST) {
         LOGE("Failed to get groupEntry from db!");
         return HC_ERR_DB;
     }
-    if (AddGroupInfoToParams(entry, params) != HC_SUCCESS) {
-        DestroyGroupEntry(entry);
-        return HC_ERR_JSON_FAIL;
-    }
-    DestroyGroupEntry(entry);
-    return HC_SUCCESS;
+    return res;
 }
 
 static int32_t AddDevInfoByDatabase(int32_t osAccountId, const char *groupId, CJson *params)
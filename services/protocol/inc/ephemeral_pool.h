@@ -0,0 +1,39 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef EPHEMERAL_POOL_H
+#define EPHEMERAL_POOL_H
+
+#include "string_util.h"
+
+#define EPHEMERAL_BLOCK_LEN 32
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int32_t InitEphemeralPool(void);
+void DestroyEphemeralPool(void);
+
+/*
+ * Fills out with random bytes which were drawn ahead of time by the pool thread, or draws them inline if the pool
+ * is empty. Every block is handed out once and wiped right after, the length can not exceed EPHEMERAL_BLOCK_LEN.
+ */
+int32_t TakeEphemeralRandom(Uint8Buff *out);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -17,6 +17,7 @@
 #define ISO_PROTOCOL_COMMON_H
 
 #include "alg_defs.h"
+#include "protocol_common.h"
 #include "string_util.h"
 
 #define GENERATE_SESSION_KEY_STR "hichain_iso_session_key"
@@ -32,6 +33,7 @@ typedef struct IsoBaseParamsT {
     Uint8Buff authIdPeer; // need malloc by caller
     Uint8Buff sessionKey;
     uint8_t psk[PSK_LEN];
+    ParamArena arena; /* backs randSelf, randPeer and sessionKey */
     const AlgLoader *loader;
 } IsoBaseParams;
 
@@ -17,6 +17,7 @@
 #define PAKE_DEFS_H
 
 #include "alg_defs.h"
+#include "protocol_common.h"
 #include "string_util.h"
 
 #define HICHAIN_SPEKE_BASE_INFO "hichain_speke_base_info"
@@ -33,6 +34,8 @@
 #define PAKE_DL_ESK_LEN 32
 #define PAKE_DL_PRIME_SMALL_LEN 256
 #define PAKE_DL_PRIME_LEN 384
+/* eskSelf, epkSelf and base of any ec or dl group fit in these, the P256 points included. */
+#define PAKE_ARENA_KEYS_SIZE (PAKE_DL_ESK_LEN + PAKE_DL_PRIME_LEN + PAKE_DL_PRIME_LEN)
 
 typedef enum {
     PAKE_ALG_NONE = 0x0000,
@@ -69,6 +72,7 @@ typedef struct PakeBaseParamsT {
     PakeAlgType supportedPakeAlg;
     bool isClient;
 
+    ParamArena arena; /* backs the fixed-size buffers, the ids, psk, epkPeer and the challenges excepted */
     const AlgLoader *loader;
 } PakeBaseParams;
 
@@ -26,7 +26,30 @@ typedef enum {
     STS,
 } ProtocolType;
 
+/*
+ * One zeroed block that backs the fixed-size buffers of a handshake. The buffers handed out by the arena must not
+ * be freed one by one, CleanArenaParam wipes one of them early and DestroyParamArena wipes and frees the block.
+ */
+typedef struct {
+    uint8_t *data;
+    uint32_t capacity;
+    uint32_t usedLen;
+} ParamArena;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 void FreeAndCleanKey(Uint8Buff *key);
 int32_t InitSingleParam(Uint8Buff *param, uint32_t len);
 
+int32_t InitParamArena(ParamArena *arena, uint32_t capacity);
+int32_t InitArenaParam(ParamArena *arena, Uint8Buff *param, uint32_t len);
+void CleanArenaParam(Uint8Buff *param);
+void DestroyParamArena(ParamArena *arena);
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif
@@ -0,0 +1,180 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ephemeral_pool.h"
+#include "alg_loader.h"
+#include "device_auth_defines.h"
+#include "hc_log.h"
+#include "hc_mutex.h"
+#include "hc_task_thread.h"
+#include "hc_types.h"
+
+#define EPHEMERAL_POOL_SIZE 16
+#define EPHEMERAL_POOL_LOW_WATER 4
+
+#ifndef EPHEMERAL_POOL_THREAD_STACK_SIZE
+#define EPHEMERAL_POOL_THREAD_STACK_SIZE 8192
+#endif
+
+/* blocks [0, g_readyCount) hold unused random bytes, all the others are zero. */
+static uint8_t g_blocks[EPHEMERAL_POOL_SIZE][EPHEMERAL_BLOCK_LEN];
+static uint32_t g_readyCount = 0;
+static bool g_isRefilling = false;
+static HcMutex *g_poolMutex = NULL;
+static HcTaskThread *g_poolThread = NULL;
+
+static void DoRefillTask(HcTaskBase *task)
+{
+    (void)task;
+    g_poolMutex->lock(g_poolMutex);
+    uint32_t missingCount = EPHEMERAL_POOL_SIZE - g_readyCount;
+    g_poolMutex->unlock(g_poolMutex);
+
+    /* Only this thread adds blocks, so at least missingCount slots are still free after the draw. */
+    uint8_t batch[EPHEMERAL_POOL_SIZE * EPHEMERAL_BLOCK_LEN] = { 0 };
+    Uint8Buff batchBuff = { batch, missingCount * EPHEMERAL_BLOCK_LEN };
+    int32_t res = (missingCount == 0) ? HC_SUCCESS : GetLoaderInstance()->generateRandom(&batchBuff);
+
+    g_poolMutex->lock(g_poolMutex);
+    if (res == HC_SUCCESS) {
+        for (uint32_t i = 0; (i < missingCount) && (g_readyCount < EPHEMERAL_POOL_SIZE); i++) {
+            (void)memcpy_s(g_blocks[g_readyCount], EPHEMERAL_BLOCK_LEN, batch + i * EPHEMERAL_BLOCK_LEN,
+                EPHEMERAL_BLOCK_LEN);
+            g_readyCount++;
+        }
+    } else {
+        LOGE("Failed to refill ephemeral pool, res: %d", res);
+    }
+    g_isRefilling = false;
+    g_poolMutex->unlock(g_poolMutex);
+    (void)memset_s(batch, sizeof(batch), 0, sizeof(batch));
+}
+
+/* Must be called with the pool locked, the task is pushed after unlocking. */
+static HcTaskBase *CreateRefillTaskIfNeeded(void)
+{
+    if ((g_poolThread == NULL) || g_isRefilling || (g_readyCount > EPHEMERAL_POOL_LOW_WATER)) {
+        return NULL;
+    }
+    HcTaskBase *task = (HcTaskBase *)HcMalloc(sizeof(HcTaskBase), 0);
+    if (task == NULL) {
+        return NULL;
+    }
+    task->doAction = DoRefillTask;
+    task->destroy = NULL;
+    g_isRefilling = true;
+    return task;
+}
+
+int32_t TakeEphemeralRandom(Uint8Buff *out)
+{
+    if ((out == NULL) || (out->val == NULL) || (out->length == 0) || (out->length > EPHEMERAL_BLOCK_LEN)) {
+        LOGE("Invalid ephemeral random buffer.");
+        return HC_ERR_INVALID_PARAMS;
+    }
+    if (g_poolMutex == NULL) {
+        return GetLoaderInstance()->generateRandom(out);
+    }
+    g_poolMutex->lock(g_poolMutex);
+    bool isTaken = false;
+    if (g_readyCount > 0) {
+        g_readyCount--;
+        isTaken = (memcpy_s(out->val, out->length, g_blocks[g_readyCount], out->length) == EOK);
+        (void)memset_s(g_blocks[g_readyCount], EPHEMERAL_BLOCK_LEN, 0, EPHEMERAL_BLOCK_LEN);
+    }
+    HcTaskBase *refillTask = CreateRefillTaskIfNeeded();
+    HcTaskThread *poolThread = g_poolThread;
+    g_poolMutex->unlock(g_poolMutex);
+    if (refillTask != NULL) {
+        poolThread->pushTask(poolThread, refillTask);
+    }
+    return isTaken ? HC_SUCCESS : GetLoaderInstance()->generateRandom(out);
+}
+
+static int32_t StartPoolThread(void)
+{
+    g_poolThread = (HcTaskThread *)HcMalloc(sizeof(HcTaskThread), 0);
+    if (g_poolThread == NULL) {
+        return HC_ERR_ALLOC_MEMORY;
+    }
+    if (InitHcTaskThread(g_poolThread, EPHEMERAL_POOL_THREAD_STACK_SIZE, "EphemeralPool") != HC_SUCCESS) {
+        HcFree(g_poolThread);
+        g_poolThread = NULL;
+        return HC_ERR_INIT_FAILED;
+    }
+    if (g_poolThread->startThread(g_poolThread) != HC_SUCCESS) {
+        DestroyHcTaskThread(g_poolThread);
+        HcFree(g_poolThread);
+        g_poolThread = NULL;
+        return HC_ERR_INIT_FAILED;
+    }
+    return HC_SUCCESS;
+}
+
+int32_t InitEphemeralPool(void)
+{
+    if (g_poolMutex != NULL) {
+        return HC_SUCCESS;
+    }
+    g_poolMutex = (HcMutex *)HcMalloc(sizeof(HcMutex), 0);
+    if (g_poolMutex == NULL) {
+        LOGE("Failed to allocate ephemeral pool mutex memory!");
+        return HC_ERR_ALLOC_MEMORY;
+    }
+    if (InitHcMutex(g_poolMutex) != HC_SUCCESS) {
+        LOGE("Failed to init ephemeral pool mutex!");
+        HcFree(g_poolMutex);
+        g_poolMutex = NULL;
+        return HC_ERROR;
+    }
+    int32_t res = StartPoolThread();
+    if (res != HC_SUCCESS) {
+        /* The pool is only an accelerator, handshakes draw their randoms inline without it. */
+        LOGW("Failed to start ephemeral pool thread, res: %d", res);
+        return HC_SUCCESS;
+    }
+    /* Fill the pool while the service is idle. */
+    g_poolMutex->lock(g_poolMutex);
+    HcTaskBase *refillTask = CreateRefillTaskIfNeeded();
+    g_poolMutex->unlock(g_poolMutex);
+    if (refillTask != NULL) {
+        g_poolThread->pushTask(g_poolThread, refillTask);
+    }
+    return HC_SUCCESS;
+}
+
+void DestroyEphemeralPool(void)
+{
+    if (g_poolMutex == NULL) {
+        return;
+    }
+    g_poolMutex->lock(g_poolMutex);
+    HcTaskThread *poolThread = g_poolThread;
+    g_poolThread = NULL;
+    g_poolMutex->unlock(g_poolMutex);
+    if (poolThread != NULL) {
+        poolThread->stopAndClear(poolThread);
+        DestroyHcTaskThread(poolThread);
+        HcFree(poolThread);
+    }
+    g_poolMutex->lock(g_poolMutex);
+    (void)memset_s(g_blocks, sizeof(g_blocks), 0, sizeof(g_blocks));
+    g_readyCount = 0;
+    g_isRefilling = false;
+    g_poolMutex->unlock(g_poolMutex);
+    DestroyHcMutex(g_poolMutex);
+    HcFree(g_poolMutex);
+    g_poolMutex = NULL;
+}
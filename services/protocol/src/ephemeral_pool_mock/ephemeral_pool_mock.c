@@ -0,0 +1,36 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ephemeral_pool.h"
+#include "alg_loader.h"
+#include "device_auth_defines.h"
+
+int32_t InitEphemeralPool(void)
+{
+    return HC_SUCCESS;
+}
+
+void DestroyEphemeralPool(void)
+{
+    return;
+}
+
+int32_t TakeEphemeralRandom(Uint8Buff *out)
+{
+    if ((out == NULL) || (out->val == NULL) || (out->length == 0) || (out->length > EPHEMERAL_BLOCK_LEN)) {
+        return HC_ERR_INVALID_PARAMS;
+    }
+    return GetLoaderInstance()->generateRandom(out);
+}
@@ -16,10 +16,13 @@
 #include "iso_protocol_common.h"
 #include "alg_loader.h"
 #include "device_auth_defines.h"
+#include "ephemeral_pool.h"
 #include "hc_log.h"
 #include "hc_types.h"
 #include "protocol_common.h"
 
+#define ISO_ARENA_SIZE (RAND_BYTE_LEN + RAND_BYTE_LEN + ISO_SESSION_KEY_LEN)
+
 int32_t InitIsoBaseParams(IsoBaseParams *params)
 {
     if (params == NULL) {
@@ -28,25 +31,11 @@ int32_t InitIsoBaseParams(IsoBaseParams *params)
     }
 
     int32_t res;
-    params->randSelf.length = RAND_BYTE_LEN;
-    params->randSelf.val = (uint8_t *)HcMalloc(params->randSelf.length, 0);
-    if (params->randSelf.val == NULL) {
-        LOGE("Malloc randSelf failed.");
-        res = HC_ERR_ALLOC_MEMORY;
-        goto CLEAN_UP;
-    }
-    params->randPeer.length = RAND_BYTE_LEN;
-    params->randPeer.val = (uint8_t *)HcMalloc(params->randPeer.length, 0);
-    if (params->randPeer.val == NULL) {
-        LOGE("Malloc randPeer failed.");
-        res = HC_ERR_ALLOC_MEMORY;
-        goto CLEAN_UP;
-    }
-
-    params->sessionKey.length = ISO_SESSION_KEY_LEN;
-    params->sessionKey.val = (uint8_t *)HcMalloc(params->sessionKey.length, 0);
-    if (params->sessionKey.val == NULL) {
-        LOGE("Malloc sessionKey failed.");
+    if ((InitParamArena(&params->arena, ISO_ARENA_SIZE) != HC_SUCCESS) ||
+        (InitArenaParam(&params->arena, &params->randSelf, RAND_BYTE_LEN) != HC_SUCCESS) ||
+        (InitArenaParam(&params->arena, &params->randPeer, RAND_BYTE_LEN) != HC_SUCCESS) ||
+        (InitArenaParam(&params->arena, &params->sessionKey, ISO_SESSION_KEY_LEN) != HC_SUCCESS)) {
+        LOGE("Alloc randSelf, randPeer and sessionKey failed.");
         res = HC_ERR_ALLOC_MEMORY;
         goto CLEAN_UP;
     }
@@ -69,13 +58,11 @@ void DestroyIsoBaseParams(IsoBaseParams *params)
         return;
     }
 
-    FreeAndCleanKey(&params->sessionKey);
+    CleanArenaParam(&params->sessionKey);
     (void)memset_s(params->psk, sizeof(params->psk), 0, PSK_LEN);
 
-    HcFree(params->randSelf.val);
+    DestroyParamArena(&params->arena);
     params->randSelf.val = NULL;
-
-    HcFree(params->randPeer.val);
     params->randPeer.val = NULL;
 
     HcFree(params->authIdSelf.val);
@@ -90,7 +77,7 @@ static int IsoCalSelfToken(const IsoBaseParams *params, Uint8Buff *outHmac)
     int res;
     int length = params->randSelf.length + params->randPeer.length + params->authIdSelf.length +
         params->authIdPeer.length;
-    uint8_t *messagePeer = (uint8_t *)HcMalloc(length, 0);
+    uint8_t *messagePeer = (uint8_t *)HcMallocNoZero(length);
     if (messagePeer == NULL) {
         LOGE("Malloc for messagePeer failed.");
         return HC_ERR_ALLOC_MEMORY;
@@ -135,7 +122,7 @@ static int IsoCalPeerToken(const IsoBaseParams *params, Uint8Buff *selfToken)
 {
     int length = params->randSelf.length + params->randPeer.length + params->authIdPeer.length +
         params->authIdSelf.length;
-    uint8_t *messageSelf = (uint8_t *)HcMalloc(length, 0);
+    uint8_t *messageSelf = (uint8_t *)HcMallocNoZero(length);
     if (messageSelf == NULL) {
         LOGE("Malloc for messageSelf failed.");
         return HC_ERR_ALLOC_MEMORY;
@@ -223,7 +210,7 @@ static int IsoGenSessionKey(IsoBaseParams *params, Uint8Buff *pskBuf, bool isCli
     res = params->loader->computeHkdf(pskBuf, &hkdfSaltBuf, &keyInfoBuf, &params->sessionKey, false);
     if (res != HC_SUCCESS) {
         LOGE("ComputeHkdf for sessionKey failed, res: %x.", res);
-        FreeAndCleanKey(&params->sessionKey);
+        CleanArenaParam(&params->sessionKey);
     }
     HcFree(hkdfSalt);
     return res;
@@ -235,7 +222,7 @@ int IsoClientGenRandom(IsoBaseParams *params)
         LOGE("Params is null.");
         return HC_ERR_NULL_PTR;
     }
-    int32_t res = params->loader->generateRandom(&params->randSelf);
+    int32_t res = TakeEphemeralRandom(&params->randSelf);
     if (res != HC_SUCCESS) {
         LOGE("Generate randSelf failed, res: %x.", res);
         (void)memset_s(params->psk, sizeof(params->psk), 0, PSK_LEN);
@@ -324,7 +311,7 @@ int IsoServerGenRandomAndToken(IsoBaseParams *params, Uint8Buff *selfTokenBuf)
         (void)memset_s(params->psk, sizeof(params->psk), 0, PSK_LEN);
         return HC_ERR_NULL_PTR;
     }
-    int res = params->loader->generateRandom(&params->randSelf);
+    int res = TakeEphemeralRandom(&params->randSelf);
     if (res != HC_SUCCESS) {
         LOGE("Generate randSelf failed, res: %x.", res);
         (void)memset_s(params->psk, sizeof(params->psk), 0, PSK_LEN);
@@ -378,7 +365,7 @@ int IsoServerGenSessionKeyAndCalToken(IsoBaseParams *params, const Uint8Buff *to
     if (res != HC_SUCCESS) {
         LOGE("Compute hmac for returnCode failed, res: %x.", res);
         (void)memset_s(params->psk, sizeof(params->psk), 0, PSK_LEN);
-        FreeAndCleanKey(&params->sessionKey);
+        CleanArenaParam(&params->sessionKey);
     }
     return res;
 }
\ No newline at end of file
@@ -23,9 +23,9 @@ void CleanPakeSensitiveKeys(PakeBaseParams *params)
         return;
     }
     FreeAndCleanKey(&params->psk);
-    FreeAndCleanKey(&params->base);
-    FreeAndCleanKey(&params->eskSelf);
-    FreeAndCleanKey(&params->sharedSecret);
-    FreeAndCleanKey(&params->sessionKey);
-    FreeAndCleanKey(&params->hmacKey);
+    CleanArenaParam(&params->base);
+    CleanArenaParam(&params->eskSelf);
+    CleanArenaParam(&params->sharedSecret);
+    CleanArenaParam(&params->sessionKey);
+    CleanArenaParam(&params->hmacKey);
 }
\ No newline at end of file
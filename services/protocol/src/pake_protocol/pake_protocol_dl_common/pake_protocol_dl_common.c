@@ -15,6 +15,7 @@
 
 #include "pake_protocol_dl_common.h"
 #include "device_auth_defines.h"
+#include "ephemeral_pool.h"
 #include "hc_log.h"
 #include "hc_types.h"
 #include "pake_defs.h"
@@ -51,7 +52,7 @@ uint32_t GetPakeDlAlg(void)
 
 static int32_t GenerateEsk(PakeBaseParams *params)
 {
-    int res = params->loader->generateRandom(&(params->eskSelf));
+    int res = TakeEphemeralRandom(&(params->eskSelf));
     if (res != HC_SUCCESS) {
         LOGE("GenerateRandom for eskSelf failed, res: %x.", res);
     }
@@ -104,19 +105,19 @@ static int32_t InitDlPakeParams(PakeBaseParams *params)
         LOGE("FillDlKeysLen failed, res: %x.", res);
         return res;
     }
-    res = InitSingleParam(&(params->eskSelf), params->eskSelf.length);
-    if (res !=  HC_SUCCESS) {
-        LOGE("InitSingleParam for eskSelf failed, res: %x.", res);
+    res = InitArenaParam(&params->arena, &(params->eskSelf), params->eskSelf.length);
+    if (res != HC_SUCCESS) {
+        LOGE("InitArenaParam for eskSelf failed, res: %x.", res);
         return res;
     }
-    res = InitSingleParam(&(params->epkSelf), params->innerKeyLen);
-    if (res !=  HC_SUCCESS) {
-        LOGE("InitSingleParam for epkSelf failed, res: %x.", res);
+    res = InitArenaParam(&params->arena, &(params->epkSelf), params->innerKeyLen);
+    if (res != HC_SUCCESS) {
+        LOGE("InitArenaParam for epkSelf failed, res: %x.", res);
         return res;
     }
-    res = InitSingleParam(&(params->base), params->innerKeyLen);
-    if (res !=  HC_SUCCESS) {
-        LOGE("InitSingleParam for base failed, res: %x.", res);
+    res = InitArenaParam(&params->arena, &(params->base), params->innerKeyLen);
+    if (res != HC_SUCCESS) {
+        LOGE("InitArenaParam for base failed, res: %x.", res);
         return res;
     }
     return res;
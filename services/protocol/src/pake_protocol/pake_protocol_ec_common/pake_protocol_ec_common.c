@@ -15,6 +15,7 @@
 
 #include "pake_protocol_ec_common.h"
 #include "device_auth_defines.h"
+#include "ephemeral_pool.h"
 #include "hc_log.h"
 #include "hc_types.h"
 #include "pake_defs.h"
@@ -33,9 +34,9 @@ static int32_t GenerateEsk(PakeBaseParams *params)
 {
     int32_t res;
     if (params->curveType == CURVE_256) {
-        return params->loader->generateRandom(&(params->eskSelf));
+        return TakeEphemeralRandom(&(params->eskSelf));
     } else if (params->curveType == CURVE_25519) {
-        res = params->loader->generateRandom(&(params->eskSelf));
+        res = TakeEphemeralRandom(&(params->eskSelf));
         if (res != HC_SUCCESS) {
             LOGE("CURVE_25519: GenerateRandom for eskSelf failed, res: %x.", res);
             return res;
@@ -56,19 +57,19 @@ static int32_t InitEcPakeParams(PakeBaseParams *params)
     params->innerKeyLen = PAKE_EC_KEY_LEN;
     /* P256 requires buffer for both X and Y coordinates. */
     uint32_t keyBufferLen = (params->curveType == CURVE_256) ? (params->innerKeyLen * 2) : (params->innerKeyLen);
-    int32_t res = InitSingleParam(&(params->eskSelf), params->eskSelf.length);
-    if (res !=  HC_SUCCESS) {
-        LOGE("InitSingleParam for eskSelf failed, res: %x.", res);
+    int32_t res = InitArenaParam(&params->arena, &(params->eskSelf), params->eskSelf.length);
+    if (res != HC_SUCCESS) {
+        LOGE("InitArenaParam for eskSelf failed, res: %x.", res);
         return res;
     }
-    res = InitSingleParam(&(params->epkSelf), keyBufferLen);
-    if (res !=  HC_SUCCESS) {
-        LOGE("InitSingleParam for epkSelf failed, res: %x.", res);
+    res = InitArenaParam(&params->arena, &(params->epkSelf), keyBufferLen);
+    if (res != HC_SUCCESS) {
+        LOGE("InitArenaParam for epkSelf failed, res: %x.", res);
         return res;
     }
-    res = InitSingleParam(&(params->base), keyBufferLen);
-    if (res !=  HC_SUCCESS) {
-        LOGE("InitSingleParam for base failed, res: %x.", res);
+    res = InitArenaParam(&params->arena, &(params->base), keyBufferLen);
+    if (res != HC_SUCCESS) {
+        LOGE("InitArenaParam for base failed, res: %x.", res);
         return res;
     }
     return res;
@@ -25,6 +25,9 @@
 #include "string_util.h"
 
 #define PAKE_SESSION_KEY_LEN 16
+/* The challenges stay out of the arena, the standard exchange may put its own in their place. */
+#define PAKE_V1_ARENA_SIZE (PAKE_SALT_LEN + PAKE_SESSION_KEY_LEN + PAKE_HMAC_KEY_LEN + HMAC_LEN + HMAC_LEN + \
+    PAKE_DL_PRIME_LEN + PAKE_ARENA_KEYS_SIZE)
 
 void DestroyPakeV1BaseParams(PakeBaseParams *params)
 {
@@ -34,8 +37,11 @@ void DestroyPakeV1BaseParams(PakeBaseParams *params)
 
     CleanPakeSensitiveKeys(params);
 
-    HcFree(params->salt.val);
+    DestroyParamArena(&params->arena);
     params->salt.val = NULL;
+    params->epkSelf.val = NULL;
+    params->kcfData.val = NULL;
+    params->kcfDataPeer.val = NULL;
 
     HcFree(params->challengeSelf.val);
     params->challengeSelf.val = NULL;
@@ -43,18 +49,9 @@ void DestroyPakeV1BaseParams(PakeBaseParams *params)
     HcFree(params->challengePeer.val);
     params->challengePeer.val = NULL;
 
-    HcFree(params->epkSelf.val);
-    params->epkSelf.val = NULL;
-
     HcFree(params->epkPeer.val);
     params->epkPeer.val = NULL;
 
-    HcFree(params->kcfData.val);
-    params->kcfData.val = NULL;
-
-    HcFree(params->kcfDataPeer.val);
-    params->kcfDataPeer.val = NULL;
-
     HcFree(params->idSelf.val);
     params->idSelf.val = NULL;
 
@@ -64,10 +61,16 @@ void DestroyPakeV1BaseParams(PakeBaseParams *params)
 
 static int32_t AllocDefaultParams(PakeBaseParams *params)
 {
-    params->salt.length = PAKE_SALT_LEN;
-    params->salt.val = (uint8_t *)HcMalloc(params->salt.length, 0);
-    if (params->salt.val == NULL) {
-        LOGE("Malloc for salt failed.");
+    if (InitParamArena(&params->arena, PAKE_V1_ARENA_SIZE) != HC_SUCCESS) {
+        LOGE("Malloc for param arena failed.");
+        return HC_ERR_ALLOC_MEMORY;
+    }
+    if ((InitArenaParam(&params->arena, &params->salt, PAKE_SALT_LEN) != HC_SUCCESS) ||
+        (InitArenaParam(&params->arena, &params->sessionKey, PAKE_SESSION_KEY_LEN) != HC_SUCCESS) ||
+        (InitArenaParam(&params->arena, &params->hmacKey, PAKE_HMAC_KEY_LEN) != HC_SUCCESS) ||
+        (InitArenaParam(&params->arena, &params->kcfData, HMAC_LEN) != HC_SUCCESS) ||
+        (InitArenaParam(&params->arena, &params->kcfDataPeer, HMAC_LEN) != HC_SUCCESS)) {
+        LOGE("Alloc default params from arena failed.");
         return HC_ERR_ALLOC_MEMORY;
     }
 
@@ -84,34 +87,6 @@ static int32_t AllocDefaultParams(PakeBaseParams *params)
         LOGE("Malloc for challengePeer failed.");
         return HC_ERR_ALLOC_MEMORY;
     }
-
-    params->sessionKey.length = PAKE_SESSION_KEY_LEN;
-    params->sessionKey.val = (uint8_t *)HcMalloc(params->sessionKey.length, 0);
-    if (params->sessionKey.val == NULL) {
-        LOGE("Malloc for sessionKey failed.");
-        return HC_ERR_ALLOC_MEMORY;
-    }
-
-    params->hmacKey.length = PAKE_HMAC_KEY_LEN;
-    params->hmacKey.val = (uint8_t *)HcMalloc(params->hmacKey.length, 0);
-    if (params->hmacKey.val == NULL) {
-        LOGE("Malloc for hmacKey failed.");
-        return HC_ERR_ALLOC_MEMORY;
-    }
-
-    params->kcfData.length = HMAC_LEN;
-    params->kcfData.val = (uint8_t *)HcMalloc(params->kcfData.length, 0);
-    if (params->kcfData.val == NULL) {
-        LOGE("Malloc for kcfData failed.");
-        return HC_ERR_ALLOC_MEMORY;
-    }
-
-    params->kcfDataPeer.length = HMAC_LEN;
-    params->kcfDataPeer.val = (uint8_t *)HcMalloc(params->kcfDataPeer.length, 0);
-    if (params->kcfDataPeer.val == NULL) {
-        LOGE("Malloc for kcfDataPeer failed.");
-        return HC_ERR_ALLOC_MEMORY;
-    }
     return HC_SUCCESS;
 }
 
@@ -205,7 +180,7 @@ static int32_t GeneratePakeParams(PakeBaseParams *params)
         LOGE("GeneratePakeParams failed, pakeAlgType: 0x%x, res: %x.", params->supportedPakeAlg, res);
         goto CLEAN_UP;
     }
-    FreeAndCleanKey(&params->base);
+    CleanArenaParam(&params->base);
     (void)memset_s(secret.val, secret.length, 0, secret.length);
     return res;
 CLEAN_UP:
@@ -232,7 +207,7 @@ static int32_t DeriveKeyFromSharedSecret(PakeBaseParams *params)
         LOGE("ComputeHkdf for unionKey failed, res: %x.", res);
         goto CLEAN_UP;
     }
-    FreeAndCleanKey(&params->sharedSecret);
+    CleanArenaParam(&params->sharedSecret);
     if (memcpy_s(params->sessionKey.val, params->sessionKey.length, unionKey.val, params->sessionKey.length) != EOK) {
         LOGE("Memcpy for sessionKey failed.");
         res = HC_ERR_ALLOC_MEMORY;
@@ -251,9 +226,9 @@ CLEAN_UP:
 
 static int32_t GenerateSessionKey(PakeBaseParams *params)
 {
-    int32_t res = InitSingleParam(&params->sharedSecret, params->innerKeyLen);
+    int32_t res = InitArenaParam(&params->arena, &params->sharedSecret, params->innerKeyLen);
     if (res != HC_SUCCESS) {
-        LOGE("InitSingleParam for sharedSecret failed, res: %x.", res);
+        LOGE("InitArenaParam for sharedSecret failed, res: %x.", res);
         goto CLEAN_UP;
     }
 
@@ -268,7 +243,7 @@ static int32_t GenerateSessionKey(PakeBaseParams *params)
         LOGE("AgreeDlSharedSecret failed, pakeAlgType: 0x%x, res: %x.", params->supportedPakeAlg, res);
         goto CLEAN_UP;
     }
-    FreeAndCleanKey(&params->eskSelf);
+    CleanArenaParam(&params->eskSelf);
 
     res = DeriveKeyFromSharedSecret(params);
     if (res != HC_SUCCESS) {
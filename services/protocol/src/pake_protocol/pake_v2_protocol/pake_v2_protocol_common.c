@@ -26,6 +26,8 @@
 
 #define KCF_CODE_LEN 1
 #define PAKE_SESSION_KEY_LEN 32
+#define PAKE_V2_ARENA_SIZE (PAKE_SALT_LEN + HMAC_LEN + HMAC_LEN + SHA256_LEN + PAKE_SESSION_KEY_LEN + \
+    PAKE_ARENA_KEYS_SIZE)
 
 static const uint8_t g_kcfCodeClient[KCF_CODE_LEN] = { 0x04 };
 static const uint8_t g_kcfCodeServer[KCF_CODE_LEN] = { 0x03 };
@@ -38,8 +40,11 @@ void DestroyPakeV2BaseParams(PakeBaseParams *params)
 
     CleanPakeSensitiveKeys(params);
 
-    HcFree(params->salt.val);
+    DestroyParamArena(&params->arena);
     params->salt.val = NULL;
+    params->epkSelf.val = NULL;
+    params->kcfData.val = NULL;
+    params->kcfDataPeer.val = NULL;
 
     HcFree(params->challengeSelf.val);
     params->challengeSelf.val = NULL;
@@ -47,9 +52,6 @@ void DestroyPakeV2BaseParams(PakeBaseParams *params)
     HcFree(params->challengePeer.val);
     params->challengePeer.val = NULL;
 
-    HcFree(params->epkSelf.val);
-    params->epkSelf.val = NULL;
-
     HcFree(params->epkPeer.val);
     params->epkPeer.val = NULL;
 
@@ -58,48 +60,20 @@ void DestroyPakeV2BaseParams(PakeBaseParams *params)
 
     HcFree(params->idPeer.val);
     params->idPeer.val = NULL;
-
-    HcFree(params->kcfData.val);
-    params->kcfData.val = NULL;
-
-    HcFree(params->kcfDataPeer.val);
-    params->kcfDataPeer.val = NULL;
 }
 
 static int32_t AllocDefaultParams(PakeBaseParams *params)
 {
-    params->salt.length = PAKE_SALT_LEN;
-    params->salt.val = (uint8_t *)HcMalloc(params->salt.length, 0);
-    if (params->salt.val == NULL) {
-        LOGE("Malloc for salt failed.");
+    if (InitParamArena(&params->arena, PAKE_V2_ARENA_SIZE) != HC_SUCCESS) {
+        LOGE("Malloc for param arena failed.");
         return HC_ERR_ALLOC_MEMORY;
     }
-
-    params->sharedSecret.length = SHA256_LEN;
-    params->sharedSecret.val = (uint8_t *)HcMalloc(params->sharedSecret.length, 0);
-    if (params->sharedSecret.val == NULL) {
-        LOGE("Malloc for sharedSecret failed.");
-        return HC_ERR_ALLOC_MEMORY;
-    }
-
-    params->sessionKey.length = PAKE_SESSION_KEY_LEN;
-    params->sessionKey.val = (uint8_t *)HcMalloc(params->sessionKey.length, 0);
-    if (params->sessionKey.val == NULL) {
-        LOGE("Malloc for sessionKey failed.");
-        return HC_ERR_ALLOC_MEMORY;
-    }
-
-    params->kcfData.length = HMAC_LEN;
-    params->kcfData.val = (uint8_t *)HcMalloc(params->kcfData.length, 0);
-    if (params->kcfData.val == NULL) {
-        LOGE("Malloc for kcfData failed.");
-        return HC_ERR_ALLOC_MEMORY;
-    }
-
-    params->kcfDataPeer.length = HMAC_LEN;
-    params->kcfDataPeer.val = (uint8_t *)HcMalloc(params->kcfDataPeer.length, 0);
-    if (params->kcfDataPeer.val == NULL) {
-        LOGE("Malloc for kcfDataPeer failed.");
+    if ((InitArenaParam(&params->arena, &params->salt, PAKE_SALT_LEN) != HC_SUCCESS) ||
+        (InitArenaParam(&params->arena, &params->kcfData, HMAC_LEN) != HC_SUCCESS) ||
+        (InitArenaParam(&params->arena, &params->kcfDataPeer, HMAC_LEN) != HC_SUCCESS) ||
+        (InitArenaParam(&params->arena, &params->sharedSecret, SHA256_LEN) != HC_SUCCESS) ||
+        (InitArenaParam(&params->arena, &params->sessionKey, PAKE_SESSION_KEY_LEN) != HC_SUCCESS)) {
+        LOGE("Alloc default params from arena failed.");
         return HC_ERR_ALLOC_MEMORY;
     }
     return HC_SUCCESS;
@@ -205,7 +179,7 @@ static int32_t ComputeSidSelf(const PakeBaseParams *params, Uint8Buff *sidSelf)
 {
     int res;
     Uint8Buff idSelfMsg = { NULL, params->idSelf.length + params->innerKeyLen };
-    idSelfMsg.val = (uint8_t *)HcMalloc(idSelfMsg.length, 0);
+    idSelfMsg.val = (uint8_t *)HcMallocNoZero(idSelfMsg.length);
     if (idSelfMsg.val == NULL) {
         LOGE("Malloc for idSelfMsg failed.");
         res = HC_ERR_ALLOC_MEMORY;
@@ -237,7 +211,7 @@ static int32_t ComputeSidPeer(const PakeBaseParams *params, Uint8Buff *sidPeer)
 {
     int res;
     Uint8Buff idPeerMsg = { NULL, params->idPeer.length + params->innerKeyLen };
-    idPeerMsg.val = (uint8_t *)HcMalloc(idPeerMsg.length, 0);
+    idPeerMsg.val = (uint8_t *)HcMallocNoZero(idPeerMsg.length);
     if (idPeerMsg.val == NULL) {
         LOGE("Malloc for idPeerMsg failed.");
         res = HC_ERR_ALLOC_MEMORY;
@@ -397,7 +371,7 @@ static int32_t GenerateSharedSecret(PakeBaseParams *params)
         LOGE("Agree intermediate sharedSecret failed, pakeAlgType: 0x%x, res: %x.", params->supportedPakeAlg, res);
         goto CLEAN_UP;
     }
-    FreeAndCleanKey(&params->eskSelf);
+    CleanArenaParam(&params->eskSelf);
     sid.val = (uint8_t *)HcMalloc(sid.length, 0);
     if (sid.val == NULL) {
         LOGE("Malloc for sid failed.");
@@ -560,8 +534,8 @@ static int32_t GenerateSessionKey(PakeBaseParams *params)
         LOGE("ComputeHkdf for sessionKey failed, res: %x.", res);
         CleanPakeSensitiveKeys(params);
     }
-    FreeAndCleanKey(&params->base);
-    FreeAndCleanKey(&params->sharedSecret);
+    CleanArenaParam(&params->base);
+    CleanArenaParam(&params->sharedSecret);
     return res;
 }
 
@@ -19,6 +19,8 @@
 #include "hc_types.h"
 #include "string_util.h"
 
+#define PARAM_ARENA_ALIGN 8
+
 void FreeAndCleanKey(Uint8Buff *key)
 {
     if (key == NULL || key->val == NULL) {
@@ -47,4 +49,61 @@ int32_t InitSingleParam(Uint8Buff *param, uint32_t len)
         return HC_ERR_ALLOC_MEMORY;
     }
     return HC_SUCCESS;
-}
\ No newline at end of file
+}
+
+int32_t InitParamArena(ParamArena *arena, uint32_t capacity)
+{
+    if (arena == NULL) {
+        LOGE("Arena is null.");
+        return HC_ERR_NULL_PTR;
+    }
+    arena->data = (uint8_t *)HcMalloc(capacity, 0);
+    if (arena->data == NULL) {
+        LOGE("Malloc for arena failed.");
+        arena->capacity = 0;
+        arena->usedLen = 0;
+        return HC_ERR_ALLOC_MEMORY;
+    }
+    arena->capacity = capacity;
+    arena->usedLen = 0;
+    return HC_SUCCESS;
+}
+
+int32_t InitArenaParam(ParamArena *arena, Uint8Buff *param, uint32_t len)
+{
+    if ((arena == NULL) || (arena->data == NULL) || (param == NULL)) {
+        LOGE("Arena or param is null.");
+        return HC_ERR_NULL_PTR;
+    }
+    uint32_t alignedLen = (len + PARAM_ARENA_ALIGN - 1) & ~(uint32_t)(PARAM_ARENA_ALIGN - 1);
+    if ((alignedLen < len) || (alignedLen > arena->capacity - arena->usedLen)) {
+        LOGE("Arena is exhausted, need: %u, left: %u.", len, arena->capacity - arena->usedLen);
+        return HC_ERR_ALLOC_MEMORY;
+    }
+    param->val = arena->data + arena->usedLen;
+    param->length = len;
+    arena->usedLen += alignedLen;
+    return HC_SUCCESS;
+}
+
+void CleanArenaParam(Uint8Buff *param)
+{
+    if ((param == NULL) || (param->val == NULL)) {
+        return;
+    }
+    (void)memset_s(param->val, param->length, 0, param->length);
+    param->val = NULL;
+    param->length = 0;
+}
+
+void DestroyParamArena(ParamArena *arena)
+{
+    if ((arena == NULL) || (arena->data == NULL)) {
+        return;
+    }
+    (void)memset_s(arena->data, arena->capacity, 0, arena->capacity);
+    HcFree(arena->data);
+    arena->data = NULL;
+    arena->capacity = 0;
+    arena->usedLen = 0;
+}
@@ -14,12 +14,40 @@
  */
 
 #include "deviceauth_standard_test.h"
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
 #include <gtest/gtest.h>
+#include "account_module.h"
+#include "alg_loader.h"
+#include "auth_session_common.h"
+#include "clib_types.h"
+#include "clib_error.h"
 #include "common_defs.h"
+#include "das_task_common.h"
 #include "device_auth.h"
 #include "device_auth_defines.h"
+#include "ephemeral_pool.h"
+#include "group_operation_common.h"
+#include "hal_error.h"
+#include "hc_deque.h"
+#include "hc_dev_info.h"
+#include "hc_file.h"
+#include "hc_log.h"
+#include "hc_vector.h"
+#include "hc_types.h"
+#include "huks_adapter.h"
+#include "iso_protocol_common.h"
 #include "json_utils.h"
+#include "pake_v1_protocol_common.h"
+#include "pake_v1_resume.h"
+#include "pake_v2_protocol_common.h"
+#include "permission_cache.h"
+#include "protocol_common.h"
 #include "securec.h"
+#include "soft_crypto_adapter.h"
+#include "string_util.h"
 
 using namespace std;
 using namespace testing::ext;
@@ -617,6 +645,25 @@ HWTEST_F(GmGetJoinedGroupsTest, GmGetJoinedGroupsTest002, TestSize.Level0)
     EXPECT_EQ(ret, HC_SUCCESS);
 }
 
+HWTEST_F(GmGetJoinedGroupsTest, GmGetJoinedGroupsTest003, TestSize.Level0)
+{
+    const DeviceGroupManager *gm = GetGmInstance();
+    ASSERT_NE(gm, nullptr);
+    char *firstData = NULL;
+    uint32_t firstNum = 0;
+    int32_t ret = gm->getJoinedGroups(DEFAULT_OS_ACCOUNT, TEST_APP_ID, PEER_TO_PEER_GROUP, &firstData, &firstNum);
+    ASSERT_EQ(ret, HC_SUCCESS);
+    char *secondData = NULL;
+    uint32_t secondNum = 0;
+    ret = gm->getJoinedGroups(DEFAULT_OS_ACCOUNT, TEST_APP_ID, PEER_TO_PEER_GROUP, &secondData, &secondNum);
+    ASSERT_EQ(ret, HC_SUCCESS);
+    EXPECT_EQ(firstNum, secondNum);
+    EXPECT_STREQ(firstData, secondData);
+    EXPECT_NE(firstData, secondData);
+    gm->destroyInfo(&firstData);
+    gm->destroyInfo(&secondData);
+}
+
 class GmGetRelatedGroupsTest : public testing::Test {
 public:
     static void SetUpTestCase();
@@ -800,4 +847,1772 @@ HWTEST_F(GaProcessDataTest, GaProcessDataTest002, TestSize.Level0)
     EXPECT_NE(ga, nullptr);
     int32_t ret = ga->processData(TEST_REQ_ID, NULL, 0, NULL);
     EXPECT_NE(ret, HC_SUCCESS);
-}
\ No newline at end of file
+}
+
+#define TEST_HEX_MAX_BYTE_LEN 300
+#define TEST_HEX_ROUND 2000
+#define TEST_HEX_RANDOM_SEED 20221018
+
+class StringUtilTest : public testing::Test {
+public:
+    static void SetUpTestCase();
+    static void TearDownTestCase();
+    void SetUp();
+    void TearDown();
+};
+
+void StringUtilTest::SetUpTestCase() {}
+void StringUtilTest::TearDownTestCase() {}
+void StringUtilTest::SetUp() {}
+void StringUtilTest::TearDown() {}
+
+static void ReferenceByteToHex(const uint8_t *byte, uint32_t byteLen, char *hexStr)
+{
+    const char *hexChars = "0123456789ABCDEF";
+    for (uint32_t i = 0; i < byteLen; i++) {
+        hexStr[i * BYTE_TO_HEX_OPER_LENGTH] = hexChars[byte[i] >> 4];
+        hexStr[i * BYTE_TO_HEX_OPER_LENGTH + 1] = hexChars[byte[i] & 0x0F];
+    }
+    hexStr[byteLen * BYTE_TO_HEX_OPER_LENGTH] = '\0';
+}
+
+HWTEST_F(StringUtilTest, StringUtilTest001, TestSize.Level0)
+{
+    uint8_t byte[TEST_HEX_MAX_BYTE_LEN] = { 0 };
+    uint8_t decoded[TEST_HEX_MAX_BYTE_LEN] = { 0 };
+    char hexStr[TEST_HEX_MAX_BYTE_LEN * BYTE_TO_HEX_OPER_LENGTH + 1] = { 0 };
+    char expectHexStr[TEST_HEX_MAX_BYTE_LEN * BYTE_TO_HEX_OPER_LENGTH + 1] = { 0 };
+    srand(TEST_HEX_RANDOM_SEED);
+    for (uint32_t round = 0; round < TEST_HEX_ROUND; round++) {
+        uint32_t byteLen = (uint32_t)rand() % TEST_HEX_MAX_BYTE_LEN;
+        for (uint32_t i = 0; i < byteLen; i++) {
+            byte[i] = (uint8_t)rand();
+        }
+        ReferenceByteToHex(byte, byteLen, expectHexStr);
+        int32_t ret = ByteToHexString(byte, byteLen, hexStr, sizeof(hexStr));
+        EXPECT_EQ(ret, CLIB_SUCCESS);
+        EXPECT_STREQ(hexStr, expectHexStr);
+        ret = HexStringToByte(hexStr, decoded, byteLen);
+        EXPECT_EQ(ret, CLIB_SUCCESS);
+        EXPECT_EQ(memcmp(decoded, byte, byteLen), 0);
+    }
+}
+
+HWTEST_F(StringUtilTest, StringUtilTest002, TestSize.Level0)
+{
+    uint8_t byte[TEST_HEX_MAX_BYTE_LEN] = { 0 };
+    uint8_t decoded[TEST_HEX_MAX_BYTE_LEN] = { 0 };
+    char hexStr[TEST_HEX_MAX_BYTE_LEN * BYTE_TO_HEX_OPER_LENGTH + 1] = { 0 };
+    srand(TEST_HEX_RANDOM_SEED);
+    for (uint32_t round = 0; round < TEST_HEX_ROUND; round++) {
+        uint32_t byteLen = (uint32_t)rand() % (TEST_HEX_MAX_BYTE_LEN - 1) + 1;
+        for (uint32_t i = 0; i < byteLen; i++) {
+            byte[i] = (uint8_t)rand();
+        }
+        ReferenceByteToHex(byte, byteLen, hexStr);
+        for (uint32_t i = 0; i < byteLen * BYTE_TO_HEX_OPER_LENGTH; i++) {
+            hexStr[i] = (char)tolower(hexStr[i]);
+        }
+        int32_t ret = HexStringToByte(hexStr, decoded, byteLen);
+        EXPECT_EQ(ret, CLIB_SUCCESS);
+        EXPECT_EQ(memcmp(decoded, byte, byteLen), 0);
+        /* Every byte before the invalid character must still be converted, in any block. */
+        uint32_t invalidPos = (uint32_t)rand() % (byteLen * BYTE_TO_HEX_OPER_LENGTH);
+        hexStr[invalidPos] = 'g';
+        (void)memset_s(decoded, sizeof(decoded), 0, sizeof(decoded));
+        ret = HexStringToByte(hexStr, decoded, byteLen);
+        EXPECT_EQ(ret, CLIB_ERR_INVALID_PARAM);
+        EXPECT_EQ(memcmp(decoded, byte, invalidPos / BYTE_TO_HEX_OPER_LENGTH), 0);
+    }
+}
+
+#define TEST_CRYPTO_MSG_LEN 100
+#define TEST_CRYPTO_KEY_LEN 32
+#define TEST_CRYPTO_SALT_LEN 16
+#define TEST_CRYPTO_NONCE_LEN 12
+#define TEST_CRYPTO_AAD_LEN 8
+#define TEST_CRYPTO_HKDF_LEN 64
+#define TEST_CRYPTO_ROUND 10
+#define TEST_CRYPTO_BENCH_ROUND 200
+#define TEST_CRYPTO_RANDOM_SEED 20221018
+#define TEST_CRYPTO_KEY_INFO "hichain_test_key_info"
+
+class SoftCryptoTest : public testing::Test {
+public:
+    static void SetUpTestCase();
+    static void TearDownTestCase();
+    void SetUp();
+    void TearDown();
+};
+
+void SoftCryptoTest::SetUpTestCase()
+{
+    (void)GetRealLoaderInstance()->initAlg();
+}
+void SoftCryptoTest::TearDownTestCase() {}
+void SoftCryptoTest::SetUp() {}
+void SoftCryptoTest::TearDown() {}
+
+static void FillRandomBytes(uint8_t *buf, uint32_t len)
+{
+    for (uint32_t i = 0; i < len; i++) {
+        buf[i] = (uint8_t)rand();
+    }
+}
+
+/* The crypto of one handshake with session keys in memory: hash, mac, key derivation and the encrypted return. */
+static int32_t RunHandshakeCrypto(const AlgLoader *loader)
+{
+    uint8_t msgVal[TEST_CRYPTO_MSG_LEN] = { 0 };
+    uint8_t keyVal[TEST_CRYPTO_KEY_LEN] = { 0 };
+    uint8_t saltVal[TEST_CRYPTO_SALT_LEN] = { 0 };
+    uint8_t outVal[TEST_CRYPTO_HKDF_LEN] = { 0 };
+    uint8_t nonceVal[TEST_CRYPTO_NONCE_LEN] = { 0 };
+    uint8_t cipherVal[TEST_CRYPTO_MSG_LEN + AE_TAG_LEN] = { 0 };
+    Uint8Buff msg = { msgVal, sizeof(msgVal) };
+    Uint8Buff key = { keyVal, sizeof(keyVal) };
+    Uint8Buff salt = { saltVal, sizeof(saltVal) };
+    Uint8Buff keyInfo = { (uint8_t *)TEST_CRYPTO_KEY_INFO, (uint32_t)strlen(TEST_CRYPTO_KEY_INFO) };
+    Uint8Buff hash = { outVal, SHA256_LEN };
+    Uint8Buff hmac = { outVal, HMAC_LEN };
+    Uint8Buff derived = { outVal, TEST_CRYPTO_HKDF_LEN };
+    Uint8Buff nonce = { nonceVal, sizeof(nonceVal) };
+    Uint8Buff cipher = { cipherVal, sizeof(cipherVal) };
+    GcmParam gcmParam = { nonceVal, sizeof(nonceVal), saltVal, sizeof(saltVal) };
+    int32_t res = HAL_SUCCESS;
+    res |= loader->generateRandom(&salt);
+    res |= loader->generateRandom(&nonce);
+    res |= loader->sha256(&msg, &hash);
+    res |= loader->computeHkdf(&key, &salt, &keyInfo, &derived, false);
+    res |= loader->computeHmac(&key, &msg, &hmac, false);
+    res |= loader->computeHmac(&key, &salt, &hmac, false);
+    res |= loader->aesGcmEncrypt(&key, &msg, &gcmParam, false, &cipher);
+    res |= loader->aesGcmDecrypt(&key, &cipher, &gcmParam, false, &msg);
+    return res;
+}
+
+HWTEST_F(SoftCryptoTest, SoftCryptoTest001, TestSize.Level0)
+{
+    const AlgLoader *huksLoader = GetRealLoaderInstance();
+    const AlgLoader *softLoader = GetSoftCryptoLoaderInstance();
+    uint8_t msgVal[TEST_CRYPTO_MSG_LEN] = { 0 };
+    uint8_t keyVal[TEST_CRYPTO_KEY_LEN] = { 0 };
+    uint8_t saltVal[TEST_CRYPTO_SALT_LEN] = { 0 };
+    uint8_t huksOut[TEST_CRYPTO_HKDF_LEN] = { 0 };
+    uint8_t softOut[TEST_CRYPTO_HKDF_LEN] = { 0 };
+    Uint8Buff key = { keyVal, sizeof(keyVal) };
+    Uint8Buff salt = { saltVal, sizeof(saltVal) };
+    Uint8Buff keyInfo = { (uint8_t *)TEST_CRYPTO_KEY_INFO, (uint32_t)strlen(TEST_CRYPTO_KEY_INFO) };
+    srand(TEST_CRYPTO_RANDOM_SEED);
+    for (uint32_t msgLen = 1; msgLen <= TEST_CRYPTO_MSG_LEN; msgLen++) {
+        FillRandomBytes(msgVal, msgLen);
+        FillRandomBytes(keyVal, sizeof(keyVal));
+        FillRandomBytes(saltVal, sizeof(saltVal));
+        Uint8Buff msg = { msgVal, msgLen };
+        Uint8Buff huksBuff = { huksOut, SHA256_LEN };
+        Uint8Buff softBuff = { softOut, SHA256_LEN };
+        EXPECT_EQ(huksLoader->sha256(&msg, &huksBuff), HAL_SUCCESS);
+        EXPECT_EQ(softLoader->sha256(&msg, &softBuff), HAL_SUCCESS);
+        EXPECT_EQ(memcmp(huksOut, softOut, SHA256_LEN), 0);
+        EXPECT_EQ(huksLoader->computeHmac(&key, &msg, &huksBuff, false), HAL_SUCCESS);
+        EXPECT_EQ(softLoader->computeHmac(&key, &msg, &softBuff, false), HAL_SUCCESS);
+        EXPECT_EQ(memcmp(huksOut, softOut, HMAC_LEN), 0);
+        huksBuff.length = msgLen % TEST_CRYPTO_HKDF_LEN + 1;
+        softBuff.length = huksBuff.length;
+        EXPECT_EQ(huksLoader->computeHkdf(&key, &salt, &keyInfo, &huksBuff, false), HAL_SUCCESS);
+        EXPECT_EQ(softLoader->computeHkdf(&key, &salt, &keyInfo, &softBuff, false), HAL_SUCCESS);
+        EXPECT_EQ(memcmp(huksOut, softOut, huksBuff.length), 0);
+    }
+}
+
+HWTEST_F(SoftCryptoTest, SoftCryptoTest002, TestSize.Level0)
+{
+    const AlgLoader *huksLoader = GetRealLoaderInstance();
+    const AlgLoader *softLoader = GetSoftCryptoLoaderInstance();
+    uint8_t msgVal[TEST_CRYPTO_MSG_LEN] = { 0 };
+    uint8_t keyVal[TEST_CRYPTO_KEY_LEN] = { 0 };
+    uint8_t nonceVal[TEST_CRYPTO_NONCE_LEN] = { 0 };
+    uint8_t aadVal[TEST_CRYPTO_AAD_LEN] = { 0 };
+    uint8_t huksCipher[TEST_CRYPTO_MSG_LEN + AE_TAG_LEN] = { 0 };
+    uint8_t softCipher[TEST_CRYPTO_MSG_LEN + AE_TAG_LEN] = { 0 };
+    uint8_t plainVal[TEST_CRYPTO_MSG_LEN] = { 0 };
+    Uint8Buff key = { keyVal, sizeof(keyVal) };
+    GcmParam gcmParam = { nonceVal, sizeof(nonceVal), aadVal, sizeof(aadVal) };
+    srand(TEST_CRYPTO_RANDOM_SEED);
+    for (uint32_t msgLen = 1; msgLen <= TEST_CRYPTO_MSG_LEN; msgLen++) {
+        FillRandomBytes(msgVal, msgLen);
+        FillRandomBytes(keyVal, sizeof(keyVal));
+        FillRandomBytes(nonceVal, sizeof(nonceVal));
+        FillRandomBytes(aadVal, sizeof(aadVal));
+        Uint8Buff msg = { msgVal, msgLen };
+        Uint8Buff huksBuff = { huksCipher, msgLen + AE_TAG_LEN };
+        Uint8Buff softBuff = { softCipher, msgLen + AE_TAG_LEN };
+        EXPECT_EQ(huksLoader->aesGcmEncrypt(&key, &msg, &gcmParam, false, &huksBuff), HAL_SUCCESS);
+        EXPECT_EQ(softLoader->aesGcmEncrypt(&key, &msg, &gcmParam, false, &softBuff), HAL_SUCCESS);
+        EXPECT_EQ(memcmp(huksCipher, softCipher, msgLen + AE_TAG_LEN), 0);
+        /* Each side must open what the other one sealed. */
+        Uint8Buff plain = { plainVal, msgLen };
+        EXPECT_EQ(softLoader->aesGcmDecrypt(&key, &huksBuff, &gcmParam, false, &plain), HAL_SUCCESS);
+        EXPECT_EQ(memcmp(plainVal, msgVal, msgLen), 0);
+        EXPECT_EQ(huksLoader->aesGcmDecrypt(&key, &softBuff, &gcmParam, false, &plain), HAL_SUCCESS);
+        EXPECT_EQ(memcmp(plainVal, msgVal, msgLen), 0);
+        softCipher[msgLen - 1] ^= 1;
+        EXPECT_NE(softLoader->aesGcmDecrypt(&key, &softBuff, &gcmParam, false, &plain), HAL_SUCCESS);
+        /* No unauthenticated plaintext is left behind. */
+        uint8_t zeroVal[TEST_CRYPTO_MSG_LEN] = { 0 };
+        EXPECT_EQ(memcmp(plainVal, zeroVal, msgLen), 0);
+    }
+}
+
+HWTEST_F(SoftCryptoTest, SoftCryptoTest003, TestSize.Level0)
+{
+    const AlgLoader *huksLoader = GetRealLoaderInstance();
+    const AlgLoader *softLoader = GetSoftCryptoLoaderInstance();
+    EXPECT_EQ(softLoader->sha256(nullptr, nullptr), huksLoader->sha256(nullptr, nullptr));
+    EXPECT_EQ(softLoader->computeHmac(nullptr, nullptr, nullptr, false),
+        huksLoader->computeHmac(nullptr, nullptr, nullptr, false));
+    /* Operations which are not on plain keys must stay with huks. */
+    EXPECT_EQ(softLoader->generateKeyPair, huksLoader->generateKeyPair);
+    EXPECT_EQ(softLoader->checkKeyExist, huksLoader->checkKeyExist);
+    for (uint32_t round = 0; round < TEST_CRYPTO_ROUND; round++) {
+        EXPECT_EQ(RunHandshakeCrypto(huksLoader), HAL_SUCCESS);
+        EXPECT_EQ(RunHandshakeCrypto(softLoader), HAL_SUCCESS);
+    }
+}
+
+/* Average cost of one handshake's crypto in microseconds, failures are left to SoftCryptoTest003. */
+static int64_t MeasureHandshakeCrypto(const AlgLoader *loader)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t round = 0; round < TEST_CRYPTO_BENCH_ROUND; round++) {
+        (void)RunHandshakeCrypto(loader);
+    }
+    auto cost = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    return (int64_t)cost.count() / TEST_CRYPTO_BENCH_ROUND;
+}
+
+/* A benchmark rather than a check, it only reports the costs and never fails on timing. */
+HWTEST_F(SoftCryptoTest, SoftCryptoTest004, TestSize.Level3)
+{
+    int64_t huksCost = MeasureHandshakeCrypto(GetRealLoaderInstance());
+    int64_t softCost = MeasureHandshakeCrypto(GetSoftCryptoLoaderInstance());
+    printf("handshake crypto cost per round, huks: %lld us, soft: %lld us\n", (long long)huksCost,
+        (long long)softCost);
+}
+
+#define TEST_RESUME_PKG_NAME "TestAppId"
+#define TEST_RESUME_SERVICE_TYPE "TestGroupId"
+#define TEST_RESUME_CLIENT_AUTH_ID "TestClientAuthId"
+#define TEST_RESUME_SERVER_AUTH_ID "TestServerAuthId"
+#define TEST_RESUME_SESSION_KEY_LEN 16
+
+class PakeV1ResumeTest : public testing::Test {
+public:
+    static void SetUpTestCase();
+    static void TearDownTestCase();
+    void SetUp();
+    void TearDown();
+};
+
+void PakeV1ResumeTest::SetUpTestCase()
+{
+    (void)GetLoaderInstance()->initAlg();
+}
+void PakeV1ResumeTest::TearDownTestCase() {}
+void PakeV1ResumeTest::SetUp()
+{
+    (void)InitPakeV1ResumeCache();
+}
+void PakeV1ResumeTest::TearDown()
+{
+    DestroyPakeV1ResumeCache();
+}
+
+typedef struct {
+    PakeParams params;
+    uint8_t salt[PAKE_SALT_LEN];
+    uint8_t challengeSelf[PAKE_CHALLENGE_LEN];
+    uint8_t challengePeer[PAKE_CHALLENGE_LEN];
+    uint8_t sessionKey[TEST_RESUME_SESSION_KEY_LEN];
+} TestResumeSide;
+
+/* Only the fields read by the resumption are filled, as after a full handshake which agreed on key and salt. */
+static void InitResumeSide(TestResumeSide *side, const char *authIdPeer, bool isClient)
+{
+    (void)memset_s(side, sizeof(TestResumeSide), 0, sizeof(TestResumeSide));
+    side->params.opCode = AUTHENTICATE;
+    side->params.packageName = const_cast<char *>(TEST_RESUME_PKG_NAME);
+    side->params.serviceType = const_cast<char *>(TEST_RESUME_SERVICE_TYPE);
+    side->params.baseParams.isClient = isClient;
+    side->params.baseParams.loader = GetLoaderInstance();
+    side->params.baseParams.idPeer = { (uint8_t *)authIdPeer, (uint32_t)strlen(authIdPeer) };
+    side->params.baseParams.salt = { side->salt, PAKE_SALT_LEN };
+    side->params.baseParams.challengeSelf = { side->challengeSelf, PAKE_CHALLENGE_LEN };
+    side->params.baseParams.challengePeer = { side->challengePeer, PAKE_CHALLENGE_LEN };
+    side->params.baseParams.sessionKey = { side->sessionKey, TEST_RESUME_SESSION_KEY_LEN };
+    (void)memset_s(side->salt, PAKE_SALT_LEN, 1, PAKE_SALT_LEN);
+    (void)memset_s(side->sessionKey, TEST_RESUME_SESSION_KEY_LEN, 2, TEST_RESUME_SESSION_KEY_LEN);
+}
+
+static int32_t RunResumption(TestResumeSide *client, TestResumeSide *server, CJson *offer)
+{
+    ResumeTicket ticket;
+    int32_t res = AddPakeV1ResumeOffer(&(client->params), &ticket, offer);
+    if (res != HC_SUCCESS) {
+        return res;
+    }
+    CJson *answer = CreateJson();
+    res = ServerFinishPakeV1Resume(&(server->params), offer, answer);
+    if (res == HC_SUCCESS) {
+        res = ClientFinishPakeV1Resume(&(client->params), &ticket, answer);
+    }
+    FreeJson(answer);
+    return res;
+}
+
+HWTEST_F(PakeV1ResumeTest, PakeV1ResumeTest001, TestSize.Level0)
+{
+    TestResumeSide client;
+    TestResumeSide server;
+    InitResumeSide(&client, TEST_RESUME_SERVER_AUTH_ID, true);
+    InitResumeSide(&server, TEST_RESUME_CLIENT_AUTH_ID, false);
+    SavePakeV1ResumeTicket(&(client.params));
+    SavePakeV1ResumeTicket(&(server.params));
+    uint8_t oldKey[TEST_RESUME_SESSION_KEY_LEN] = { 0 };
+    (void)memcpy_s(oldKey, sizeof(oldKey), client.sessionKey, sizeof(oldKey));
+
+    CJson *offer = CreateJson();
+    EXPECT_EQ(RunResumption(&client, &server, offer), HC_SUCCESS);
+    EXPECT_EQ(memcmp(client.sessionKey, server.sessionKey, TEST_RESUME_SESSION_KEY_LEN), 0);
+    EXPECT_NE(memcmp(client.sessionKey, oldKey, TEST_RESUME_SESSION_KEY_LEN), 0);
+    /* The ticket rotated, a replayed offer must fall back to the full handshake. */
+    CJson *answer = CreateJson();
+    EXPECT_NE(ServerFinishPakeV1Resume(&(server.params), offer, answer), HC_SUCCESS);
+    FreeJson(answer);
+    FreeJson(offer);
+
+    (void)memcpy_s(oldKey, sizeof(oldKey), client.sessionKey, sizeof(oldKey));
+    offer = CreateJson();
+    EXPECT_EQ(RunResumption(&client, &server, offer), HC_SUCCESS);
+    EXPECT_EQ(memcmp(client.sessionKey, server.sessionKey, TEST_RESUME_SESSION_KEY_LEN), 0);
+    EXPECT_NE(memcmp(client.sessionKey, oldKey, TEST_RESUME_SESSION_KEY_LEN), 0);
+    FreeJson(offer);
+}
+
+HWTEST_F(PakeV1ResumeTest, PakeV1ResumeTest002, TestSize.Level0)
+{
+    TestResumeSide client;
+    TestResumeSide server;
+    InitResumeSide(&client, TEST_RESUME_SERVER_AUTH_ID, true);
+    InitResumeSide(&server, TEST_RESUME_CLIENT_AUTH_ID, false);
+    SavePakeV1ResumeTicket(&(client.params));
+    SavePakeV1ResumeTicket(&(server.params));
+    /* Deleting the group revokes the tickets of all its peers. */
+    RevokePakeV1ResumeTickets(TEST_RESUME_PKG_NAME, TEST_RESUME_SERVICE_TYPE, nullptr);
+    CJson *offer = CreateJson();
+    EXPECT_NE(RunResumption(&client, &server, offer), HC_SUCCESS);
+    FreeJson(offer);
+
+    SavePakeV1ResumeTicket(&(client.params));
+    SavePakeV1ResumeTicket(&(server.params));
+    /* Deleting the peer on the server: the client still offers, the server refuses. */
+    RevokePakeV1ResumeTickets(TEST_RESUME_PKG_NAME, TEST_RESUME_SERVICE_TYPE, &(server.params.baseParams.idPeer));
+    offer = CreateJson();
+    ResumeTicket ticket;
+    EXPECT_EQ(AddPakeV1ResumeOffer(&(client.params), &ticket, offer), HC_SUCCESS);
+    CJson *answer = CreateJson();
+    EXPECT_NE(ServerFinishPakeV1Resume(&(server.params), offer, answer), HC_SUCCESS);
+    FreeJson(answer);
+    FreeJson(offer);
+}
+
+HWTEST_F(PakeV1ResumeTest, PakeV1ResumeTest003, TestSize.Level0)
+{
+    TestResumeSide client;
+    TestResumeSide server;
+    InitResumeSide(&client, TEST_RESUME_SERVER_AUTH_ID, true);
+    InitResumeSide(&server, TEST_RESUME_CLIENT_AUTH_ID, false);
+    SavePakeV1ResumeTicket(&(client.params));
+    SavePakeV1ResumeTicket(&(server.params));
+    /* An offer with the right ticket id but a forged mac is refused and must not consume the server's ticket. */
+    CJson *offer = CreateJson();
+    ResumeTicket ticket;
+    EXPECT_EQ(AddPakeV1ResumeOffer(&(client.params), &ticket, offer), HC_SUCCESS);
+    uint8_t forgedMac[HMAC_LEN] = { 0 };
+    EXPECT_EQ(AddByteToJson(offer, FIELD_RESUME_MAC, forgedMac, HMAC_LEN), HC_SUCCESS);
+    CJson *answer = CreateJson();
+    EXPECT_EQ(ServerFinishPakeV1Resume(&(server.params), offer, answer), HC_ERR_PROOF_NOT_MATCH);
+    FreeJson(answer);
+    FreeJson(offer);
+
+    offer = CreateJson();
+    EXPECT_EQ(RunResumption(&client, &server, offer), HC_SUCCESS);
+    EXPECT_EQ(memcmp(client.sessionKey, server.sessionKey, TEST_RESUME_SESSION_KEY_LEN), 0);
+    FreeJson(offer);
+}
+
+#define TEST_CALLER_TOKEN_ID_A 537000001
+#define TEST_CALLER_TOKEN_ID_B 537000002
+#define TEST_DENIED_TOKEN_ID 537000003
+#define TEST_FLAKY_TOKEN_ID 537000004
+#define TEST_PERMISSION_REPEAT_TIMES 10
+static uint32_t g_tokenServiceCallCount = 0;
+
+/* Stands in for the access token service and counts how often it is asked. */
+static int32_t StubDecidePermission(uint32_t tokenId)
+{
+    g_tokenServiceCallCount++;
+    if (tokenId == TEST_DENIED_TOKEN_ID) {
+        return HC_ERR_ACCESS_DENIED;
+    }
+    if (tokenId == TEST_FLAKY_TOKEN_ID) {
+        return HC_ERROR;
+    }
+    return HC_SUCCESS;
+}
+
+class PermissionCacheTest : public testing::Test {
+public:
+    static void SetUpTestCase();
+    static void TearDownTestCase();
+    void SetUp();
+    void TearDown();
+};
+
+void PermissionCacheTest::SetUpTestCase() {}
+void PermissionCacheTest::TearDownTestCase() {}
+void PermissionCacheTest::SetUp()
+{
+    ClearPermissionCache();
+    g_tokenServiceCallCount = 0;
+}
+void PermissionCacheTest::TearDown()
+{
+    ClearPermissionCache();
+}
+
+HWTEST_F(PermissionCacheTest, PermissionCacheTest001, TestSize.Level0)
+{
+    for (int i = 0; i < TEST_PERMISSION_REPEAT_TIMES; i++) {
+        EXPECT_EQ(CheckPermissionWithCache(TEST_CALLER_TOKEN_ID_A, StubDecidePermission), HC_SUCCESS);
+        EXPECT_EQ(CheckPermissionWithCache(TEST_CALLER_TOKEN_ID_B, StubDecidePermission), HC_SUCCESS);
+        EXPECT_EQ(CheckPermissionWithCache(TEST_DENIED_TOKEN_ID, StubDecidePermission), HC_ERR_ACCESS_DENIED);
+    }
+    /* One question to the token service per caller, denials included. */
+    EXPECT_EQ(g_tokenServiceCallCount, 3u);
+    ClearPermissionCache();
+    EXPECT_EQ(CheckPermissionWithCache(TEST_CALLER_TOKEN_ID_A, StubDecidePermission), HC_SUCCESS);
+    EXPECT_EQ(CheckPermissionWithCache(TEST_CALLER_TOKEN_ID_B, StubDecidePermission), HC_SUCCESS);
+    EXPECT_EQ(g_tokenServiceCallCount, 5u);
+}
+
+HWTEST_F(PermissionCacheTest, PermissionCacheTest002, TestSize.Level0)
+{
+    /* A failed query is not a decision, the next request asks again. */
+    EXPECT_EQ(CheckPermissionWithCache(TEST_FLAKY_TOKEN_ID, StubDecidePermission), HC_ERROR);
+    EXPECT_EQ(CheckPermissionWithCache(TEST_FLAKY_TOKEN_ID, StubDecidePermission), HC_ERROR);
+    EXPECT_EQ(g_tokenServiceCallCount, 2u);
+    EXPECT_EQ(CheckPermissionWithCache(TEST_CALLER_TOKEN_ID_A, nullptr), HC_ERR_NULL_PTR);
+}
+
+HWTEST_F(PermissionCacheTest, PermissionCacheTest003, TestSize.Level0)
+{
+    EXPECT_EQ(CheckPermissionWithCache(TEST_CALLER_TOKEN_ID_A, StubDecidePermission), HC_SUCCESS);
+    EXPECT_EQ(CheckPermissionWithCache(TEST_CALLER_TOKEN_ID_B, StubDecidePermission), HC_SUCCESS);
+    EXPECT_EQ(g_tokenServiceCallCount, 2u);
+    /* Only the caller whose permissions changed asks the token service again. */
+    InvalidatePermissionCache(TEST_CALLER_TOKEN_ID_A);
+    EXPECT_EQ(CheckPermissionWithCache(TEST_CALLER_TOKEN_ID_A, StubDecidePermission), HC_SUCCESS);
+    EXPECT_EQ(CheckPermissionWithCache(TEST_CALLER_TOKEN_ID_B, StubDecidePermission), HC_SUCCESS);
+    EXPECT_EQ(g_tokenServiceCallCount, 3u);
+    EXPECT_EQ(CheckPermissionWithCache(TEST_CALLER_TOKEN_ID_A, StubDecidePermission), HC_SUCCESS);
+    EXPECT_EQ(g_tokenServiceCallCount, 3u);
+    /* A token which is not cached is ignored. */
+    InvalidatePermissionCache(TEST_DENIED_TOKEN_ID);
+    EXPECT_EQ(CheckPermissionWithCache(TEST_CALLER_TOKEN_ID_B, StubDecidePermission), HC_SUCCESS);
+    EXPECT_EQ(g_tokenServiceCallCount, 3u);
+}
+
+#define TEST_JSON_SPECIAL_STR "Name\"with\\special/chars\b\f\n\r\t\x01\x1f\xe4\xb8\xad"
+#define TEST_JSON_GROUP_ID "TestGroupId"
+#define TEST_JSON_AUTH_ID "TestAuthId"
+#define TEST_JSON_DEVICE_NUM 3
+
+class JsonWriterTest : public testing::Test {
+public:
+    static void SetUpTestCase();
+    static void TearDownTestCase();
+    void SetUp();
+    void TearDown();
+};
+
+void JsonWriterTest::SetUpTestCase() {}
+void JsonWriterTest::TearDownTestCase() {}
+void JsonWriterTest::SetUp() {}
+void JsonWriterTest::TearDown() {}
+
+static int32_t WriteTestDeviceArray(JsonWriter *writer, const void *ctx)
+{
+    const DeviceEntryVec *vec = (const DeviceEntryVec *)ctx;
+    int32_t res = JsonWriterStartArray(writer, NULL);
+    uint32_t index;
+    TrustedDeviceEntry **entry = NULL;
+    FOR_EACH_HC_VECTOR(*vec, index, entry) {
+        if ((res == CLIB_SUCCESS) && (WriteReturnDevInfo(writer, *entry) != HC_SUCCESS)) {
+            res = CLIB_FAILED;
+        }
+    }
+    return (res == CLIB_SUCCESS) ? JsonWriterEndArray(writer) : res;
+}
+
+/* The string the query returned before the writer, built through a cJSON tree. */
+static char *PackTestDeviceArray(const DeviceEntryVec *vec)
+{
+    CJson *array = CreateJsonArray();
+    uint32_t index;
+    TrustedDeviceEntry **entry = NULL;
+    FOR_EACH_HC_VECTOR(*vec, index, entry) {
+        CJson *devJson = CreateJson();
+        (void)AddStringToJson(devJson, FIELD_AUTH_ID, StringGet(&(*entry)->authId));
+        (void)AddIntToJson(devJson, FIELD_CREDENTIAL_TYPE, (*entry)->credential);
+        (void)AddIntToJson(devJson, FIELD_USER_TYPE, (*entry)->devType);
+        (void)AddObjToArray(array, devJson);
+    }
+    char *str = PackJsonToString(array);
+    FreeJson(array);
+    return str;
+}
+
+HWTEST_F(JsonWriterTest, JsonWriterTest001, TestSize.Level0)
+{
+    TrustedGroupEntry *groupEntry = CreateGroupEntry();
+    ASSERT_NE(groupEntry, nullptr);
+    EXPECT_EQ(AddGroupNameToParams(TEST_JSON_SPECIAL_STR, groupEntry), HC_SUCCESS);
+    EXPECT_EQ(AddGroupIdToParams(TEST_JSON_GROUP_ID, groupEntry), HC_SUCCESS);
+    EXPECT_EQ(AddGroupOwnerToParams(TEST_APP_ID, groupEntry), HC_SUCCESS);
+    groupEntry->type = PEER_TO_PEER_GROUP;
+    groupEntry->visibility = GROUP_VISIBILITY_PUBLIC;
+    CJson *expectJson = CreateJson();
+    (void)AddStringToJson(expectJson, FIELD_GROUP_NAME, TEST_JSON_SPECIAL_STR);
+    (void)AddStringToJson(expectJson, FIELD_GROUP_ID, TEST_JSON_GROUP_ID);
+    (void)AddStringToJson(expectJson, FIELD_GROUP_OWNER, TEST_APP_ID);
+    (void)AddIntToJson(expectJson, FIELD_GROUP_TYPE, PEER_TO_PEER_GROUP);
+    (void)AddIntToJson(expectJson, FIELD_GROUP_VISIBILITY, GROUP_VISIBILITY_PUBLIC);
+    char *expectStr = PackJsonToString(expectJson);
+    char *groupInfo = nullptr;
+    EXPECT_EQ(GenerateReturnGroupInfo(groupEntry, &groupInfo), HC_SUCCESS);
+    ASSERT_NE(expectStr, nullptr);
+    ASSERT_NE(groupInfo, nullptr);
+    EXPECT_STREQ(groupInfo, expectStr);
+    FreeJsonString(groupInfo);
+    FreeJsonString(expectStr);
+    FreeJson(expectJson);
+    DestroyGroupEntry(groupEntry);
+}
+
+HWTEST_F(JsonWriterTest, JsonWriterTest002, TestSize.Level0)
+{
+    DeviceEntryVec vec = CreateDeviceEntryVec();
+    /* An empty result is written as an empty array. */
+    char *expectStr = PackTestDeviceArray(&vec);
+    char *devInfo = WriteJsonToString(WriteTestDeviceArray, &vec);
+    ASSERT_NE(expectStr, nullptr);
+    ASSERT_NE(devInfo, nullptr);
+    EXPECT_STREQ(devInfo, expectStr);
+    FreeJsonString(devInfo);
+    FreeJsonString(expectStr);
+
+    const char *authIds[TEST_JSON_DEVICE_NUM] = { TEST_JSON_AUTH_ID, TEST_JSON_SPECIAL_STR, "" };
+    for (uint32_t i = 0; i < TEST_JSON_DEVICE_NUM; i++) {
+        TrustedDeviceEntry *devEntry = CreateDeviceEntry();
+        ASSERT_NE(devEntry, nullptr);
+        EXPECT_TRUE(StringSetPointer(&devEntry->authId, authIds[i]));
+        devEntry->credential = SYMMETRIC_CRED;
+        devEntry->devType = DEVICE_TYPE_ACCESSORY + i;
+        vec.pushBackT(&vec, devEntry);
+    }
+    expectStr = PackTestDeviceArray(&vec);
+    devInfo = WriteJsonToString(WriteTestDeviceArray, &vec);
+    ASSERT_NE(expectStr, nullptr);
+    ASSERT_NE(devInfo, nullptr);
+    EXPECT_STREQ(devInfo, expectStr);
+    FreeJsonString(devInfo);
+    devInfo = nullptr;
+    EXPECT_EQ(GenerateReturnDevInfo(HC_VECTOR_GET(&vec, 1), &devInfo), HC_SUCCESS);
+    ASSERT_NE(devInfo, nullptr);
+    EXPECT_NE(strstr(expectStr, devInfo), nullptr);
+    FreeJsonString(devInfo);
+    FreeJsonString(expectStr);
+    ClearDeviceEntryVec(&vec);
+}
+
+#define TEST_DB_OS_ACCOUNT_ID 1001
+#define TEST_DB_GROUP_ID_A "TestDbGroupIdA"
+#define TEST_DB_GROUP_ID_B "TestDbGroupIdB"
+#define TEST_DB_GROUP_ID_C "TestDbGroupIdC"
+#define TEST_DB_APP_ID_X "TestDbAppIdX"
+#define TEST_DB_APP_ID_Y "TestDbAppIdY"
+#define TEST_DB_APP_ID_Z "TestDbAppIdZ"
+
+class DataManagerAccessTest : public testing::Test {
+public:
+    static void SetUpTestCase();
+    static void TearDownTestCase();
+    void SetUp();
+    void TearDown();
+};
+
+void DataManagerAccessTest::SetUpTestCase() {}
+void DataManagerAccessTest::TearDownTestCase() {}
+
+void DataManagerAccessTest::SetUp()
+{
+    int ret = InitDeviceAuthService();
+    EXPECT_EQ(ret, HC_SUCCESS);
+}
+
+void DataManagerAccessTest::TearDown()
+{
+    DestroyDeviceAuthService();
+}
+
+/* AddGroup keeps the owner only, the owner is the only app with a role in the group. */
+static int32_t AddTestGroup(int32_t osAccountId, const char *groupId, const char *owner, int32_t visibility)
+{
+    TrustedGroupEntry *groupEntry = CreateGroupEntry();
+    if (groupEntry == nullptr) {
+        return HC_ERR_ALLOC_MEMORY;
+    }
+    int32_t res = AddGroupNameToParams(groupId, groupEntry);
+    if (res == HC_SUCCESS) {
+        res = AddGroupIdToParams(groupId, groupEntry);
+    }
+    if (res == HC_SUCCESS) {
+        res = AddGroupOwnerToParams(owner, groupEntry);
+    }
+    groupEntry->type = PEER_TO_PEER_GROUP;
+    groupEntry->visibility = visibility;
+    if (res == HC_SUCCESS) {
+        res = AddGroup(osAccountId, groupEntry);
+    }
+    DestroyGroupEntry(groupEntry);
+    return res;
+}
+
+HWTEST_F(DataManagerAccessTest, DataManagerAccessTest001, TestSize.Level0)
+{
+    EXPECT_EQ(AddTestGroup(TEST_DB_OS_ACCOUNT_ID, TEST_DB_GROUP_ID_A, TEST_DB_APP_ID_X, GROUP_VISIBILITY_PRIVATE),
+        HC_SUCCESS);
+    EXPECT_EQ(AddTestGroup(TEST_DB_OS_ACCOUNT_ID, TEST_DB_GROUP_ID_B, TEST_DB_APP_ID_Y, GROUP_VISIBILITY_PRIVATE),
+        HC_SUCCESS);
+    EXPECT_EQ(AddTestGroup(TEST_DB_OS_ACCOUNT_ID, TEST_DB_GROUP_ID_C, TEST_DB_APP_ID_Z, GROUP_VISIBILITY_PUBLIC),
+        HC_SUCCESS);
+    EXPECT_EQ(CheckGroupAccess(TEST_DB_OS_ACCOUNT_ID, TEST_DB_GROUP_ID_A, TEST_DB_APP_ID_X), HC_SUCCESS);
+    EXPECT_EQ(CheckGroupAccess(TEST_DB_OS_ACCOUNT_ID, TEST_DB_GROUP_ID_A, TEST_DB_APP_ID_Y), HC_ERR_ACCESS_DENIED);
+    EXPECT_EQ(CheckGroupAccess(TEST_DB_OS_ACCOUNT_ID, TEST_DB_GROUP_ID_A, TEST_DB_APP_ID_Z), HC_ERR_ACCESS_DENIED);
+    EXPECT_EQ(CheckGroupAccess(TEST_DB_OS_ACCOUNT_ID, TEST_DB_GROUP_ID_B, TEST_DB_APP_ID_X), HC_ERR_ACCESS_DENIED);
+    EXPECT_EQ(CheckGroupAccess(TEST_DB_OS_ACCOUNT_ID, TEST_DB_GROUP_ID_C, TEST_DB_APP_ID_X), HC_SUCCESS);
+
+    /* Replacing the group drops the roles of the old entry from the index. */
+    EXPECT_EQ(AddTestGroup(TEST_DB_OS_ACCOUNT_ID, TEST_DB_GROUP_ID_A, TEST_DB_APP_ID_Z, GROUP_VISIBILITY_PRIVATE),
+        HC_SUCCESS);
+    EXPECT_EQ(CheckGroupAccess(TEST_DB_OS_ACCOUNT_ID, TEST_DB_GROUP_ID_A, TEST_DB_APP_ID_X), HC_ERR_ACCESS_DENIED);
+    EXPECT_EQ(CheckGroupAccess(TEST_DB_OS_ACCOUNT_ID, TEST_DB_GROUP_ID_A, TEST_DB_APP_ID_Y), HC_ERR_ACCESS_DENIED);
+    EXPECT_EQ(CheckGroupAccess(TEST_DB_OS_ACCOUNT_ID, TEST_DB_GROUP_ID_A, TEST_DB_APP_ID_Z), HC_SUCCESS);
+    EXPECT_EQ(CheckGroupAccess(TEST_DB_OS_ACCOUNT_ID, TEST_DB_GROUP_ID_B, TEST_DB_APP_ID_Y), HC_SUCCESS);
+
+    GroupEntryVec groupVec = CreateGroupEntryVec();
+    QueryGroupParams params = InitQueryGroupParams();
+    EXPECT_EQ(QueryGroups(TEST_DB_OS_ACCOUNT_ID, &params, &groupVec), HC_SUCCESS);
+    EXPECT_EQ(HC_VECTOR_SIZE(&groupVec), 3u);
+    EXPECT_EQ(RemoveInaccessibleGroups(TEST_DB_OS_ACCOUNT_ID, TEST_DB_APP_ID_Y, &groupVec), HC_SUCCESS);
+    EXPECT_EQ(HC_VECTOR_SIZE(&groupVec), 2u);
+    ClearGroupEntryVec(&groupVec);
+}
+
+HWTEST_F(DataManagerAccessTest, DataManagerAccessTest002, TestSize.Level0)
+{
+    EXPECT_EQ(AddTestGroup(TEST_DB_OS_ACCOUNT_ID, TEST_DB_GROUP_ID_A, TEST_DB_APP_ID_X, GROUP_VISIBILITY_PRIVATE),
+        HC_SUCCESS);
+    EXPECT_EQ(AddTestGroup(TEST_DB_OS_ACCOUNT_ID, TEST_DB_GROUP_ID_B, TEST_DB_APP_ID_Y, GROUP_VISIBILITY_PRIVATE),
+        HC_SUCCESS);
+    QueryGroupParams params = InitQueryGroupParams();
+    params.groupId = TEST_DB_GROUP_ID_A;
+    EXPECT_EQ(DelGroup(TEST_DB_OS_ACCOUNT_ID, &params), HC_SUCCESS);
+    EXPECT_EQ(CheckGroupAccess(TEST_DB_OS_ACCOUNT_ID, TEST_DB_GROUP_ID_A, TEST_DB_APP_ID_X), HC_ERR_GROUP_NOT_EXIST);
+    EXPECT_EQ(CheckGroupAccess(TEST_DB_OS_ACCOUNT_ID, TEST_DB_GROUP_ID_B, TEST_DB_APP_ID_Y), HC_SUCCESS);
+
+    /* A group created again under the deleted id must not inherit the roles of the deleted one. */
+    EXPECT_EQ(AddTestGroup(TEST_DB_OS_ACCOUNT_ID, TEST_DB_GROUP_ID_A, TEST_DB_APP_ID_Z, GROUP_VISIBILITY_PRIVATE),
+        HC_SUCCESS);
+    EXPECT_EQ(CheckGroupAccess(TEST_DB_OS_ACCOUNT_ID, TEST_DB_GROUP_ID_A, TEST_DB_APP_ID_X), HC_ERR_ACCESS_DENIED);
+    EXPECT_EQ(CheckGroupAccess(TEST_DB_OS_ACCOUNT_ID, TEST_DB_GROUP_ID_A, TEST_DB_APP_ID_Y), HC_ERR_ACCESS_DENIED);
+    EXPECT_EQ(CheckGroupAccess(TEST_DB_OS_ACCOUNT_ID, TEST_DB_GROUP_ID_A, TEST_DB_APP_ID_Z), HC_SUCCESS);
+}
+
+#define TEST_BATCH_OS_ACCOUNT_ID 1002
+#define TEST_BATCH_GROUP_ID "TestBatchGroupId"
+#define TEST_BATCH_DEVICE_NUM 4
+#define TEST_BATCH_DEL_NUM 2
+static const char *g_testBatchUdids[TEST_BATCH_DEVICE_NUM] = {
+    "TestBatchUdid0", "TestBatchUdid1", "TestBatchUdid2", "TestBatchUdid3"
+};
+static const char *g_testBatchAuthIds[TEST_BATCH_DEVICE_NUM] = {
+    "TestBatchAuthId0", "TestBatchAuthId1", "TestBatchAuthId2", "TestBatchAuthId3"
+};
+#define TEST_BATCH_GROUP_ID_B "TestBatchGroupIdB"
+#define TEST_BATCH_EVENT_MAX_NUM 16
+#define TEST_BATCH_EVENT_LEN 64
+#define TEST_BATCH_ADD_NUM 3
+static uint32_t g_testBoundCount = 0;
+static uint32_t g_testUnBoundCount = 0;
+static const char *g_testFirstGroupInfo = nullptr;
+static bool g_isTestGroupInfoShared = true;
+static char g_testEvents[TEST_BATCH_EVENT_MAX_NUM][TEST_BATCH_EVENT_LEN];
+static uint32_t g_testEventNum = 0;
+
+/* A batch builds the group info once, every device of it is posted with the same string. */
+static void RecordTestGroupInfo(const char *groupInfo)
+{
+    if (g_testFirstGroupInfo == nullptr) {
+        g_testFirstGroupInfo = groupInfo;
+    } else if (g_testFirstGroupInfo != groupInfo) {
+        g_isTestGroupInfoShared = false;
+    }
+}
+
+/* The notifications of the devices are recorded in the order they are posted. */
+static void RecordTestEvent(const char *type, const char *peerUdid)
+{
+    if (g_testEventNum < TEST_BATCH_EVENT_MAX_NUM) {
+        (void)sprintf_s(g_testEvents[g_testEventNum], TEST_BATCH_EVENT_LEN, "%s:%s", type, peerUdid);
+    }
+    g_testEventNum++;
+}
+
+static void ResetTestBroadcastRecord(void)
+{
+    g_testBoundCount = 0;
+    g_testUnBoundCount = 0;
+    g_testFirstGroupInfo = nullptr;
+    g_isTestGroupInfoShared = true;
+    g_testEventNum = 0;
+}
+
+static void OnTestDeviceBound(const char *peerUdid, const char *groupInfo)
+{
+    g_testBoundCount++;
+    RecordTestGroupInfo(groupInfo);
+    RecordTestEvent("Bound", peerUdid);
+}
+
+static void OnTestDeviceUnBound(const char *peerUdid, const char *groupInfo)
+{
+    g_testUnBoundCount++;
+    RecordTestGroupInfo(groupInfo);
+    RecordTestEvent("UnBound", peerUdid);
+}
+
+static void OnTestDeviceNotTrusted(const char *peerUdid)
+{
+    RecordTestEvent("NotTrusted", peerUdid);
+}
+
+class DataManagerBatchTest : public testing::Test {
+public:
+    static void SetUpTestCase();
+    static void TearDownTestCase();
+    void SetUp();
+    void TearDown();
+};
+
+void DataManagerBatchTest::SetUpTestCase() {}
+void DataManagerBatchTest::TearDownTestCase() {}
+
+void DataManagerBatchTest::SetUp()
+{
+    int ret = InitDeviceAuthService();
+    EXPECT_EQ(ret, HC_SUCCESS);
+    DataChangeListener listener;
+    (void)memset_s(&listener, sizeof(listener), 0, sizeof(listener));
+    listener.onDeviceBound = OnTestDeviceBound;
+    listener.onDeviceUnBound = OnTestDeviceUnBound;
+    listener.onDeviceNotTrusted = OnTestDeviceNotTrusted;
+    ret = GetGmInstance()->regDataChangeListener(TEST_APP_ID, &listener);
+    EXPECT_EQ(ret, HC_SUCCESS);
+    ResetTestBroadcastRecord();
+}
+
+void DataManagerBatchTest::TearDown()
+{
+    (void)DelGroupCascade(TEST_BATCH_OS_ACCOUNT_ID, TEST_BATCH_GROUP_ID, nullptr);
+    (void)DelGroupCascade(TEST_BATCH_OS_ACCOUNT_ID, TEST_BATCH_GROUP_ID_B, nullptr);
+    (void)SaveOsAccountDb(TEST_BATCH_OS_ACCOUNT_ID);
+    DestroyDeviceAuthService();
+}
+
+static TrustedDeviceEntry *CreateTestDeviceEntry(const char *groupId, const char *udid, const char *authId)
+{
+    TrustedDeviceEntry *entry = CreateDeviceEntry();
+    if (entry == nullptr) {
+        return nullptr;
+    }
+    if (!StringSetPointer(&entry->groupId, groupId) || !StringSetPointer(&entry->serviceType, groupId) ||
+        !StringSetPointer(&entry->udid, udid) || !StringSetPointer(&entry->authId, authId)) {
+        DestroyDeviceEntry(entry);
+        return nullptr;
+    }
+    return entry;
+}
+
+static int32_t AddTestDevices(int32_t osAccountId, const char *groupId, const char **udids, const char **authIds,
+    uint32_t num, bool *isNewEntries)
+{
+    DeviceEntryVec vec = CreateDeviceEntryVec();
+    int32_t res = HC_SUCCESS;
+    for (uint32_t i = 0; i < num; i++) {
+        TrustedDeviceEntry *entry = CreateTestDeviceEntry(groupId, udids[i], authIds[i]);
+        if ((entry == nullptr) || (vec.pushBackT(&vec, entry) == nullptr)) {
+            DestroyDeviceEntry(entry);
+            res = HC_ERR_ALLOC_MEMORY;
+            break;
+        }
+    }
+    if (res == HC_SUCCESS) {
+        res = AddTrustedDevices(osAccountId, &vec, isNewEntries);
+    }
+    ClearDeviceEntryVec(&vec);
+    return res;
+}
+
+static uint32_t CountTestDevices(int32_t osAccountId, const char *groupId)
+{
+    QueryDeviceParams params = InitQueryDeviceParams();
+    params.groupId = groupId;
+    return CountDevices(osAccountId, &params);
+}
+
+HWTEST_F(DataManagerBatchTest, DataManagerBatchTest001, TestSize.Level0)
+{
+    EXPECT_EQ(AddTestGroup(TEST_BATCH_OS_ACCOUNT_ID, TEST_BATCH_GROUP_ID, TEST_APP_ID, GROUP_VISIBILITY_PRIVATE),
+        HC_SUCCESS);
+    ResetTestBroadcastRecord();
+    uint64_t generation = GetDbGeneration();
+    EXPECT_EQ(AddTestDevices(TEST_BATCH_OS_ACCOUNT_ID, TEST_BATCH_GROUP_ID, g_testBatchUdids, g_testBatchAuthIds,
+        TEST_BATCH_DEVICE_NUM, nullptr), HC_SUCCESS);
+    /* One locked mutation and one broadcast for the whole batch. */
+    EXPECT_EQ(GetDbGeneration(), generation + 1);
+    EXPECT_EQ(g_testBoundCount, (uint32_t)TEST_BATCH_DEVICE_NUM);
+    EXPECT_TRUE(g_isTestGroupInfoShared);
+    EXPECT_EQ(SaveOsAccountDb(TEST_BATCH_OS_ACCOUNT_ID), HC_SUCCESS);
+
+    /* The single save persists the whole batch. */
+    DestroyDeviceAuthService();
+    EXPECT_EQ(InitDeviceAuthService(), HC_SUCCESS);
+    EXPECT_EQ(CountTestDevices(TEST_BATCH_OS_ACCOUNT_ID, TEST_BATCH_GROUP_ID), (uint32_t)TEST_BATCH_DEVICE_NUM);
+}
+
+HWTEST_F(DataManagerBatchTest, DataManagerBatchTest002, TestSize.Level0)
+{
+    EXPECT_EQ(AddTestGroup(TEST_BATCH_OS_ACCOUNT_ID, TEST_BATCH_GROUP_ID, TEST_APP_ID, GROUP_VISIBILITY_PRIVATE),
+        HC_SUCCESS);
+    EXPECT_EQ(AddTestDevices(TEST_BATCH_OS_ACCOUNT_ID, TEST_BATCH_GROUP_ID, g_testBatchUdids, g_testBatchAuthIds,
+        TEST_BATCH_DEVICE_NUM, nullptr), HC_SUCCESS);
+    StringVector authIds = CreateStrVector();
+    for (uint32_t i = 0; i < TEST_BATCH_DEL_NUM; i++) {
+        HcString authId = CreateString();
+        EXPECT_TRUE(StringSetPointer(&authId, g_testBatchAuthIds[i]));
+        EXPECT_NE(authIds.pushBackT(&authIds, authId), nullptr);
+    }
+    ResetTestBroadcastRecord();
+    uint64_t generation = GetDbGeneration();
+    DeviceEntryVec delEntries = CreateDeviceEntryVec();
+    EXPECT_EQ(DelTrustedDevices(TEST_BATCH_OS_ACCOUNT_ID, TEST_BATCH_GROUP_ID, &authIds, &delEntries), HC_SUCCESS);
+    DestroyStrVector(&authIds);
+    EXPECT_EQ(GetDbGeneration(), generation + 1);
+    EXPECT_EQ(g_testUnBoundCount, (uint32_t)TEST_BATCH_DEL_NUM);
+    EXPECT_TRUE(g_isTestGroupInfoShared);
+    EXPECT_EQ(HC_VECTOR_SIZE(&delEntries), (uint32_t)TEST_BATCH_DEL_NUM);
+    ClearDeviceEntryVec(&delEntries);
+    /* The devices left keep the order they were added in. */
+    DeviceEntryVec leftEntries = CreateDeviceEntryVec();
+    QueryDeviceParams params = InitQueryDeviceParams();
+    params.groupId = TEST_BATCH_GROUP_ID;
+    EXPECT_EQ(QueryDevices(TEST_BATCH_OS_ACCOUNT_ID, &params, &leftEntries), HC_SUCCESS);
+    ASSERT_EQ(HC_VECTOR_SIZE(&leftEntries), (uint32_t)(TEST_BATCH_DEVICE_NUM - TEST_BATCH_DEL_NUM));
+    for (uint32_t i = 0; i < HC_VECTOR_SIZE(&leftEntries); i++) {
+        EXPECT_STREQ(StringGet(&HC_VECTOR_GET(&leftEntries, i)->authId), g_testBatchAuthIds[TEST_BATCH_DEL_NUM + i]);
+    }
+    ClearDeviceEntryVec(&leftEntries);
+}
+
+HWTEST_F(DataManagerBatchTest, DataManagerBatchTest003, TestSize.Level0)
+{
+    EXPECT_EQ(AddTestGroup(TEST_BATCH_OS_ACCOUNT_ID, TEST_BATCH_GROUP_ID, TEST_APP_ID, GROUP_VISIBILITY_PRIVATE),
+        HC_SUCCESS);
+    EXPECT_EQ(AddTestGroup(TEST_BATCH_OS_ACCOUNT_ID, TEST_BATCH_GROUP_ID_B, TEST_APP_ID, GROUP_VISIBILITY_PRIVATE),
+        HC_SUCCESS);
+    EXPECT_EQ(AddTestDevices(TEST_BATCH_OS_ACCOUNT_ID, TEST_BATCH_GROUP_ID, g_testBatchUdids, g_testBatchAuthIds,
+        TEST_BATCH_DEVICE_NUM, nullptr), HC_SUCCESS);
+    /* The second device is also trusted through the other group. */
+    EXPECT_EQ(AddTestDevices(TEST_BATCH_OS_ACCOUNT_ID, TEST_BATCH_GROUP_ID_B, &g_testBatchUdids[1],
+        &g_testBatchAuthIds[1], 1, nullptr), HC_SUCCESS);
+    ResetTestBroadcastRecord();
+    uint64_t generation = GetDbGeneration();
+    DeviceEntryVec delEntries = CreateDeviceEntryVec();
+    EXPECT_EQ(DelGroupCascade(TEST_BATCH_OS_ACCOUNT_ID, TEST_BATCH_GROUP_ID, &delEntries), HC_SUCCESS);
+    EXPECT_EQ(GetDbGeneration(), generation + 1);
+    ASSERT_EQ(HC_VECTOR_SIZE(&delEntries), (uint32_t)TEST_BATCH_DEVICE_NUM);
+    for (uint32_t i = 0; i < TEST_BATCH_DEVICE_NUM; i++) {
+        EXPECT_STREQ(StringGet(&HC_VECTOR_GET(&delEntries, i)->udid), g_testBatchUdids[i]);
+    }
+    ClearDeviceEntryVec(&delEntries);
+
+    /* Each unbound device is directly followed by its not-trusted notification, the shared one has none. */
+    const char *expectEvents[] = {
+        "UnBound:TestBatchUdid0", "NotTrusted:TestBatchUdid0", "UnBound:TestBatchUdid1",
+        "UnBound:TestBatchUdid2", "NotTrusted:TestBatchUdid2", "UnBound:TestBatchUdid3", "NotTrusted:TestBatchUdid3"
+    };
+    uint32_t expectNum = sizeof(expectEvents) / sizeof(expectEvents[0]);
+    ASSERT_EQ(g_testEventNum, expectNum);
+    for (uint32_t i = 0; i < expectNum; i++) {
+        EXPECT_STREQ(g_testEvents[i], expectEvents[i]);
+    }
+    EXPECT_TRUE(g_isTestGroupInfoShared);
+    EXPECT_EQ(CountTestDevices(TEST_BATCH_OS_ACCOUNT_ID, TEST_BATCH_GROUP_ID), 0u);
+    EXPECT_EQ(CountTestDevices(TEST_BATCH_OS_ACCOUNT_ID, TEST_BATCH_GROUP_ID_B), 1u);
+    QueryGroupParams params = InitQueryGroupParams();
+    params.groupId = TEST_BATCH_GROUP_ID;
+    EXPECT_FALSE(ExistsGroup(TEST_BATCH_OS_ACCOUNT_ID, &params));
+}
+
+HWTEST_F(DataManagerBatchTest, DataManagerBatchTest004, TestSize.Level0)
+{
+    EXPECT_EQ(AddTestGroup(TEST_BATCH_OS_ACCOUNT_ID, TEST_BATCH_GROUP_ID, TEST_APP_ID, GROUP_VISIBILITY_PRIVATE),
+        HC_SUCCESS);
+    EXPECT_EQ(AddTestDevices(TEST_BATCH_OS_ACCOUNT_ID, TEST_BATCH_GROUP_ID, g_testBatchUdids, g_testBatchAuthIds,
+        TEST_BATCH_DEL_NUM, nullptr), HC_SUCCESS);
+    /* The second device is trusted already, the third one is listed twice and keeps its last entry. */
+    const char *udids[TEST_BATCH_ADD_NUM] = { g_testBatchUdids[1], g_testBatchUdids[2], g_testBatchUdids[2] };
+    const char *authIds[TEST_BATCH_ADD_NUM] = { "TestBatchNewAuthId1", "TestBatchOldAuthId2", g_testBatchAuthIds[2] };
+    bool isNewEntries[TEST_BATCH_ADD_NUM] = { true, true, false };
+    ResetTestBroadcastRecord();
+    EXPECT_EQ(AddTestDevices(TEST_BATCH_OS_ACCOUNT_ID, TEST_BATCH_GROUP_ID, udids, authIds, TEST_BATCH_ADD_NUM,
+        isNewEntries), HC_SUCCESS);
+    EXPECT_FALSE(isNewEntries[0]);
+    EXPECT_FALSE(isNewEntries[1]);
+    EXPECT_TRUE(isNewEntries[2]);
+    ASSERT_EQ(g_testEventNum, 2u);
+    EXPECT_STREQ(g_testEvents[0], "Bound:TestBatchUdid1");
+    EXPECT_STREQ(g_testEvents[1], "Bound:TestBatchUdid2");
+    /* The replaced device keeps its place, the new one is appended. */
+    const char *expectAuthIds[] = { g_testBatchAuthIds[0], "TestBatchNewAuthId1", g_testBatchAuthIds[2] };
+    DeviceEntryVec entries = CreateDeviceEntryVec();
+    QueryDeviceParams params = InitQueryDeviceParams();
+    params.groupId = TEST_BATCH_GROUP_ID;
+    EXPECT_EQ(QueryDevices(TEST_BATCH_OS_ACCOUNT_ID, &params, &entries), HC_SUCCESS);
+    ASSERT_EQ(HC_VECTOR_SIZE(&entries), (uint32_t)TEST_BATCH_ADD_NUM);
+    for (uint32_t i = 0; i < TEST_BATCH_ADD_NUM; i++) {
+        EXPECT_STREQ(StringGet(&HC_VECTOR_GET(&entries, i)->authId), expectAuthIds[i]);
+    }
+    ClearDeviceEntryVec(&entries);
+}
+
+#define TEST_DROP_OS_ACCOUNT_ID 1003
+#define TEST_DROP_PATH_LEN 256
+#define TEST_DROP_USER_ID "TestDropUserId"
+#define TEST_DROP_DEVICE_ID "TestDropDeviceId"
+#define TEST_DROP_SYM_TOKENS \
+    "{\"symTokens\":[{\"userId\":\"" TEST_DROP_USER_ID "\",\"deviceId\":\"" TEST_DROP_DEVICE_ID "\"}]}"
+
+class OsAccountDropTest : public testing::Test {
+public:
+    static void SetUpTestCase();
+    static void TearDownTestCase();
+    void SetUp();
+    void TearDown();
+};
+
+void OsAccountDropTest::SetUpTestCase() {}
+void OsAccountDropTest::TearDownTestCase() {}
+
+void OsAccountDropTest::SetUp()
+{
+    int ret = InitDeviceAuthService();
+    EXPECT_EQ(ret, HC_SUCCESS);
+    DataChangeListener listener;
+    (void)memset_s(&listener, sizeof(listener), 0, sizeof(listener));
+    listener.onDeviceBound = OnTestDeviceBound;
+    listener.onDeviceUnBound = OnTestDeviceUnBound;
+    listener.onDeviceNotTrusted = OnTestDeviceNotTrusted;
+    ret = GetGmInstance()->regDataChangeListener(TEST_APP_ID, &listener);
+    EXPECT_EQ(ret, HC_SUCCESS);
+    ResetTestBroadcastRecord();
+}
+
+void OsAccountDropTest::TearDown()
+{
+    DropOsAccountDb(TEST_DROP_OS_ACCOUNT_ID);
+    DropOsAccountCredentials(TEST_DROP_OS_ACCOUNT_ID);
+    DestroyDeviceAuthService();
+}
+
+static bool GetTestDropFilePath(const char *dir, const char *prefix, char *path)
+{
+    return (dir != nullptr) &&
+        (sprintf_s(path, TEST_DROP_PATH_LEN, "%s/%s%d.dat", dir, prefix, TEST_DROP_OS_ACCOUNT_ID) > 0);
+}
+
+static bool IsTestFileExist(const char *path)
+{
+    FileHandle file;
+    if (HcFileOpen(path, MODE_FILE_READ, &file) != 0) {
+        return false;
+    }
+    HcFileClose(file);
+    return true;
+}
+
+static int32_t WriteTestFile(const char *path, const char *data)
+{
+    FileHandle file;
+    if (HcFileOpen(path, MODE_FILE_WRITE, &file) != 0) {
+        return HC_ERR_FILE;
+    }
+    int32_t size = (int32_t)(strlen(data) + 1);
+    int32_t res = (HcFileWrite(file, data, size) == size) ? HC_SUCCESS : HC_ERR_FILE;
+    HcFileClose(file);
+    return res;
+}
+
+static int32_t DeleteTestSymToken(int32_t osAccountId)
+{
+    CJson *in = CreateJson();
+    if (in == nullptr) {
+        return HC_ERR_ALLOC_MEMORY;
+    }
+    int32_t res = HC_ERR_JSON_ADD;
+    if ((AddIntToJson(in, FIELD_CREDENTIAL_TYPE, SYMMETRIC_CRED) == HC_SUCCESS) &&
+        (AddStringToJson(in, FIELD_USER_ID, TEST_DROP_USER_ID) == HC_SUCCESS) &&
+        (AddStringToJson(in, FIELD_DEVICE_ID, TEST_DROP_DEVICE_ID) == HC_SUCCESS)) {
+        res = ProcessAccountCredentials(osAccountId, DELETE_TRUSTED_CREDENTIALS, in, nullptr);
+    }
+    FreeJson(in);
+    return res;
+}
+
+HWTEST_F(OsAccountDropTest, OsAccountDropTest001, TestSize.Level0)
+{
+    char groupPath[TEST_DROP_PATH_LEN] = { 0 };
+    char tokenPath[TEST_DROP_PATH_LEN] = { 0 };
+    ASSERT_TRUE(GetTestDropFilePath(GetStorageDirPath(), "hcgroup", groupPath));
+    ASSERT_TRUE(GetTestDropFilePath(GetAccountStoragePath(), "account_data_sym", tokenPath));
+    EXPECT_EQ(AddTestGroup(TEST_DROP_OS_ACCOUNT_ID, TEST_BATCH_GROUP_ID, TEST_APP_ID, GROUP_VISIBILITY_PRIVATE),
+        HC_SUCCESS);
+    EXPECT_EQ(AddTestDevices(TEST_DROP_OS_ACCOUNT_ID, TEST_BATCH_GROUP_ID, g_testBatchUdids, g_testBatchAuthIds,
+        TEST_BATCH_DEVICE_NUM, nullptr), HC_SUCCESS);
+    EXPECT_EQ(SaveOsAccountDb(TEST_DROP_OS_ACCOUNT_ID), HC_SUCCESS);
+    EXPECT_EQ(WriteTestFile(tokenPath, TEST_DROP_SYM_TOKENS), HC_SUCCESS);
+
+    /* Reloaded from the files, so that the tokens are cached as well. */
+    DestroyDeviceAuthService();
+    EXPECT_EQ(InitDeviceAuthService(), HC_SUCCESS);
+    EXPECT_EQ(CountTestDevices(TEST_DROP_OS_ACCOUNT_ID, TEST_BATCH_GROUP_ID), (uint32_t)TEST_BATCH_DEVICE_NUM);
+    ResetTestBroadcastRecord();
+    uint64_t generation = GetDbGeneration();
+    DropOsAccountDb(TEST_DROP_OS_ACCOUNT_ID);
+    DropOsAccountCredentials(TEST_DROP_OS_ACCOUNT_ID);
+    EXPECT_NE(GetDbGeneration(), generation);
+    EXPECT_EQ(g_testEventNum, 0u);
+    EXPECT_FALSE(IsTestFileExist(groupPath));
+    EXPECT_FALSE(IsTestFileExist(tokenPath));
+
+    QueryGroupParams groupParams = InitQueryGroupParams();
+    EXPECT_FALSE(ExistsGroup(TEST_DROP_OS_ACCOUNT_ID, &groupParams));
+    QueryDeviceParams deviceParams = InitQueryDeviceParams();
+    EXPECT_EQ(CountDevices(TEST_DROP_OS_ACCOUNT_ID, &deviceParams), 0u);
+    GroupEntryVec groups = CreateGroupEntryVec();
+    EXPECT_EQ(QueryGroups(TEST_DROP_OS_ACCOUNT_ID, &groupParams, &groups), HC_SUCCESS);
+    EXPECT_EQ(HC_VECTOR_SIZE(&groups), 0u);
+    ClearGroupEntryVec(&groups);
+    if (IsAccountSupported()) {
+        /* The token is no longer cached, otherwise it would be found and deleted. */
+        EXPECT_EQ(DeleteTestSymToken(TEST_DROP_OS_ACCOUNT_ID), HC_ERR_NULL_PTR);
+    }
+}
+
+#define TEST_ARENA_CAPACITY 64
+#define TEST_ARENA_PARAM_LEN 13
+#define TEST_ARENA_ALIGNED_LEN 16
+#define TEST_ARENA_PARAM_NUM 4
+
+class ParamArenaTest : public testing::Test {
+public:
+    static void SetUpTestCase();
+    static void TearDownTestCase();
+    void SetUp();
+    void TearDown();
+};
+
+void ParamArenaTest::SetUpTestCase() {}
+void ParamArenaTest::TearDownTestCase() {}
+void ParamArenaTest::SetUp() {}
+void ParamArenaTest::TearDown() {}
+
+static bool IsAllZero(const uint8_t *val, uint32_t len)
+{
+    for (uint32_t i = 0; i < len; i++) {
+        if (val[i] != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+HWTEST_F(ParamArenaTest, ParamArenaTest001, TestSize.Level0)
+{
+    ParamArena arena;
+    Uint8Buff params[TEST_ARENA_PARAM_NUM];
+    EXPECT_EQ(InitParamArena(&arena, TEST_ARENA_CAPACITY), HC_SUCCESS);
+    for (uint32_t i = 0; i < TEST_ARENA_PARAM_NUM; i++) {
+        EXPECT_EQ(InitArenaParam(&arena, &params[i], TEST_ARENA_PARAM_LEN), HC_SUCCESS);
+        EXPECT_EQ(params[i].length, (uint32_t)TEST_ARENA_PARAM_LEN);
+        /* The slices are zeroed, aligned and do not overlap. */
+        EXPECT_TRUE(IsAllZero(params[i].val, params[i].length));
+        EXPECT_EQ(params[i].val, arena.data + i * TEST_ARENA_ALIGNED_LEN);
+        (void)memset_s(params[i].val, params[i].length, i + 1, params[i].length);
+    }
+    Uint8Buff exhausted = { nullptr, 0 };
+    EXPECT_EQ(InitArenaParam(&arena, &exhausted, 1), HC_ERR_ALLOC_MEMORY);
+    EXPECT_EQ(exhausted.val, nullptr);
+    DestroyParamArena(&arena);
+    EXPECT_EQ(arena.data, nullptr);
+    EXPECT_EQ(arena.capacity, 0u);
+    EXPECT_EQ(arena.usedLen, 0u);
+    /* A destroyed arena hands out nothing and may be destroyed again. */
+    EXPECT_EQ(InitArenaParam(&arena, &exhausted, 1), HC_ERR_NULL_PTR);
+    DestroyParamArena(&arena);
+
+    /* The same arena serves the next handshake from the start again. */
+    EXPECT_EQ(InitParamArena(&arena, TEST_ARENA_CAPACITY), HC_SUCCESS);
+    EXPECT_EQ(InitArenaParam(&arena, &params[0], TEST_ARENA_CAPACITY), HC_SUCCESS);
+    EXPECT_EQ(params[0].val, arena.data);
+    EXPECT_TRUE(IsAllZero(params[0].val, params[0].length));
+    DestroyParamArena(&arena);
+}
+
+static bool IsInArena(const ParamArena *arena, const Uint8Buff *param)
+{
+    return (param->val >= arena->data) && (param->val + param->length <= arena->data + arena->usedLen);
+}
+
+HWTEST_F(ParamArenaTest, ParamArenaTest002, TestSize.Level0)
+{
+    ParamArena arena;
+    Uint8Buff key = { nullptr, 0 };
+    Uint8Buff next = { nullptr, 0 };
+    EXPECT_EQ(InitParamArena(&arena, TEST_ARENA_CAPACITY), HC_SUCCESS);
+    EXPECT_EQ(InitArenaParam(&arena, &key, TEST_ARENA_PARAM_LEN), HC_SUCCESS);
+    EXPECT_EQ(InitArenaParam(&arena, &next, TEST_ARENA_PARAM_LEN), HC_SUCCESS);
+    uint8_t *keyVal = key.val;
+    (void)memset_s(key.val, key.length, 1, key.length);
+    (void)memset_s(next.val, next.length, 1, next.length);
+    /* A key used up early is wiped in place, the slices around it are left alone. */
+    CleanArenaParam(&key);
+    EXPECT_EQ(key.val, nullptr);
+    EXPECT_EQ(key.length, 0u);
+    EXPECT_TRUE(IsAllZero(keyVal, TEST_ARENA_PARAM_LEN));
+    EXPECT_FALSE(IsAllZero(next.val, next.length));
+    CleanArenaParam(&key);
+    CleanArenaParam(nullptr);
+    DestroyParamArena(&arena);
+}
+
+HWTEST_F(ParamArenaTest, ParamArenaTest003, TestSize.Level0)
+{
+    PakeBaseParams pakeParams;
+    (void)memset_s(&pakeParams, sizeof(pakeParams), 0, sizeof(pakeParams));
+    EXPECT_EQ(InitPakeV1BaseParams(&pakeParams), HC_SUCCESS);
+    EXPECT_TRUE(IsInArena(&pakeParams.arena, &pakeParams.salt));
+    EXPECT_TRUE(IsInArena(&pakeParams.arena, &pakeParams.sessionKey));
+    EXPECT_TRUE(IsInArena(&pakeParams.arena, &pakeParams.hmacKey));
+    EXPECT_TRUE(IsInArena(&pakeParams.arena, &pakeParams.kcfDataPeer));
+    /* The largest dl group still finds room for its keys and the shared secret. */
+    pakeParams.innerKeyLen = PAKE_DL_PRIME_LEN;
+    Uint8Buff keys[] = { pakeParams.eskSelf, pakeParams.epkSelf, pakeParams.base, pakeParams.sharedSecret };
+    uint32_t keyLens[] = { PAKE_DL_ESK_LEN, PAKE_DL_PRIME_LEN, PAKE_DL_PRIME_LEN, PAKE_DL_PRIME_LEN };
+    for (uint32_t i = 0; i < sizeof(keyLens) / sizeof(keyLens[0]); i++) {
+        EXPECT_EQ(InitArenaParam(&pakeParams.arena, &keys[i], keyLens[i]), HC_SUCCESS);
+    }
+    CleanArenaParam(&pakeParams.sessionKey);
+    DestroyPakeV1BaseParams(&pakeParams);
+    EXPECT_EQ(pakeParams.arena.data, nullptr);
+
+    (void)memset_s(&pakeParams, sizeof(pakeParams), 0, sizeof(pakeParams));
+    EXPECT_EQ(InitPakeV2BaseParams(&pakeParams), HC_SUCCESS);
+    EXPECT_TRUE(IsInArena(&pakeParams.arena, &pakeParams.sharedSecret));
+    EXPECT_TRUE(IsInArena(&pakeParams.arena, &pakeParams.sessionKey));
+    DestroyPakeV2BaseParams(&pakeParams);
+    EXPECT_EQ(pakeParams.arena.data, nullptr);
+
+    IsoBaseParams isoParams;
+    (void)memset_s(&isoParams, sizeof(isoParams), 0, sizeof(isoParams));
+    EXPECT_EQ(InitIsoBaseParams(&isoParams), HC_SUCCESS);
+    EXPECT_TRUE(IsInArena(&isoParams.arena, &isoParams.randSelf));
+    EXPECT_TRUE(IsInArena(&isoParams.arena, &isoParams.sessionKey));
+    CleanArenaParam(&isoParams.sessionKey);
+    DestroyIsoBaseParams(&isoParams);
+    EXPECT_EQ(isoParams.arena.data, nullptr);
+}
+
+#define TEST_KEY_ALIAS_PKG_NAME "TestKeyAliasPkg"
+#define TEST_KEY_ALIAS_SERVICE_TYPE "TestKeyAliasService"
+#define TEST_KEY_ALIAS_AUTH_ID "TestKeyAliasAuthId"
+
+class KeyAliasCacheTest : public testing::Test {
+public:
+    static void SetUpTestCase();
+    static void TearDownTestCase();
+    void SetUp();
+    void TearDown();
+};
+
+void KeyAliasCacheTest::SetUpTestCase()
+{
+    (void)GetLoaderInstance()->initAlg();
+}
+void KeyAliasCacheTest::TearDownTestCase() {}
+void KeyAliasCacheTest::SetUp() {}
+void KeyAliasCacheTest::TearDown()
+{
+    ClearKeyAliasCache();
+}
+
+HWTEST_F(KeyAliasCacheTest, KeyAliasCacheTest001, TestSize.Level0)
+{
+    Uint8Buff pkgName = { (uint8_t *)TEST_KEY_ALIAS_PKG_NAME, (uint32_t)strlen(TEST_KEY_ALIAS_PKG_NAME) };
+    Uint8Buff serviceType = { (uint8_t *)TEST_KEY_ALIAS_SERVICE_TYPE, (uint32_t)strlen(TEST_KEY_ALIAS_SERVICE_TYPE) };
+    Uint8Buff authId = { (uint8_t *)TEST_KEY_ALIAS_AUTH_ID, (uint32_t)strlen(TEST_KEY_ALIAS_AUTH_ID) };
+    uint8_t computedVal[SHA256_LEN] = { 0 };
+    uint8_t cachedVal[SHA256_LEN] = { 0 };
+    uint8_t recomputedVal[SHA256_LEN] = { 0 };
+    Uint8Buff computed = { computedVal, SHA256_LEN };
+    Uint8Buff cached = { cachedVal, SHA256_LEN };
+    Uint8Buff recomputed = { recomputedVal, SHA256_LEN };
+    EXPECT_EQ(GenerateKeyAlias(&pkgName, &serviceType, KEY_ALIAS_AUTH_TOKEN, &authId, &computed), HC_SUCCESS);
+    EXPECT_EQ(GenerateKeyAlias(&pkgName, &serviceType, KEY_ALIAS_AUTH_TOKEN, &authId, &cached), HC_SUCCESS);
+    EXPECT_EQ(memcmp(computedVal, cachedVal, SHA256_LEN), 0);
+    /* A cleared cache releases its copies of the inputs and computes the same alias again. */
+    ClearKeyAliasCache();
+    EXPECT_EQ(GenerateKeyAlias(&pkgName, &serviceType, KEY_ALIAS_AUTH_TOKEN, &authId, &recomputed), HC_SUCCESS);
+    EXPECT_EQ(memcmp(computedVal, recomputedVal, SHA256_LEN), 0);
+    ClearKeyAliasCache();
+    ClearKeyAliasCache();
+}
+
+#define TEST_MEM_SMALL_SIZE 100
+#define TEST_MEM_LARGE_SIZE 1000
+
+class MemStatTest : public testing::Test {
+public:
+    static void SetUpTestCase();
+    static void TearDownTestCase();
+    void SetUp();
+    void TearDown();
+};
+
+void MemStatTest::SetUpTestCase() {}
+void MemStatTest::TearDownTestCase() {}
+void MemStatTest::SetUp() {}
+void MemStatTest::TearDown() {}
+
+HWTEST_F(MemStatTest, MemStatTest001, TestSize.Level0)
+{
+    HcMemStat before;
+    EXPECT_EQ(HcGetMemStat(HC_MEM_MODULE_NUM, &before), HAL_ERR_INVALID_PARAM);
+    EXPECT_EQ(HcGetMemStat(HC_MEM_MODULE_GROUP_AUTH, nullptr), HAL_ERR_INVALID_PARAM);
+    EXPECT_EQ(HcMallocNoZero(0), nullptr);
+    HcMemModule prevModule = HcSetMemModule(HC_MEM_MODULE_GROUP_AUTH);
+    int32_t res = HcGetMemStat(HC_MEM_MODULE_GROUP_AUTH, &before);
+    uint8_t *noZero = (uint8_t *)HcMallocNoZero(TEST_MEM_SMALL_SIZE);
+    uint8_t *zeroed = (uint8_t *)HcMalloc(TEST_MEM_LARGE_SIZE, 0);
+    ASSERT_NE(noZero, nullptr);
+    ASSERT_NE(zeroed, nullptr);
+    for (uint32_t i = 0; i < TEST_MEM_LARGE_SIZE; i++) {
+        EXPECT_EQ(zeroed[i], 0);
+    }
+    HcMemStat during;
+    EXPECT_EQ(HcGetMemStat(HC_MEM_MODULE_GROUP_AUTH, &during), res);
+    HcFree(noZero);
+    HcFree(zeroed);
+    HcMemStat after;
+    EXPECT_EQ(HcGetMemStat(HC_MEM_MODULE_GROUP_AUTH, &after), res);
+    (void)HcSetMemModule(prevModule);
+    if (res == HAL_ERR_NOT_SUPPORTED) {
+        /* Built without HC_MEM_STAT, nothing is counted. */
+        EXPECT_EQ(during.allocCount, 0u);
+        EXPECT_EQ(during.liveCount, 0u);
+        return;
+    }
+    EXPECT_EQ(res, HAL_SUCCESS);
+    EXPECT_EQ(during.allocCount, before.allocCount + 2);
+    EXPECT_EQ(during.liveCount, before.liveCount + 2);
+    EXPECT_EQ(during.curBytes, before.curBytes + TEST_MEM_SMALL_SIZE + TEST_MEM_LARGE_SIZE);
+    EXPECT_GE(during.peakBytes, during.curBytes);
+    EXPECT_EQ(after.allocCount, during.allocCount);
+    EXPECT_EQ(after.liveCount, before.liveCount);
+    EXPECT_EQ(after.curBytes, before.curBytes);
+    EXPECT_EQ(after.peakBytes, during.peakBytes);
+}
+
+#define TEST_VECTOR_RESERVE_NUM 100
+
+DECLARE_HC_VECTOR(TestIntVec, int32_t)
+IMPLEMENT_HC_VECTOR(TestIntVec, int32_t, 1)
+
+class HcVectorTest : public testing::Test {
+public:
+    static void SetUpTestCase();
+    static void TearDownTestCase();
+    void SetUp();
+    void TearDown();
+};
+
+void HcVectorTest::SetUpTestCase() {}
+void HcVectorTest::TearDownTestCase() {}
+void HcVectorTest::SetUp() {}
+void HcVectorTest::TearDown() {}
+
+HWTEST_F(HcVectorTest, HcVectorTest001, TestSize.Level0)
+{
+    TestIntVec vec = CREATE_HC_VECTOR(TestIntVec);
+    EXPECT_TRUE(HC_VECTOR_RESERVE(&vec, TEST_VECTOR_RESERVE_NUM));
+    const char *data = GetParcelData(&vec.parcel);
+    for (int32_t i = 0; i < TEST_VECTOR_RESERVE_NUM; i++) {
+        EXPECT_NE(vec.pushBackT(&vec, i), nullptr);
+    }
+    /* The reserved capacity is used, the pushes did not reallocate. */
+    EXPECT_EQ(GetParcelData(&vec.parcel), data);
+    /* A smaller reservation never shrinks. */
+    EXPECT_TRUE(HC_VECTOR_RESERVE(&vec, 1));
+    EXPECT_EQ(GetParcelData(&vec.parcel), data);
+    EXPECT_TRUE(HC_VECTOR_SHRINK_TO_FIT(&vec));
+    EXPECT_EQ(vec.parcel.length, TEST_VECTOR_RESERVE_NUM * sizeof(int32_t));
+    for (int32_t i = 0; i < TEST_VECTOR_RESERVE_NUM; i++) {
+        EXPECT_EQ(HC_VECTOR_GET(&vec, i), i);
+    }
+    DESTROY_HC_VECTOR(TestIntVec, &vec);
+}
+
+HWTEST_F(HcVectorTest, HcVectorTest002, TestSize.Level0)
+{
+    TestIntVec vec = CREATE_HC_VECTOR(TestIntVec);
+    uint32_t maxNum = CLIB_MAX_MALLOC_SIZE / sizeof(int32_t);
+    for (int32_t i = 0; i < TEST_VECTOR_RESERVE_NUM; i++) {
+        EXPECT_NE(vec.pushBackT(&vec, i), nullptr);
+    }
+    /* Over the ClibMalloc limit the reservation fails and leaves the content as it was. */
+    EXPECT_FALSE(HC_VECTOR_RESERVE(&vec, maxNum + 1));
+    EXPECT_FALSE(HC_VECTOR_RESERVE(&vec, UINT32_MAX));
+    EXPECT_EQ(HC_VECTOR_SIZE(&vec), (uint32_t)TEST_VECTOR_RESERVE_NUM);
+    for (int32_t i = 0; i < TEST_VECTOR_RESERVE_NUM; i++) {
+        EXPECT_EQ(HC_VECTOR_GET(&vec, i), i);
+    }
+    EXPECT_TRUE(HC_VECTOR_RESERVE(&vec, maxNum));
+    for (uint32_t i = TEST_VECTOR_RESERVE_NUM; i < maxNum; i++) {
+        EXPECT_NE(vec.pushBackT(&vec, (int32_t)i), nullptr);
+    }
+    EXPECT_EQ(vec.pushBackT(&vec, 0), nullptr);
+    EXPECT_EQ(HC_VECTOR_SIZE(&vec), maxNum);
+    DESTROY_HC_VECTOR(TestIntVec, &vec);
+}
+
+#define TEST_DEQUE_INIT_NUM 4
+#define TEST_DEQUE_GROW_NUM 100
+
+DECLARE_HC_DEQUE(TestIntDeque, int32_t)
+IMPLEMENT_HC_DEQUE(TestIntDeque, int32_t, TEST_DEQUE_INIT_NUM)
+
+class HcDequeTest : public testing::Test {
+public:
+    static void SetUpTestCase();
+    static void TearDownTestCase();
+    void SetUp();
+    void TearDown();
+};
+
+void HcDequeTest::SetUpTestCase() {}
+void HcDequeTest::TearDownTestCase() {}
+void HcDequeTest::SetUp() {}
+void HcDequeTest::TearDown() {}
+
+HWTEST_F(HcDequeTest, HcDequeTest001, TestSize.Level0)
+{
+    TestIntDeque deque = CREATE_HC_DEQUE(TestIntDeque);
+    int32_t value = -1;
+    EXPECT_EQ(HC_DEQUE_POPFRONT(&deque, &value), HC_FALSE);
+    EXPECT_EQ(HC_DEQUE_POPBACK(&deque, &value), HC_FALSE);
+    EXPECT_EQ(value, -1);
+    EXPECT_EQ(HC_DEQUE_SIZE(&deque), 0u);
+    EXPECT_EQ(HC_DEQUE_GETP(&deque, 0), nullptr);
+    int32_t pushed = 1;
+    EXPECT_NE(HC_DEQUE_PUSHBACK(&deque, &pushed), nullptr);
+    EXPECT_EQ(HC_DEQUE_POPBACK(&deque, &value), HC_TRUE);
+    EXPECT_EQ(value, pushed);
+    /* Drained again, popping from the empty deque still fails. */
+    EXPECT_EQ(HC_DEQUE_POPFRONT(&deque, &value), HC_FALSE);
+    EXPECT_EQ(HC_DEQUE_SIZE(&deque), 0u);
+    DESTROY_HC_DEQUE(TestIntDeque, &deque);
+}
+
+HWTEST_F(HcDequeTest, HcDequeTest002, TestSize.Level0)
+{
+    TestIntDeque deque = CREATE_HC_DEQUE(TestIntDeque);
+    int32_t value = 0;
+    /* Move the head to the end of the buffer so that the next pushes wrap around. */
+    for (int32_t i = 0; i < TEST_DEQUE_INIT_NUM - 1; i++) {
+        EXPECT_NE(HC_DEQUE_PUSHBACK(&deque, &i), nullptr);
+        EXPECT_EQ(HC_DEQUE_POPFRONT(&deque, &value), HC_TRUE);
+        EXPECT_EQ(value, i);
+    }
+    for (int32_t i = 0; i < TEST_DEQUE_INIT_NUM; i++) {
+        EXPECT_NE(HC_DEQUE_PUSHBACK(&deque, &i), nullptr);
+    }
+    EXPECT_EQ(deque.capacity, (uint32_t)TEST_DEQUE_INIT_NUM);
+    EXPECT_EQ(deque.head, (uint32_t)(TEST_DEQUE_INIT_NUM - 1));
+    for (int32_t i = 0; i < TEST_DEQUE_INIT_NUM; i++) {
+        EXPECT_EQ(*HC_DEQUE_GETP(&deque, i), i);
+    }
+    /* Pushing at the front of a full, wrapped deque grows it and keeps the order. */
+    int32_t front = -1;
+    EXPECT_NE(HC_DEQUE_PUSHFRONT(&deque, &front), nullptr);
+    EXPECT_EQ(deque.capacity, (uint32_t)(TEST_DEQUE_INIT_NUM * 2));
+    EXPECT_EQ(HC_DEQUE_SIZE(&deque), (uint32_t)(TEST_DEQUE_INIT_NUM + 1));
+    for (int32_t i = -1; i < TEST_DEQUE_INIT_NUM; i++) {
+        EXPECT_EQ(HC_DEQUE_POPFRONT(&deque, &value), HC_TRUE);
+        EXPECT_EQ(value, i);
+    }
+    EXPECT_EQ(HC_DEQUE_POPFRONT(&deque, &value), HC_FALSE);
+    DESTROY_HC_DEQUE(TestIntDeque, &deque);
+}
+
+HWTEST_F(HcDequeTest, HcDequeTest003, TestSize.Level0)
+{
+    TestIntDeque deque = CREATE_HC_DEQUE(TestIntDeque);
+    int32_t value = 0;
+    for (int32_t i = 0; i < TEST_DEQUE_GROW_NUM; i++) {
+        int32_t negative = -i - 1;
+        EXPECT_NE(HC_DEQUE_PUSHBACK(&deque, &i), nullptr);
+        EXPECT_NE(HC_DEQUE_PUSHFRONT(&deque, &negative), nullptr);
+    }
+    EXPECT_EQ(HC_DEQUE_SIZE(&deque), (uint32_t)(TEST_DEQUE_GROW_NUM * 2));
+    EXPECT_GE(deque.capacity, HC_DEQUE_SIZE(&deque));
+    uint32_t index;
+    int32_t *iter = nullptr;
+    FOR_EACH_HC_DEQUE(deque, index, iter) {
+        EXPECT_EQ(*iter, (int32_t)index - TEST_DEQUE_GROW_NUM);
+    }
+    for (int32_t i = TEST_DEQUE_GROW_NUM - 1; i >= 0; i--) {
+        EXPECT_EQ(HC_DEQUE_POPBACK(&deque, &value), HC_TRUE);
+        EXPECT_EQ(value, i);
+    }
+    for (int32_t i = -TEST_DEQUE_GROW_NUM; i < 0; i++) {
+        EXPECT_EQ(HC_DEQUE_POPFRONT(&deque, &value), HC_TRUE);
+        EXPECT_EQ(value, i);
+    }
+    EXPECT_EQ(HC_DEQUE_POPBACK(&deque, &value), HC_FALSE);
+    /* A cleared deque keeps its buffer and can be reused. */
+    EXPECT_NE(HC_DEQUE_PUSHBACK(&deque, &value), nullptr);
+    deque.clear(&deque);
+    EXPECT_EQ(HC_DEQUE_SIZE(&deque), 0u);
+    EXPECT_NE(deque.data, nullptr);
+    DESTROY_HC_DEQUE(TestIntDeque, &deque);
+}
+
+#define TEST_EPHEMERAL_TAKE_NUM 64
+
+class EphemeralPoolTest : public testing::Test {
+public:
+    static void SetUpTestCase();
+    static void TearDownTestCase();
+    void SetUp();
+    void TearDown();
+};
+
+void EphemeralPoolTest::SetUpTestCase() {}
+void EphemeralPoolTest::TearDownTestCase() {}
+
+void EphemeralPoolTest::SetUp()
+{
+    EXPECT_EQ(InitEphemeralPool(), HC_SUCCESS);
+}
+
+void EphemeralPoolTest::TearDown()
+{
+    DestroyEphemeralPool();
+}
+
+HWTEST_F(EphemeralPoolTest, EphemeralPoolTest001, TestSize.Level0)
+{
+    uint8_t val[EPHEMERAL_BLOCK_LEN + 1] = { 0 };
+    Uint8Buff out = { val, 0 };
+    EXPECT_EQ(TakeEphemeralRandom(nullptr), HC_ERR_INVALID_PARAMS);
+    EXPECT_EQ(TakeEphemeralRandom(&out), HC_ERR_INVALID_PARAMS);
+    out.length = EPHEMERAL_BLOCK_LEN + 1;
+    EXPECT_EQ(TakeEphemeralRandom(&out), HC_ERR_INVALID_PARAMS);
+    out.val = nullptr;
+    out.length = EPHEMERAL_BLOCK_LEN;
+    EXPECT_EQ(TakeEphemeralRandom(&out), HC_ERR_INVALID_PARAMS);
+}
+
+HWTEST_F(EphemeralPoolTest, EphemeralPoolTest002, TestSize.Level0)
+{
+    /* Taking more than the pool holds goes through refills or inline draws, no block is handed out twice. */
+    static uint8_t vals[TEST_EPHEMERAL_TAKE_NUM][EPHEMERAL_BLOCK_LEN];
+    uint8_t zeroVal[EPHEMERAL_BLOCK_LEN] = { 0 };
+    (void)memset_s(vals, sizeof(vals), 0, sizeof(vals));
+    for (uint32_t i = 0; i < TEST_EPHEMERAL_TAKE_NUM; i++) {
+        Uint8Buff out = { vals[i], EPHEMERAL_BLOCK_LEN };
+        EXPECT_EQ(TakeEphemeralRandom(&out), HC_SUCCESS);
+        EXPECT_NE(memcmp(vals[i], zeroVal, EPHEMERAL_BLOCK_LEN), 0);
+        for (uint32_t j = 0; j < i; j++) {
+            EXPECT_NE(memcmp(vals[i], vals[j], EPHEMERAL_BLOCK_LEN), 0);
+        }
+    }
+    /* A shorter request takes a whole block as well. */
+    uint8_t shortVal[EPHEMERAL_BLOCK_LEN / 2] = { 0 };
+    Uint8Buff shortOut = { shortVal, sizeof(shortVal) };
+    EXPECT_EQ(TakeEphemeralRandom(&shortOut), HC_SUCCESS);
+    for (uint32_t i = 0; i < TEST_EPHEMERAL_TAKE_NUM; i++) {
+        EXPECT_NE(memcmp(vals[i], shortVal, sizeof(shortVal)), 0);
+    }
+}
+
+HWTEST_F(EphemeralPoolTest, EphemeralPoolTest003, TestSize.Level0)
+{
+    uint8_t first[EPHEMERAL_BLOCK_LEN] = { 0 };
+    uint8_t second[EPHEMERAL_BLOCK_LEN] = { 0 };
+    uint8_t third[EPHEMERAL_BLOCK_LEN] = { 0 };
+    Uint8Buff out = { first, sizeof(first) };
+    EXPECT_EQ(TakeEphemeralRandom(&out), HC_SUCCESS);
+    /* Without the pool the randoms are drawn inline, and the pool can be started again. */
+    DestroyEphemeralPool();
+    out.val = second;
+    EXPECT_EQ(TakeEphemeralRandom(&out), HC_SUCCESS);
+    EXPECT_NE(memcmp(first, second, EPHEMERAL_BLOCK_LEN), 0);
+    EXPECT_EQ(InitEphemeralPool(), HC_SUCCESS);
+    EXPECT_EQ(InitEphemeralPool(), HC_SUCCESS);
+    out.val = third;
+    EXPECT_EQ(TakeEphemeralRandom(&out), HC_SUCCESS);
+    EXPECT_NE(memcmp(second, third, EPHEMERAL_BLOCK_LEN), 0);
+}
+
+#define TEST_AUTH_OS_ACCOUNT_ID 1004
+#define TEST_AUTH_PEER_UDID "TestAuthPeerUdid"
+#define TEST_AUTH_GROUP_ID_A "TestAuthGroupIdA"
+#define TEST_AUTH_GROUP_ID_B "TestAuthGroupIdB"
+#define TEST_AUTH_DEVICE_NUM 2
+#define TEST_AUTH_GROUP_NUM 2
+
+static bool StubOnTransmit(int64_t requestId, const uint8_t *data, uint32_t dataLen)
+{
+    (void)requestId;
+    (void)data;
+    (void)dataLen;
+    return true;
+}
+
+class AuthGroupMemoryTest : public testing::Test {
+public:
+    static void SetUpTestCase();
+    static void TearDownTestCase();
+    void SetUp();
+    void TearDown();
+};
+
+void AuthGroupMemoryTest::SetUpTestCase() {}
+void AuthGroupMemoryTest::TearDownTestCase() {}
+
+void AuthGroupMemoryTest::SetUp()
+{
+    int ret = InitDeviceAuthService();
+    EXPECT_EQ(ret, HC_SUCCESS);
+}
+
+void AuthGroupMemoryTest::TearDown()
+{
+    (void)DelGroupCascade(TEST_AUTH_OS_ACCOUNT_ID, TEST_AUTH_GROUP_ID_A, nullptr);
+    (void)DelGroupCascade(TEST_AUTH_OS_ACCOUNT_ID, TEST_AUTH_GROUP_ID_B, nullptr);
+    DestroyDeviceAuthService();
+}
+
+/* Both groups trust the local device and the peer, so both are auth candidates. */
+static int32_t AddTestAuthGroups(void)
+{
+    char localUdid[INPUT_UDID_LEN] = { 0 };
+    int32_t res = HcGetUdid((uint8_t *)localUdid, INPUT_UDID_LEN);
+    if (res != HC_SUCCESS) {
+        return res;
+    }
+    const char *udids[TEST_AUTH_DEVICE_NUM] = { localUdid, TEST_AUTH_PEER_UDID };
+    const char *authIds[TEST_AUTH_DEVICE_NUM] = { localUdid, TEST_AUTH_PEER_UDID };
+    const char *groupIds[] = { TEST_AUTH_GROUP_ID_A, TEST_AUTH_GROUP_ID_B };
+    for (uint32_t i = 0; (i < sizeof(groupIds) / sizeof(groupIds[0])) && (res == HC_SUCCESS); i++) {
+        res = AddTestGroup(TEST_AUTH_OS_ACCOUNT_ID, groupIds[i], TEST_APP_ID, GROUP_VISIBILITY_PUBLIC);
+        if (res == HC_SUCCESS) {
+            res = AddTestDevices(TEST_AUTH_OS_ACCOUNT_ID, groupIds[i], udids, authIds, TEST_AUTH_DEVICE_NUM, nullptr);
+        }
+    }
+    return res;
+}
+
+/* The param of the caller, the candidate params carry the pkgName of their group instead. */
+static CJson *CreateTestAuthParam(void)
+{
+    CJson *param = CreateJson();
+    int64_t requestId = TEST_REQ_ID;
+    if ((param == nullptr) || (AddIntToJson(param, FIELD_OS_ACCOUNT_ID, TEST_AUTH_OS_ACCOUNT_ID) != HC_SUCCESS) ||
+        (AddStringToJson(param, FIELD_SERVICE_PKG_NAME, TEST_APP_ID) != HC_SUCCESS) ||
+        (AddStringToJson(param, FIELD_PEER_CONN_DEVICE_ID, TEST_AUTH_PEER_UDID) != HC_SUCCESS) ||
+        (AddBoolToJson(param, FIELD_IS_CLIENT, true) != HC_SUCCESS) ||
+        (AddBoolToJson(param, FIELD_IS_DEVICE_LEVEL, false) != HC_SUCCESS) ||
+        (AddByteToJson(param, FIELD_REQUEST_ID, (const uint8_t *)&requestId, sizeof(int64_t)) != HC_SUCCESS)) {
+        FreeJson(param);
+        return nullptr;
+    }
+    return param;
+}
+
+static void DestroyTestAuthSession(AuthSession *session)
+{
+    uint32_t index;
+    void **paramsData = nullptr;
+    FOR_EACH_HC_VECTOR(session->paramsList, index, paramsData) {
+        FreeJson((CJson *)*paramsData);
+    }
+    DestroyAuthParamsVec(&session->paramsList);
+}
+
+/* The session takes the candidate list the client would start with. */
+static int32_t InitTestAuthSession(AuthSession *session, const CJson *param, const DeviceAuthCallback *callback)
+{
+    (void)memset_s(session, sizeof(AuthSession), 0, sizeof(AuthSession));
+    session->base.callback = callback;
+    CreateAuthParamsVec(&session->paramsList);
+    int32_t res = GetAuthParamsList(TEST_AUTH_OS_ACCOUNT_ID, param, &session->paramsList);
+    if (res == HC_SUCCESS) {
+        res = InitAuthSessionPeer(session, TEST_AUTH_OS_ACCOUNT_ID, param);
+    }
+    return res;
+}
+
+static const char *GetTestCandidateGroupId(const AuthSession *session, uint32_t index)
+{
+    const CJson *candidate = (const CJson *)session->paramsList.get(&session->paramsList, index);
+    return (candidate == nullptr) ? nullptr : GetStringFromJson(candidate, FIELD_GROUP_ID);
+}
+
+HWTEST_F(AuthGroupMemoryTest, AuthGroupMemoryTest001, TestSize.Level0)
+{
+    ASSERT_EQ(AddTestAuthGroups(), HC_SUCCESS);
+    DeviceAuthCallback callback;
+    (void)memset_s(&callback, sizeof(callback), 0, sizeof(callback));
+    callback.onTransmit = StubOnTransmit;
+    CJson *param = CreateTestAuthParam();
+    ASSERT_NE(param, nullptr);
+    AuthSession session;
+    ASSERT_EQ(InitTestAuthSession(&session, param, &callback), HC_SUCCESS);
+    ASSERT_EQ(session.paramsList.size(&session.paramsList), (uint32_t)TEST_AUTH_GROUP_NUM);
+    EXPECT_STREQ(GetTestCandidateGroupId(&session, 0), TEST_AUTH_GROUP_ID_A);
+    const CJson *second = (const CJson *)session.paramsList.get(&session.paramsList, 1);
+    EXPECT_STREQ(GetStringFromJson(second, FIELD_SERVICE_PKG_NAME), GROUP_MANAGER_PACKAGE_NAME);
+
+    /* The first group fails over to the second, which finishes. */
+    session.currentIndex = 1;
+    CJson *out = CreateJson();
+    EXPECT_EQ(ProcessTaskStatusForAuth(&session, (CJson *)second, out, FINISH), FINISH);
+    DestroyTestAuthSession(&session);
+
+    ASSERT_EQ(InitTestAuthSession(&session, param, &callback), HC_SUCCESS);
+    ASSERT_EQ(session.paramsList.size(&session.paramsList), (uint32_t)TEST_AUTH_GROUP_NUM);
+    EXPECT_STREQ(GetTestCandidateGroupId(&session, 0), TEST_AUTH_GROUP_ID_B);
+    EXPECT_STREQ(GetTestCandidateGroupId(&session, 1), TEST_AUTH_GROUP_ID_A);
+
+    /* A failure of the remembered group, even without any task output, forgets it. */
+    (void)InformAuthError(&session, nullptr, HC_ERR_PEER_ERROR);
+    DestroyTestAuthSession(&session);
+    ASSERT_EQ(InitTestAuthSession(&session, param, &callback), HC_SUCCESS);
+    EXPECT_STREQ(GetTestCandidateGroupId(&session, 0), TEST_AUTH_GROUP_ID_A);
+    DestroyTestAuthSession(&session);
+    FreeJson(out);
+    FreeJson(param);
+}
+
+HWTEST_F(AuthGroupMemoryTest, AuthGroupMemoryTest002, TestSize.Level0)
+{
+    ASSERT_EQ(AddTestAuthGroups(), HC_SUCCESS);
+    DeviceAuthCallback callback;
+    (void)memset_s(&callback, sizeof(callback), 0, sizeof(callback));
+    callback.onTransmit = StubOnTransmit;
+    CJson *param = CreateTestAuthParam();
+    ASSERT_NE(param, nullptr);
+    AuthSession session;
+    ASSERT_EQ(InitTestAuthSession(&session, param, &callback), HC_SUCCESS);
+    ASSERT_EQ(session.paramsList.size(&session.paramsList), (uint32_t)TEST_AUTH_GROUP_NUM);
+    /* Only the client remembers the group it authenticated with. */
+    CJson *second = (CJson *)session.paramsList.get(&session.paramsList, 1);
+    EXPECT_EQ(AddBoolToJson(second, FIELD_IS_CLIENT, false), HC_SUCCESS);
+    session.currentIndex = 1;
+    CJson *out = CreateJson();
+    EXPECT_EQ(ProcessTaskStatusForAuth(&session, second, out, FINISH), FINISH);
+    DestroyTestAuthSession(&session);
+    ASSERT_EQ(InitTestAuthSession(&session, param, &callback), HC_SUCCESS);
+    EXPECT_STREQ(GetTestCandidateGroupId(&session, 0), TEST_AUTH_GROUP_ID_A);
+    DestroyTestAuthSession(&session);
+    FreeJson(out);
+    FreeJson(param);
+}
+
+static uint32_t g_testLogArgCount = 0;
+
+/* Only evaluated when the log is formatted. */
+static const char *GetTestLogArg(void)
+{
+    g_testLogArgCount++;
+    return "TestLogArg";
+}
+
+class DevAuthLogTest : public testing::Test {
+public:
+    static void SetUpTestCase();
+    static void TearDownTestCase();
+    void SetUp();
+    void TearDown();
+};
+
+void DevAuthLogTest::SetUpTestCase() {}
+void DevAuthLogTest::TearDownTestCase() {}
+void DevAuthLogTest::SetUp()
+{
+    g_testLogArgCount = 0;
+}
+
+void DevAuthLogTest::TearDown()
+{
+    DevAuthSetLogLevel(DEV_AUTH_LOG_LEVEL_DEBUG);
+}
+
+HWTEST_F(DevAuthLogTest, DevAuthLogTest001, TestSize.Level0)
+{
+    DevAuthSetLogLevel(DEV_AUTH_LOG_LEVEL_WARN);
+    EXPECT_EQ(DevAuthGetLogLevel(), DEV_AUTH_LOG_LEVEL_WARN);
+    LOGD("Skipped: %s", GetTestLogArg());
+    LOGI("Skipped: %s", GetTestLogArg());
+    EXPECT_EQ(g_testLogArgCount, 0u);
+    LOGW("Printed: %s", GetTestLogArg());
+    LOGE("Printed: %s", GetTestLogArg());
+    EXPECT_EQ(g_testLogArgCount, 2u);
+    DevAuthSetLogLevel(DEV_AUTH_LOG_LEVEL_DEBUG);
+    LOGD("Printed: %s", GetTestLogArg());
+    EXPECT_EQ(g_testLogArgCount, 3u);
+}